@@ -40,11 +40,27 @@
 #include "absyntax.hh"
 //#include "../stage1_2/iec.hh" /* required for BOGUS_TOKEN_ID, etc... */
 #include "visitor.hh"
+#include "string_pool.hh"
+#include "arena.hh"
+#include "../util/nocase_hashtable.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
 
 
 
 
+/* The arena from which all symbols are allocated.
+ * Kept separate from the string pool's arena, so the AST memory may be measured on its own.
+ */
+static arena_c symbol_arena;
+
+#ifndef NO_AST_ARENA
+void *symbol_c::operator new(size_t size) {return symbol_arena.alloc(size);}
+#endif
+size_t symbol_c::arena_size (void) {return symbol_arena.size();}
+size_t symbol_c::arena_bytes(void) {return symbol_arena.bytes();}
+
+
+
 /* The base class of all symbols */
 symbol_c::symbol_c(
                    int first_line, int first_column, const char *ffile, long int first_order,
@@ -69,7 +85,8 @@ token_c::token_c(const char *value,
                  int fl, int fc, const char *ffile, long int forder,
                  int ll, int lc, const char *lfile, long int lorder)
   :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {
-  this->value = value;
+  /* all token values are interned, so identical values share the same memory (see string_pool.hh) */
+  this->value = intern_string(value);
   this->token = this; // every token is its own reference token.
 //  printf("New token: %s\n", value);
 }
@@ -79,12 +96,15 @@ token_c::token_c(const char *value,
 
 # define LIST_CAP_INIT 8
 # define LIST_CAP_INCR 8
+/* Lists with fewer elements are searched sequentially, without building an index */
+# define LIST_INDEX_MIN 8
 
 list_c::list_c(
                int fl, int fc, const char *ffile, long int forder,
                int ll, int lc, const char *lfile, long int lorder)
   :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder),c(LIST_CAP_INIT) {
   n = 0;
+  index = NULL;
   elements = (element_entry_t*)malloc(LIST_CAP_INIT*sizeof(element_entry_t));
   if (NULL == elements) ERROR_MSG("out of memory");
 }
@@ -95,6 +115,7 @@ list_c::list_c(symbol_c *elem,
                int ll, int lc, const char *lfile, long int lorder)
   :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder),c(LIST_CAP_INIT) { 
   n = 0;
+  index = NULL;
   elements = (element_entry_t*)malloc(LIST_CAP_INIT*sizeof(element_entry_t));
   if (NULL == elements) ERROR_MSG("out of memory");
   add_element(elem); 
@@ -106,6 +127,11 @@ list_c::list_c(symbol_c *elem,
 /*******************************************/    
 symbol_c *list_c::get_element(int pos) {return elements[pos].symbol;}
 
+/*************************************************************************/    
+/* get the token value associated to element in position pos of the list */
+/*************************************************************************/    
+const char *list_c::get_element_token_value(int pos) {return elements[pos].token_value;}
+
 
 
 /******************************************/    
@@ -117,17 +143,60 @@ symbol_c *list_c::find_element(symbol_c *token) {
   return find_element((const char *)t->value);  
 }
 
-symbol_c *list_c::find_element(const char *token_value) {
+static bool same_token_value(const char *value1, const char *value2) {
+  if ((NULL == value1) || (NULL == value2)) return false;
   // We could use strcasecmp(), but it's best to always use the same 
   // method of string comparison throughout matiec
+  // NOTE: nocasecmp_c is a 'less than' comparison, so equality must check both ways.
   nocasecmp_c ncc; 
+  return !ncc(value1, value2) && !ncc(value2, value1);
+}
+
+symbol_c *list_c::find_element(const char *token_value) {
+  if (NULL == token_value) return NULL;
+  if ((NULL == index) && (n >= LIST_INDEX_MIN)) build_index();
+
+  if (NULL != index) {
+    nocase_hashtable_c<symbol_c *>::iterator i = index->find(token_value);
+    return (i == index->end())? NULL : i->second;
+  }
+
   for (int i = 0; i < n; i++) 
-    if (!ncc(elements[i].token_value, token_value))
+    if (same_token_value(elements[i].token_value, token_value))
       return elements[i].symbol;
 
   return NULL; // not found
 }
 
+
+/* NOTE: The stage 3 algorithms may run on several threads (one POU per thread), and search
+ *       a list shared by several POUs (e.g. the elements of a structure data type) at the same time.
+ *       The index is therefore only published once it is complete, with an atomic compare and swap
+ *       (just like lazy_alloc()), and a thread that loses the race simply discards its copy.
+ */
+void list_c::build_index(void) {
+  nocase_hashtable_c<symbol_c *> *new_index = new nocase_hashtable_c<symbol_c *>();
+  /* insert in reverse order, so the first element with each token value is the one that remains in the index */
+  for (int i = n-1; i >= 0; i--)
+    if (NULL != elements[i].token_value)
+      (*new_index)[elements[i].token_value] = elements[i].symbol;
+  if (!__sync_bool_compare_and_swap(&index, (nocase_hashtable_c<symbol_c *> *)NULL, new_index))
+    delete new_index;
+}
+
+
+/* NOTE: An entry whose token value is no longer in the list is kept in the index with a NULL symbol,
+ *       as nocase_hashtable_c does not support removing entries.
+ */
+void list_c::update_index(const char *token_value) {
+  if ((NULL == index) || (NULL == token_value)) return;
+  symbol_c *symbol = NULL;
+  for (int i = 0; i < n; i++) 
+    if (same_token_value(elements[i].token_value, token_value))
+      {symbol = elements[i].symbol; break;}
+  (*index)[token_value] = symbol;
+}
+
     
 /***********************************************/    
 /* append a new element to the end of the list */
@@ -148,6 +217,12 @@ void list_c::add_element(symbol_c *elem, const char *token_value) {
   elements[n].token_value = token_value;
   n++;
   
+  /* the new element is the last one, so it is only indexed if no other element has the same token value */
+  if ((NULL != index) && (NULL != token_value)) {
+    symbol_c *&first = (*index)[token_value];
+    if (NULL == first) first = elem;
+  }
+
   if (NULL == elem) return;
   /* Sometimes add_element() is called in stage3 or stage4 to temporarily add an AST symbol to the list.
    * Since this symbol already belongs in some other place in the aST, it will have the 'parent' pointer set, 
@@ -203,12 +278,14 @@ void list_c::insert_element(symbol_c *elem, const char *token_value, int pos) {
   
   /* add new element to end of list. Basically alocate required memory... */
   /* will also increment n by 1 ! */
-  add_element(elem);
+  add_element(elem, token_value);
   /* if not inserting into end position, shift all elements up one position, to open up a slot in pos for new element */
   if(pos < (n-1)){ 
     for(int i=n-2 ; i>=pos ; --i) elements[i+1] = elements[i];
     elements[pos].symbol      = elem;
     elements[pos].token_value = token_value;
+    /* the new element may now precede the element with the same token value that is currently indexed */
+    update_index(token_value);
   }
 }
 
@@ -219,10 +296,12 @@ void list_c::insert_element(symbol_c *elem, const char *token_value, int pos) {
 void list_c::remove_element(int pos) {
   if((pos<0) || (n<=pos)) ERROR;
   
+  const char *token_value = elements[pos].token_value;
   /* Shift all elements down one position, starting at the entry to delete. */
   for (int i = pos; i < n-1; i++) elements[i] = elements[i+1];
   /* corrent the new size */
   n--;
+  update_index(token_value);
   /* elements = (symbol_c **)realloc(elements, n * sizeof(element_entry_t)); */
   /* TODO: adjust the location parameters, taking into account the removed element. */
 }
@@ -233,6 +312,7 @@ void list_c::remove_element(int pos) {
 /**********************************/    
 void list_c::clear(void) {
   n = 0;
+  if (NULL != index) index->clear();
   /* TODO: adjust the location parameters, taking into account the removed element. */
 }
 
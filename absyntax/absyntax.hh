@@ -52,6 +52,8 @@
 #include <string>
 #include <stdint.h>  // required for uint64_t, etc...
 #include "../main.hh" // required for uint8_t, real_64_t, ..., and the macros INT8_MAX, REAL32_MAX, ... */
+#include "string_pool.hh"
+#include "lazy_annotation.hh"
 
 
 
@@ -156,6 +158,7 @@ class const_value_c {
 
 // A forward declaration
 class token_c;
+template<typename value_type> class nocase_hashtable_c; // see util/nocase_hashtable.hh
 
 /* The base class of all symbols */
 class symbol_c {
@@ -196,7 +199,17 @@ class symbol_c {
      * Annotations produced during stage 3
      */    
     /*** Data type analysis ***/
-    std::vector <symbol_c *> candidate_datatypes; /* All possible data types the expression/literal/etc. may take. Filled in stage3 by fill_candidate_datatypes_c class */
+    /* NOTE: The stage 3 and stage 4 annotations are only allocated when first modified (see lazy_annotation.hh),
+     *       unless compiled with -DINLINE_ANNOTATIONS.
+     */
+#ifdef INLINE_ANNOTATIONS
+    typedef std::vector <symbol_c *>          candidate_datatypes_t;
+    typedef inline_annotation_c<const_value_c> const_value_t;
+#else
+    typedef lazy_vector_c <symbol_c *>        candidate_datatypes_t;
+    typedef lazy_annotation_c<const_value_c>  const_value_t;
+#endif
+    candidate_datatypes_t candidate_datatypes; /* All possible data types the expression/literal/etc. may take. Filled in stage3 by fill_candidate_datatypes_c class */
     /* Data type of the expression/literal/etc. Filled in stage3 by narrow_candidate_datatypes_c 
      * If set to NULL, it means it has not yet been evaluated.
      * If it points to an object of type invalid_type_name_c, it means it is invalid.
@@ -212,7 +225,8 @@ class symbol_c {
 
     /*** constant folding ***/
     /* If the symbol has a constant numerical value, this will be set to that value by constant_folding_c */
-    const_value_c const_value;
+    /* NOTE: access it with '->' (e.g. symbol->const_value->_int64.get()) */
+    const_value_t const_value;
     
     /*** Enumeration datatype checking ***/    
     /* Not all symbols will contain the following anotations, which is why they are not declared here in symbol_c
@@ -227,7 +241,11 @@ class symbol_c {
      * possible use would quickly get out of hand.
      * We therefore simply add a map, that each stage 4 may use for all its needs.
      */
-    typedef std::map<std::string, symbol_c *> anotations_map_t;
+#ifdef INLINE_ANNOTATIONS
+    typedef std::map  <std::string, symbol_c *> anotations_map_t;
+#else
+    typedef lazy_map_c<std::string, symbol_c *> anotations_map_t;
+#endif
     anotations_map_t anotations_map;
     
 
@@ -241,6 +259,17 @@ class symbol_c {
     /* must be virtual so compiler does not complain... */ 
     virtual ~symbol_c(void) {return;};
 
+    /* All symbols are allocated from a single arena (see arena.hh), unless compiled with -DNO_AST_ARENA.
+     * Deleting a symbol calls its destructor, but its memory is only released with the whole arena.
+     */
+#ifndef NO_AST_ARENA
+    static void *operator new   (size_t size);
+    static void  operator delete(void *ptr) {}
+#endif
+    /* Some statistics, for debugging purposes... */
+    static size_t arena_size (void);  /* total memory (in bytes) allocated for the arena */
+    static size_t arena_bytes(void);  /* total memory (in bytes) used by the symbols in the arena */
+
     virtual void *accept(visitor_c &visitor) {return NULL;};
 };
 
@@ -253,6 +282,7 @@ class token_c: public symbol_c {
     virtual const char *absyntax_cname(void) {return "token_c";};
 
     /* the value of the symbol. */
+    /* NOTE: always interned in the string pool (see string_pool.hh) by the constructor. */
     const char *value;
 
   public:
@@ -279,7 +309,14 @@ class list_c: public symbol_c {
       symbol_c   *symbol;
     } element_entry_t;
     element_entry_t *elements;
-    
+    /* Index of the elements by token value, used by find_element().
+     * Only built on the first search of a list with a minimum number of elements, and kept
+     * up to date from then on. Maps each token value to the first element with that value.
+     */
+    nocase_hashtable_c<symbol_c *> *index;
+    void build_index(void);
+    void update_index(const char *token_value); /* recompute the index entry of token_value, by searching the whole list */
+
 
   public:
     list_c(int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0, /* order in which it is read by lexcial analyser */
@@ -292,6 +329,8 @@ class list_c: public symbol_c {
           );
      /* get element in position pos of the list */
     virtual symbol_c *get_element(int pos);
+     /* get the token value associated to the element in position pos of the list */
+    virtual const char *get_element_token_value(int pos);
      /* find element associated to token value */
     virtual symbol_c *find_element(symbol_c   *token);
     virtual symbol_c *find_element(const char *token_value);
@@ -0,0 +1,88 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * A bump allocator.
+ *
+ * See arena.hh for details.
+ */
+
+
+#include <stdlib.h>  /* required for malloc() */
+#include <pthread.h>
+#include "arena.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+
+
+/* size of each block of memory of the arena */
+#define ARENA_BLOCK_SIZE  (64 * 1024)
+
+
+/* The AST may be built and annotated by several threads (see stage3.cc), so the arenas are shared among threads.
+ * A single lock for all arenas is enough, as the lock is only held for a few instructions.
+ */
+static pthread_mutex_t arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+void *arena_c::alloc(size_t size) {
+  /* keep everything aligned */
+  const size_t align = sizeof(void *) > sizeof(long long)? sizeof(void *) : sizeof(long long);
+  size = (size + align - 1) & ~(align - 1);
+
+  if (size > ARENA_BLOCK_SIZE / 4) {
+    /* large requests get their own memory */
+    void *res = malloc(size);
+    if (NULL == res) ERROR_MSG("out of memory");
+    pthread_mutex_lock(&arena_mutex);
+    used  += size;
+    total += size;
+    pthread_mutex_unlock(&arena_mutex);
+    return res;
+  }
+
+  pthread_mutex_lock(&arena_mutex);
+  used += size;
+
+  if (size > free_bytes) {
+    /* NOTE: the (small) remainder of the previous block is simply wasted. */
+    block = (char *)malloc(ARENA_BLOCK_SIZE);
+    if (NULL == block) ERROR_MSG("out of memory");
+    free_bytes = ARENA_BLOCK_SIZE;
+    total     += ARENA_BLOCK_SIZE;
+  }
+  void *res = block;
+  block      += size;
+  free_bytes -= size;
+  pthread_mutex_unlock(&arena_mutex);
+  return res;
+}
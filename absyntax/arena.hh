@@ -0,0 +1,71 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * A bump allocator.
+ *
+ * Memory is handed out sequentially from large blocks obtained with malloc().
+ * The individual allocations are never freed. This is used for data that
+ * lives (almost) as long as the compiler itself: the interned strings
+ * (see string_pool.hh) and the nodes of the abstract syntax tree
+ * (see symbol_c::operator new() in absyntax.hh).
+ *
+ * NOTE: arena_c has no constructor, so static arenas are zero (i.e. constant)
+ *       initialised, before any constructor of another static object is called.
+ *       This allows arenas to be used by the constructors of static objects.
+ */
+
+
+#ifndef _ARENA_HH
+#define _ARENA_HH
+
+#include <stddef.h>  /* required for size_t */
+
+
+class arena_c {
+  private:
+    char   *block;      /* the block currently being filled */
+    size_t  free_bytes; /* bytes still available in block */
+    size_t  total;      /* total memory obtained with malloc() */
+    size_t  used;       /* total memory handed out by alloc() */
+
+  public:
+    /* The returned memory is aligned for any pointer or integer type. */
+    void  *alloc(size_t size);
+
+    /* Some statistics, for debugging purposes... */
+    size_t size (void) {return total;}
+    size_t bytes(void) {return used;}
+};
+
+
+#endif /* _ARENA_HH */
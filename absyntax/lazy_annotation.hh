@@ -0,0 +1,191 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Lazily allocated annotations of the abstract syntax tree.
+ *
+ * Every symbol_c carries the annotations filled in by stage 3 and stage 4
+ * (candidate_datatypes, const_value, anotations_map), even though most
+ * symbols (lists, declarations, type names, ...) never get annotated.
+ * Storing them inline would make every node of the AST about 3 times larger.
+ *
+ * Each of the classes below stores a single pointer to the annotation, which is
+ * only allocated when it is first modified. Until then, reading it returns
+ * the same values as a default constructed annotation.
+ *
+ * Compile with -DINLINE_ANNOTATIONS to store the annotations inline
+ * in each symbol instead (the previous layout).
+ *
+ * NOTE: The stage 3 algorithms may run on several threads (one POU per thread), and
+ *       a symbol shared by several POUs (e.g. a data type declaration) may have its
+ *       annotation allocated by two threads at the same time. The allocation is therefore
+ *       done with an atomic compare and swap, and the loser simply discards its copy.
+ */
+
+
+#ifndef _LAZY_ANNOTATION_HH
+#define _LAZY_ANNOTATION_HH
+
+#include <stddef.h>  /* required for NULL */
+#include <vector>
+#include <map>
+
+
+
+/* Set *ptr to a new (default constructed) object, unless another thread has already done so. */
+template<typename value_t> inline value_t *lazy_alloc(value_t **ptr) {
+  value_t *new_ptr = new value_t();
+  if (!__sync_bool_compare_and_swap(ptr, (value_t *)NULL, new_ptr))
+    delete new_ptr;
+  return *ptr;
+}
+
+
+
+/* A generic annotation, accessed through operator->(), which allocates it if required. */
+template<typename value_t> class lazy_annotation_c {
+  private:
+    value_t *ptr;
+
+  public:
+    lazy_annotation_c(void): ptr(NULL) {}
+    lazy_annotation_c(const lazy_annotation_c &a): ptr((NULL == a.ptr)? NULL : new value_t(*a.ptr)) {}
+   ~lazy_annotation_c(void) {delete ptr;}
+
+    lazy_annotation_c &operator=(const lazy_annotation_c &a) {
+      if      (NULL != a.ptr) get() = *a.ptr;
+      else if (NULL !=   ptr) *ptr  = value_t();
+      return *this;
+    }
+    lazy_annotation_c &operator=(const value_t &v) {get() = v; return *this;}
+
+    value_t &get(void)  {return *((NULL == ptr)? lazy_alloc(&ptr) : ptr);}
+    value_t *operator->(void) {return &get();}
+    operator value_t &(void) {return get();}
+
+    bool operator==(lazy_annotation_c &a) {return get() == a.get();}
+    bool operator==(const value_t     &v) {return get() == v;}
+
+    /* has the annotation ever been modified? */
+    bool is_allocated(void) const {return NULL != ptr;}
+};
+
+
+
+/* A std::vector, only allocated when an element is first added */
+template<typename value_t> class lazy_vector_c {
+  public:
+    typedef std::vector<value_t>              vector_t;
+    typedef typename vector_t::iterator       iterator;
+    typedef typename vector_t::const_iterator const_iterator;
+    typedef typename vector_t::size_type      size_type;
+
+  private:
+    vector_t *ptr;
+
+  public:
+    lazy_vector_c(void): ptr(NULL) {}
+    lazy_vector_c(const lazy_vector_c &v): ptr((NULL == v.ptr)? NULL : new vector_t(*v.ptr)) {}
+   ~lazy_vector_c(void) {delete ptr;}
+
+    lazy_vector_c &operator=(const lazy_vector_c &v) {
+      if      (NULL != v.ptr) get() = *v.ptr;
+      else if (NULL !=   ptr) ptr->clear();
+      return *this;
+    }
+    lazy_vector_c &operator=(const vector_t &v) {get() = v; return *this;}
+
+    vector_t &get(void) {return *((NULL == ptr)? lazy_alloc(&ptr) : ptr);}
+    operator vector_t &(void) {return get();}
+
+    /* the following do not allocate the vector */
+    size_type size (void) const {return (NULL == ptr)? 0    : ptr->size();}
+    bool      empty(void) const {return (NULL == ptr)? true : ptr->empty();}
+    value_t  &operator[](size_type n) const {return (*ptr)[n];}
+
+    /* the following may allocate the vector */
+    iterator  begin(void) {return get().begin();}
+    iterator  end  (void) {return get().end();}
+    void      push_back(const value_t &v) {get().push_back(v);}
+    iterator  erase(iterator i) {return get().erase(i);}
+    void      clear(void) {if (NULL != ptr) ptr->clear();}
+};
+
+
+
+/* A std::map, only allocated when an entry is first added */
+template<typename key_t, typename value_t> class lazy_map_c {
+  public:
+    typedef std::map<key_t, value_t> map_t;
+
+  private:
+    map_t *ptr;
+
+  public:
+    lazy_map_c(void): ptr(NULL) {}
+    lazy_map_c(const lazy_map_c &m): ptr((NULL == m.ptr)? NULL : new map_t(*m.ptr)) {}
+   ~lazy_map_c(void) {delete ptr;}
+
+    lazy_map_c &operator=(const lazy_map_c &m) {
+      if      (NULL != m.ptr) get() = *m.ptr;
+      else if (NULL !=   ptr) ptr->clear();
+      return *this;
+    }
+
+    map_t &get(void) {return *((NULL == ptr)? lazy_alloc(&ptr) : ptr);}
+
+    size_t   count(const key_t &k) const {return (NULL == ptr)? 0 : ptr->count(k);}
+    value_t &operator[](const key_t &k) {return get()[k];}
+};
+
+
+
+/* An annotation stored inline, with the same interface as lazy_annotation_c */
+template<typename value_t> class inline_annotation_c {
+  private:
+    value_t value;
+
+  public:
+    inline_annotation_c &operator=(const value_t &v) {value = v; return *this;}
+
+    value_t &get(void)  {return value;}
+    value_t *operator->(void) {return &value;}
+    operator value_t &(void) {return value;}
+
+    bool operator==(inline_annotation_c &a) {return value == a.value;}
+    bool operator==(const value_t       &v) {return value == v;}
+
+    bool is_allocated(void) const {return true;}
+};
+
+
+#endif /* _LAZY_ANNOTATION_HH */
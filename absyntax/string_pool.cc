@@ -0,0 +1,190 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * The string pool.
+ *
+ * See string_pool.hh for details.
+ */
+
+
+#include <stdlib.h>  /* required for malloc() and calloc() */
+#include <string.h>  /* required for memcpy() and memcmp() */
+#include <ctype.h>   /* required for toupper() and islower() */
+#include <pthread.h>
+#include "string_pool.hh"
+#include "arena.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+
+
+/* initial number of slots in the string pool index. Must be a power of 2 */
+#define POOL_INITIAL_SIZE (4 * 1024)
+
+
+/* NOTE: All the following static variables are constant initialised (i.e. before any
+ *       constructor is called), so the string pool may be safely used by the constructors
+ *       of global/static objects (e.g. a static identifier_c).
+ */
+
+
+/*************/
+/* The arena */
+/*************/
+
+static arena_c string_arena;
+
+void  *arena_alloc(size_t size) {return string_arena.alloc(size);}
+size_t arena_size (void)        {return string_arena.size();}
+
+
+
+/*******************/
+/* The string pool */
+/*******************/
+
+/* Each interned string is stored in the arena right after its header. */
+typedef struct {
+  const char *upper;  /* the interned copy of the string folded to upper case (may point to itself) */
+} string_header_t;
+
+typedef struct {
+  const char   *str;  /* NULL if slot is empty */
+  unsigned int  hash;
+} pool_slot_t;
+
+static pool_slot_t  *pool_slots = NULL;
+static unsigned int  pool_size  = 0;  /* always a power of 2 */
+static unsigned int  pool_used  = 0;
+
+/* New tokens may be created by several threads at the same time (see stage3.cc) */
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/* FNV-1a */
+static unsigned int hash_string(const char *str, size_t len) {
+  unsigned int h = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    h ^= (unsigned char)str[i];
+    h *= 16777619u;
+  }
+  return h;
+}
+
+
+static void pool_grow(void) {
+  pool_slot_t  *old_slots = pool_slots;
+  unsigned int  old_size  = pool_size;
+
+  pool_size  = (old_size == 0)? POOL_INITIAL_SIZE : 2 * old_size;
+  pool_slots = (pool_slot_t *)calloc(pool_size, sizeof(pool_slot_t));
+  if (NULL == pool_slots) ERROR_MSG("out of memory");
+
+  unsigned int mask = pool_size - 1;
+  for (unsigned int i = 0; i < old_size; i++) {
+    if (NULL == old_slots[i].str) continue;
+    unsigned int j;
+    for (j = old_slots[i].hash & mask; NULL != pool_slots[j].str; j = (j + 1) & mask);
+    pool_slots[j] = old_slots[i];
+  }
+  free(old_slots);
+}
+
+
+/* NOTE: must be called with pool_mutex locked */
+static const char *intern_string_locked(const char *str, size_t len) {
+  /* keep the load factor below 1/2 */
+  if (2 * (pool_used + 1) > pool_size)
+    pool_grow();
+
+  unsigned int hash = hash_string(str, len);
+  unsigned int mask = pool_size - 1;
+  unsigned int i;
+  for (i = hash & mask; NULL != pool_slots[i].str; i = (i + 1) & mask)
+    if (   (pool_slots[i].hash == hash)
+        && (memcmp(pool_slots[i].str, str, len) == 0) && (pool_slots[i].str[len] == '\0'))
+      return pool_slots[i].str;
+
+  /* Not yet in the pool. Add it. */
+  string_header_t *header = (string_header_t *)arena_alloc(sizeof(string_header_t) + len + 1);
+  char *res = (char *)(header + 1);
+  memcpy(res, str, len);
+  res[len] = '\0';
+  pool_slots[i].str  = res;
+  pool_slots[i].hash = hash;
+  pool_used++;
+
+  /* Now get the upper case version.
+   * NOTE: This must be done only after inserting res in the pool, as the
+   *       recursive call to intern_string_locked() may change pool_slots[].
+   */
+  bool is_upper = true;
+  for (size_t k = 0; k < len; k++)
+    if (islower((unsigned char)res[k])) {is_upper = false; break;}
+
+  if (is_upper) {
+    header->upper = res;
+  } else {
+    char *upper = (char *)malloc(len + 1);
+    if (NULL == upper) ERROR_MSG("out of memory");
+    for (size_t k = 0; k <= len; k++)
+      upper[k] = toupper((unsigned char)res[k]);
+    header->upper = intern_string_locked(upper, len);
+    free(upper);
+  }
+
+  return res;
+}
+
+
+const char *intern_string(const char *str, size_t len) {
+  if (NULL == str) return NULL;
+  pthread_mutex_lock(&pool_mutex);
+  const char *res = intern_string_locked(str, len);
+  pthread_mutex_unlock(&pool_mutex);
+  return res;
+}
+
+
+const char *intern_string(const char *str) {
+  if (NULL == str) return NULL;
+  return intern_string(str, strlen(str));
+}
+
+
+const char *interned_upper(const char *interned_str) {
+  if (NULL == interned_str) return NULL;
+  return ((const string_header_t *)interned_str - 1)->upper;
+}
+
+
+size_t string_pool_count(void) {return pool_used;}
@@ -0,0 +1,81 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * The string pool.
+ *
+ * Stores a single copy of each distinct string used as the value of a token
+ * (identifiers, literals, ...). The values of all the tokens in the abstract
+ * syntax tree are interned by the token_c constructor, so the thousands of
+ * 'EN', 'ENO', 'IN', ... identifiers in the standard library all share the
+ * same memory.
+ *
+ * Each interned string also keeps a reference to the interned copy of the
+ * same string folded to upper case. Since identifiers are case insensitive,
+ * two interned identifiers are the same identifier if (and only if) their
+ * upper case versions are the same pointer.
+ *
+ * The interned strings are never freed. They are stored in large blocks of
+ * memory (a bump allocator), which may also be used directly for any other
+ * memory that is never freed (arena_alloc()).
+ */
+
+
+#ifndef _STRING_POOL_HH
+#define _STRING_POOL_HH
+
+#include <stddef.h>  /* required for size_t */
+
+
+/* Returns the single copy of str stored in the string pool (with the exact same spelling).
+ * Returns NULL if str is NULL.
+ */
+const char *intern_string(const char *str);
+/* Same as above, but only considers the first len characters of str */
+const char *intern_string(const char *str, size_t len);
+
+/* Returns the interned copy of interned_str folded to upper case.
+ * WARNING: interned_str MUST have been returned by intern_string()!
+ */
+const char *interned_upper(const char *interned_str);
+
+/* Allocate memory that will never be freed, from the same blocks of memory used by the string pool.
+ * The returned memory is aligned for any pointer or integer type.
+ */
+void *arena_alloc(size_t size);
+
+/* Some statistics, for debugging purposes... */
+size_t string_pool_count(void); /* number of distinct strings in the pool */
+size_t arena_size(void);        /* total memory (in bytes) allocated for the arena */
+
+
+#endif /* _STRING_POOL_HH */
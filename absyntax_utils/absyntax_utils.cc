@@ -87,7 +87,8 @@ int compare_identifiers(symbol_c *ident1, symbol_c *ident2) {
     /* invalid identifiers... */
     return -1;
 
-  if (strcasecmp(name1->value, name2->value) == 0)
+  /* token values are interned, so identifiers that differ only in case share the same upper case version */
+  if (interned_upper(name1->value) == interned_upper(name2->value))
     return 0;
 
   /* identifiers do not match! */
@@ -279,7 +280,20 @@ class populate_symtables_c: public iterator_visitor_c {
 
 void absyntax_utils_init(symbol_c *tree_root) {
   populate_symtables_c populate_symbols;
-
-  tree_root->accept(populate_symbols);
+  /* the library whose first populated_elements elements are already in the symbol tables */
+  static library_c *populated_library  = NULL;
+  static int        populated_elements = 0;
+
+  library_c *library = dynamic_cast<library_c *>(tree_root);
+  if ((NULL == library) || (library != populated_library)) {
+    tree_root->accept(populate_symbols);
+  } else {
+    for (int i = populated_elements; i < library->n; i++)
+      library->get_element(i)->accept(populate_symbols);
+  }
+  if (NULL != library) {
+    populated_library  = library;
+    populated_elements = library->n;
+  }
 }
 
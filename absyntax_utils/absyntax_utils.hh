@@ -47,6 +47,7 @@
 // #include <stdio.h>  /* required for NULL */
 #include "../util/symtable.hh"
 #include "../util/dsymtable.hh"
+#include "../util/nocase_hashtable.hh"
 #include "../absyntax/absyntax.hh"
 #include "../absyntax/visitor.hh"
 
@@ -111,6 +112,10 @@ extern  type_symtable_t type_symtable;
 
 
 
+/* Add the library elements of tree_root to the symbol tables (function_symtable, type_symtable, ...).
+ * Called again on the same library (i.e. with the standard library kept resident by the compiler
+ * server, to which the input file was later added) only adds the elements appended since the last call.
+ */
 void absyntax_utils_init(symbol_c *tree_root);
 
 
@@ -70,7 +70,7 @@
 /****************************************************************************************************/
 class get_datatype_id_c: null_visitor_c {
   private:
-    static get_datatype_id_c *singleton;
+    static __thread get_datatype_id_c *singleton;
     
   public:
     static symbol_c *get_id(symbol_c *symbol) {
@@ -165,7 +165,7 @@ class get_datatype_id_c: null_visitor_c {
     
 }; // get_datatype_id_c 
 
-get_datatype_id_c *get_datatype_id_c::singleton = NULL;
+__thread get_datatype_id_c *get_datatype_id_c::singleton = NULL;
 
 
 
@@ -189,7 +189,7 @@ class get_datatype_id_str_c: public null_visitor_c {
 
   private:
     /* singleton class! */
-    static get_datatype_id_str_c *singleton;
+    static __thread get_datatype_id_str_c *singleton;
 
   public:
     static const char *get_id_str(symbol_c *symbol) {
@@ -311,7 +311,7 @@ class get_datatype_id_str_c: public null_visitor_c {
     void *visit(       program_declaration_c  *symbol)  {return symbol->program_type_name->accept(*this);} 
 };
 
-get_datatype_id_str_c *get_datatype_id_str_c::singleton = NULL;
+__thread get_datatype_id_str_c *get_datatype_id_str_c::singleton = NULL;
 
 
 
@@ -325,7 +325,7 @@ class get_struct_info_c : null_visitor_c {
   private:
     symbol_c *current_field;
     /* singleton class! */
-    static get_struct_info_c *singleton;
+    static __thread get_struct_info_c *singleton;
 
   public:
     get_struct_info_c(void) {current_field = NULL;}
@@ -418,7 +418,7 @@ class get_struct_info_c : null_visitor_c {
       
 }; // get_struct_info_c
 
-get_struct_info_c *get_struct_info_c::singleton = NULL;
+__thread get_struct_info_c *get_struct_info_c::singleton = NULL;
 
 
 
@@ -722,10 +722,10 @@ bool get_datatype_info_c::is_arraytype_equal_relaxed(symbol_c *first_type, symbo
      *  the get_datatype_info_c::is_type_equal() method is called.
      *  This is why we implement an alternative method in case the subrange limits have not yet been reduced to a cvalue!
      */
-    if (    (subrange_1->lower_limit->const_value._int64.is_valid() || subrange_1->lower_limit->const_value._uint64.is_valid())
-         && (subrange_2->lower_limit->const_value._int64.is_valid() || subrange_2->lower_limit->const_value._uint64.is_valid())
-         && (subrange_1->upper_limit->const_value._int64.is_valid() || subrange_1->upper_limit->const_value._uint64.is_valid())
-         && (subrange_2->upper_limit->const_value._int64.is_valid() || subrange_2->upper_limit->const_value._uint64.is_valid())
+    if (    (subrange_1->lower_limit->const_value->_int64.is_valid() || subrange_1->lower_limit->const_value->_uint64.is_valid())
+         && (subrange_2->lower_limit->const_value->_int64.is_valid() || subrange_2->lower_limit->const_value->_uint64.is_valid())
+         && (subrange_1->upper_limit->const_value->_int64.is_valid() || subrange_1->upper_limit->const_value->_uint64.is_valid())
+         && (subrange_2->upper_limit->const_value->_int64.is_valid() || subrange_2->upper_limit->const_value->_uint64.is_valid())
        ) {
       if (! (subrange_1->lower_limit->const_value == subrange_2->lower_limit->const_value)) return false;
       if (! (subrange_1->upper_limit->const_value == subrange_2->upper_limit->const_value)) return false;
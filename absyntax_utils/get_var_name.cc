@@ -44,7 +44,7 @@
    
     
 
-get_var_name_c *get_var_name_c::singleton_instance_ = NULL;
+__thread get_var_name_c *get_var_name_c::singleton_instance_ = NULL;
 
 
 
@@ -67,7 +67,7 @@ class get_var_name_c : public search_visitor_c {
     static symbol_c *get_last_field(symbol_c *symbol);
     
   private:
-    static get_var_name_c *singleton_instance_;
+    static __thread get_var_name_c *singleton_instance_;
     symbol_c *last_field;
     
   private:  
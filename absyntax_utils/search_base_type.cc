@@ -50,7 +50,7 @@
 
 
 /* pointer to singleton instance */
-search_base_type_c *search_base_type_c::search_base_type_singleton = NULL;
+__thread search_base_type_c *search_base_type_c::search_base_type_singleton = NULL;
 
 
 
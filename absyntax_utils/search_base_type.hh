@@ -70,7 +70,8 @@ class search_base_type_c: public null_visitor_c {
     symbol_c *current_basetype_name;
     symbol_c *current_basetype;
     symbol_c *current_equivtype;
-    static search_base_type_c *search_base_type_singleton; // Make this a singleton class!
+    /* NOTE: the singleton keeps the state of the current search, so each thread gets its own (see stage3.cc) */
+    static __thread search_base_type_c *search_base_type_singleton; // Make this a singleton class!
     
   private:  
     static void create_singleton(void);
@@ -87,26 +87,73 @@
  */
 
 
+#include <pthread.h>
 #include "absyntax_utils.hh"
 
 
 
 
 
+std::map<symbol_c *, search_var_instance_decl_c::scope_index_t *> search_var_instance_decl_c::scope_indexes;
+/* The indexes are shared by all threads (see stage3.cc). Once built, an index is never changed. */
+static pthread_mutex_t scope_indexes_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
 search_var_instance_decl_c::search_var_instance_decl_c(symbol_c *search_scope) {
   this->current_vartype = none_vt;
   this->search_scope = search_scope;
-  this->search_name = NULL;
+  this->scope_index = NULL;
   this->current_type_decl = NULL;
   this->current_option = none_opt;
 }
 
+
+/* Visit the whole search scope, adding every variable declared in it to the index. 
+ * Since only the first declaration of each name is added to the index, searching the index
+ * returns exactly what a search through the declarations (stopping at the first match) would.
+ */
+void search_var_instance_decl_c::build_index(void) {
+  pthread_mutex_lock(&scope_indexes_mutex);
+  std::map<symbol_c *, scope_index_t *>::iterator i = scope_indexes.find(search_scope);
+  if (i != scope_indexes.end()) {
+    scope_index = i->second;
+  } else {
+    scope_index = new scope_index_t();
+    current_vartype   = none_vt;
+    current_option    = none_opt;
+    current_type_decl = NULL;
+    search_scope->accept(*this);
+    scope_indexes[search_scope] = scope_index;
+  }
+  pthread_mutex_unlock(&scope_indexes_mutex);
+}
+
+
+void search_var_instance_decl_c::add_to_index(symbol_c *variable_name, symbol_c *decl) {
+  token_c *name = dynamic_cast<token_c *>(variable_name);
+  /* a NULL decl is never returned as a search result (the search continues), so do not add it to the index */
+  if ((NULL == name) || (NULL == decl))
+    return;
+  if (scope_index->find(name->value) != scope_index->end())
+    return; /* only the first declaration is visible */
+  index_entry_t entry = {decl, current_vartype, current_option};
+  scope_index->insert(name->value, entry);
+}
+
+
+search_var_instance_decl_c::index_entry_t *search_var_instance_decl_c::find_entry(symbol_c *variable) {
+  token_c *name = dynamic_cast<token_c *>(get_var_name_c::get_name(variable));
+  if (NULL == name) return NULL;
+  if (NULL == scope_index) build_index();
+  scope_index_t::iterator i = scope_index->find(name->value);
+  return (i == scope_index->end())? NULL : &i->second;
+}
+
+
 symbol_c *search_var_instance_decl_c::get_decl(symbol_c *variable) {
-  this->current_vartype = none_vt;
-  this->current_option  = none_opt;
-  this->search_name = get_var_name_c::get_name(variable);
   if (NULL == search_scope) return NULL; // NOTE: This is not an ERROR! declaration_check_c, for e.g., relies on this returning NULL!
-  return (symbol_c *)search_scope->accept(*this);
+  index_entry_t *entry = find_entry(variable);
+  return (NULL == entry)? NULL : entry->decl;
 }
 
 symbol_c *search_var_instance_decl_c::get_basetype_decl(symbol_c *variable) {
@@ -114,21 +161,15 @@ symbol_c *search_var_instance_decl_c::get_basetype_decl(symbol_c *variable) {
 }
 
 search_var_instance_decl_c::vt_t search_var_instance_decl_c::get_vartype(symbol_c *variable) {
-  this->current_vartype = none_vt;
-  this->current_option  = none_opt;
-  this->search_name = get_var_name_c::get_name(variable);
   if (NULL == search_scope) ERROR;
-  search_scope->accept(*this);
-  return this->current_vartype;
+  index_entry_t *entry = find_entry(variable);
+  return (NULL == entry)? none_vt : entry->vartype;
 }
 
 search_var_instance_decl_c::opt_t search_var_instance_decl_c::get_option(symbol_c *variable) {
-  this->current_vartype = none_vt;
-  this->current_option  = none_opt;
-  this->search_name = get_var_name_c::get_name(variable);
   if (NULL == search_scope) ERROR;
-  search_scope->accept(*this);
-  return this->current_option;
+  index_entry_t *entry = find_entry(variable);
+  return (NULL == entry)? none_opt : entry->option;
 }
 
 
@@ -209,15 +250,13 @@ void *search_var_instance_decl_c::visit(input_output_declarations_c *symbol) {
 
 /* ENO : BOOL */
 void *search_var_instance_decl_c::visit(eno_param_declaration_c *symbol) {
-  if (compare_identifiers(symbol->name, search_name) == 0)
-    return symbol->type;
+  add_to_index(symbol->name, symbol->type);
   return NULL;
 }
 
 /* EN : BOOL */
 void *search_var_instance_decl_c::visit(en_param_declaration_c *symbol) {
-  if (compare_identifiers(symbol->name, search_name) == 0)
-    return symbol->type_decl;
+  add_to_index(symbol->name, symbol->type_decl);
   return NULL;
 }
 
@@ -312,11 +351,9 @@ void *search_var_instance_decl_c::visit(var1_init_decl_c *symbol) {
 // SYM_LIST(var1_list_c)
 void *search_var_instance_decl_c::visit(var1_list_c *symbol) {
   list_c *list = symbol;
-  for(int i = 0; i < list->n; i++) {
-    if (compare_identifiers(list->get_element(i), search_name) == 0)
+  for(int i = 0; i < list->n; i++)
    /* by now, current_type_decl should be != NULL */
-      return current_type_decl;
-  }
+    add_to_index(list->get_element(i), current_type_decl);
   return NULL;
 }
 
@@ -334,11 +371,9 @@ void *search_var_instance_decl_c::visit(fb_name_decl_c *symbol) {
 /* name_list ',' fb_name */
 void *search_var_instance_decl_c::visit(fb_name_list_c *symbol) {
   list_c *list = symbol;
-  for(int i = 0; i < list->n; i++) {
-    if (compare_identifiers(list->get_element(i), search_name) == 0)
+  for(int i = 0; i < list->n; i++)
     /* by now, current_fb_declaration should be != NULL */
-      return current_type_decl;
-  }
+    add_to_index(list->get_element(i), current_type_decl);
   return NULL;
 }
 
@@ -378,8 +413,7 @@ void *search_var_instance_decl_c::visit(structured_var_declaration_c *symbol) {
 /*  global_var_name ':' (simple_specification|subrange_specification|enumerated_specification|array_specification|prev_declared_structure_type_name|function_block_type_name */
 // SYM_REF2(external_declaration_c, global_var_name, specification)
 void *search_var_instance_decl_c::visit(external_declaration_c *symbol) {
-  if (compare_identifiers(symbol->global_var_name, search_name) == 0)
-      return symbol->specification;
+  add_to_index(symbol->global_var_name, symbol->specification);
   return NULL;
 }
 
@@ -398,21 +432,18 @@ void *search_var_instance_decl_c::visit(global_var_decl_c *symbol) {
 /*| global_var_name location */
 //SYM_REF2(global_var_spec_c, global_var_name, location)
 void *search_var_instance_decl_c::visit(global_var_spec_c *symbol) {
-  if (symbol->global_var_name != NULL && compare_identifiers(symbol->global_var_name, search_name) == 0)
-      return current_type_decl;
-  else
-    return symbol->location->accept(*this);
+  if (symbol->global_var_name != NULL)
+    add_to_index(symbol->global_var_name, current_type_decl);
+  return symbol->location->accept(*this);
 }
 
 /*| global_var_list ',' global_var_name */
 //SYM_LIST(global_var_list_c)
 void *search_var_instance_decl_c::visit(global_var_list_c *symbol) {
   list_c *list = symbol;
-  for(int i = 0; i < list->n; i++) {
-    if (compare_identifiers(list->get_element(i), search_name) == 0)
-      /* by now, current_type_decl should be != NULL */
-      return current_type_decl;
-  }
+  for(int i = 0; i < list->n; i++)
+    /* by now, current_type_decl should be != NULL */
+    add_to_index(list->get_element(i), current_type_decl);
   return NULL;
 }
 
@@ -420,12 +451,10 @@ void *search_var_instance_decl_c::visit(global_var_list_c *symbol) {
 /* variable_name -> may be NULL ! */
 //SYM_REF4(located_var_decl_c, variable_name, location, located_var_spec_init, unused)
 void *search_var_instance_decl_c::visit(located_var_decl_c *symbol) {
-  if (symbol->variable_name != NULL && compare_identifiers(symbol->variable_name, search_name) == 0)
-    return symbol->located_var_spec_init;
-  else {
-    current_type_decl = symbol->located_var_spec_init;
-    return symbol->location->accept(*this);
-  }
+  if (symbol->variable_name != NULL)
+    add_to_index(symbol->variable_name, symbol->located_var_spec_init);
+  current_type_decl = symbol->located_var_spec_init;
+  return symbol->location->accept(*this);
 }
 
 /*| global_var_spec ':' [located_var_spec_init|function_block_type_name] */
@@ -436,10 +465,8 @@ void *search_var_instance_decl_c::visit(located_var_decl_c *symbol) {
 /*  AT direct_variable */
 // SYM_REF2(location_c, direct_variable, unused)
 void *search_var_instance_decl_c::visit(location_c *symbol) {
-  if (compare_identifiers(symbol->direct_variable, search_name) == 0)
-    return current_type_decl;
-  else
-    return NULL;
+  add_to_index(symbol->direct_variable, current_type_decl);
+  return NULL;
 }
         
 /*| global_var_list ',' global_var_name */
@@ -492,8 +519,7 @@ void *search_var_instance_decl_c::visit(function_declaration_c *symbol) {
   /* functions have a variable named after themselves, to store
    * the variable that will be returned!!
    */
-  if (compare_identifiers(symbol->derived_function_name, search_name) == 0)
-      return symbol->type_name;
+  add_to_index(symbol->derived_function_name, symbol->type_name);
 
   /* no need to search through all the body, so we only
    * visit the variable declarations...!
@@ -549,16 +575,14 @@ void *search_var_instance_decl_c::visit(program_declaration_c *symbol) {
 /* INITIAL_STEP step_name ':' action_association_list END_STEP */
 // SYM_REF2(initial_step_c, step_name, action_association_list)
 void *search_var_instance_decl_c::visit(initial_step_c *symbol) {
-  if (compare_identifiers(symbol->step_name, search_name) == 0)
-      return symbol;
+  add_to_index(symbol->step_name, symbol);
   return NULL;
 }
 
 /* STEP step_name ':' action_association_list END_STEP */
 // SYM_REF2(step_c, step_name, action_association_list)
 void *search_var_instance_decl_c::visit(step_c *symbol) {
-  if (compare_identifiers(symbol->step_name, search_name) == 0)
-      return symbol;
+  add_to_index(symbol->step_name, symbol);
   return NULL;
 }
 
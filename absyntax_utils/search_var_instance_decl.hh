@@ -136,14 +136,34 @@ class search_var_instance_decl_c: public search_visitor_c {
     opt_t     get_option        (symbol_c *variable_instance_name);
 
   private:
-    symbol_c *search_scope;
-    symbol_c *search_name;
+    /* Searching a scope for a variable requires visiting all the declarations in that scope.
+     * Since the same scope is searched over and over again (once per variable reference in
+     * the code), we visit the scope only the first time it is searched, and store all the
+     * variables declared in it in an index. All later searches are done in the index.
+     * The index is shared by all instances of this class searching the same scope, and
+     * is kept for as long as the compiler runs (as are the symbols of the abstract syntax tree).
+     */
+    typedef struct {
+      symbol_c *decl;
+      vt_t      vartype;
+      opt_t     option;
+    } index_entry_t;
+    typedef nocase_hashtable_c<index_entry_t> scope_index_t;
+    static std::map<symbol_c *, scope_index_t *> scope_indexes;
+
+    symbol_c      *search_scope;
+    scope_index_t *scope_index; /* index of search_scope. NULL until the first search. */
     symbol_c *current_type_decl;
     /* variable used to store the type of variable currently being processed... */
     /* Will contain a single value of generate_c_vardecl_c::XXXX_vt */
     vt_t  current_vartype;
     opt_t current_option;
 
+    index_entry_t *find_entry(symbol_c *variable_instance_name);
+    void build_index(void);
+    /* Add a variable declared in the scope to the index (unless already there) */
+    void add_to_index(symbol_c *variable_name, symbol_c *decl);
+
     
   private:
     /***************************/
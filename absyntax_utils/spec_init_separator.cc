@@ -265,5 +265,5 @@ void *spec_init_sperator_c::visit(double_byte_string_spec_c *symbol) {
 }
 
 
-spec_init_sperator_c *spec_init_sperator_c ::class_instance = NULL;
-spec_init_sperator_c::search_what_t spec_init_sperator_c::search_what;
+__thread spec_init_sperator_c *spec_init_sperator_c ::class_instance = NULL;
+__thread spec_init_sperator_c::search_what_t spec_init_sperator_c::search_what;
@@ -56,6 +56,7 @@
  */
 
 
+#include <pthread.h>
 #include "absyntax_utils.hh"
 
 //#define DEBUG
@@ -66,10 +67,17 @@
 #endif
 
 
+/* NOTE: The instance may be requested by several threads at the same time (e.g. when
+ *       generating the code of several POUs in parallel), so it is created only once.
+ *       Since this visitor keeps no state, all threads may then share it.
+ */
 type_initial_value_c *type_initial_value_c::instance(void) {
-  if (_instance != NULL)
-    return _instance;
+  static pthread_once_t instance_once = PTHREAD_ONCE_INIT;
+  pthread_once(&instance_once, create_instance);
+  return _instance;
+}
 
+void type_initial_value_c::create_instance(void) {
   _instance = new type_initial_value_c;
 
   null_literal = new ref_value_null_literal_c();
@@ -91,8 +99,6 @@ type_initial_value_c *type_initial_value_c::instance(void) {
   dt_0         = new date_and_time_c(new   dt_type_name_c(), date_literal_0, daytime_literal_0);  //  DT#0001-01-01-00:00:00
   string_0     = new single_byte_character_string_c("''");
   wstring_0    = new double_byte_character_string_c("\"\"");
-
-  return _instance;
 }
 
 type_initial_value_c::type_initial_value_c(void) {}
@@ -83,6 +83,7 @@ class type_initial_value_c : public null_visitor_c {
   private:
     static type_initial_value_c *_instance;
     static type_initial_value_c *instance(void);
+    static void create_instance(void);
     void *handle_type_spec(symbol_c *base_type_name, symbol_c *type_spec_init);
     void *handle_type_name(symbol_c *type_name);
 
@@ -1,13 +1,95 @@
 #ifndef __ACCESSOR_H
 #define __ACCESSOR_H
 
+#include "iec_types_all.h"  /* for the force table, as POUS.h includes this file first */
+
 #define __INITIAL_VALUE(...) __VA_ARGS__
 
+// Resource threads
+/* With IEC_RESOURCE_THREADS defined (iec2c's '-O r' option) the tasks of each resource (and the
+ * programs of each resource not associated to any task) form execution units, that may each be
+ * run on its own thread (see iec_threads.h). The units are listed in __iec_units[], and the
+ * resources in __iec_resources[], both declared in the generated configuration file.
+ *
+ * Each unit works on its own copy of every global variable (of elementary or derived type),
+ * i.e. the externals of the programs are bound to the copy of the unit in which the program
+ * was initialised. The copies are loaded from the shared global variables at the start of
+ * each cycle of the unit (__IEC_UNIT_BEGIN), and the values written during the cycle
+ * are stored back at its end (__IEC_UNIT_END). When several units write to the same variable
+ * in overlapping cycles, the last one to finish its cycle wins.
+ * NOTE: Global function block instances and located variables are not copied, and
+ *       are shared by all the units.
+ * NOTE: With '-O f' the force table is applied to the shared global variables by config_run__()
+ *       only, so it does not apply when the units are run on their own threads.
+ */
+#ifdef IEC_RESOURCE_THREADS
+typedef struct {
+	const char         *name;
+	unsigned long long  period;  // ns
+	void (*run)(unsigned long tick);
+} __IEC_RESOURCE_t;
+
+typedef struct {
+	const char         *name;
+	int                 resource;   // index into __iec_resources[]
+	unsigned long long  period;     // ns
+	unsigned long       tick_step;  // the number of ticks of the resource in each period
+	void (*run)(int unit, unsigned long tick);
+} __IEC_UNIT_t;
+
+extern __thread int __iec_current_unit;  // -1 when not running inside a unit
+extern void __iec_lock_globals(void);
+extern void __iec_unlock_globals(void);
+extern void config_load_globals__(int unit);
+extern void config_store_globals__(int unit);
+
+#define __IEC_UNIT_BEGIN(unit, resource)\
+	__iec_current_unit = unit;\
+	__iec_lock_globals();\
+	config_load_globals__(unit);\
+	resource##_load_globals__(unit);\
+	__iec_unlock_globals();
+#define __IEC_UNIT_END(unit, resource)\
+	__iec_lock_globals();\
+	config_store_globals__(unit);\
+	resource##_store_globals__(unit);\
+	__iec_unlock_globals();\
+	__iec_current_unit = -1;
+#endif
+
+
 // variable declaration macros
 #define __DECLARE_VAR(type, name)\
 	__IEC_##type##_t name;
 #define __DECLARE_GLOBAL(type, domain, name)\
 	__IEC_##type##_t domain##__##name;\
+	__DECLARE_GLOBAL_ACCESSORS(type, domain, name)
+#ifdef IEC_RESOURCE_THREADS
+#define __DECLARE_GLOBAL_ACCESSORS(type, domain, name)\
+	static __IEC_##type##_t *GLOBAL__##name = &(domain##__##name);\
+	static __IEC_##type##_t domain##__##name##__unit[__IEC_UNIT_COUNT];\
+	static type domain##__##name##__loaded[__IEC_UNIT_COUNT];\
+	void __INIT_GLOBAL_##name(type value) {\
+		(*GLOBAL__##name).value = value;\
+	}\
+	IEC_BYTE __IS_GLOBAL_##name##_FORCED(void) {\
+		if (__iec_current_unit < 0) return (*GLOBAL__##name).flags & __IEC_FORCE_FLAG;\
+		return domain##__##name##__unit[__iec_current_unit].flags & __IEC_FORCE_FLAG;\
+	}\
+	type* __GET_GLOBAL_##name(void) {\
+		if (__iec_current_unit < 0) return &((*GLOBAL__##name).value);\
+		return &(domain##__##name##__unit[__iec_current_unit].value);\
+	}\
+	void __LOAD_GLOBAL_##name(int unit) {\
+		domain##__##name##__unit[unit] = *GLOBAL__##name;\
+		domain##__##name##__loaded[unit] = (*GLOBAL__##name).value;\
+	}\
+	void __STORE_GLOBAL_##name(int unit) {\
+		if (memcmp(&(domain##__##name##__unit[unit].value), &(domain##__##name##__loaded[unit]), sizeof(type)))\
+			(*GLOBAL__##name).value = domain##__##name##__unit[unit].value;\
+	}
+#else
+#define __DECLARE_GLOBAL_ACCESSORS(type, domain, name)\
 	static __IEC_##type##_t *GLOBAL__##name = &(domain##__##name);\
 	void __INIT_GLOBAL_##name(type value) {\
 		(*GLOBAL__##name).value = value;\
@@ -18,8 +100,11 @@
 	type* __GET_GLOBAL_##name(void) {\
 		return &((*GLOBAL__##name).value);\
 	}
+#endif
 #define __DECLARE_GLOBAL_FB(type, domain, name)\
 	type domain##__##name;\
+	__DECLARE_GLOBAL_FB_ACCESSORS(type, domain, name)
+#define __DECLARE_GLOBAL_FB_ACCESSORS(type, domain, name)\
 	static type *GLOBAL__##name = &(domain##__##name);\
 	type* __GET_GLOBAL_##name(void) {\
 		return &(*GLOBAL__##name);\
@@ -49,6 +134,42 @@
 	__IEC_##type##_p name;
 
 
+// Retain segments
+/* With iec2c's '-O k' option the RETAIN global variables (other than located variables) of the
+ * configuration, and of each resource, are placed in a single structure, the retain segment of that
+ * configuration or resource, declared in the generated file of the configuration or resource as:
+ *   struct {
+ *     __DECLARE_RETAIN(INT, VAR1)
+ *     __DECLARE_RETAIN_FB(TON, TIMER1)
+ *   } RES1__retain;
+ *   __DECLARE_RETAIN_SEGMENT(RES1)
+ * Each variable is then declared with __DECLARE_GLOBAL_RETAIN (or __DECLARE_GLOBAL_FB_RETAIN), preceded by
+ *   #define RES1__VAR1 (RES1__retain.VAR1)
+ * so the variable may still be referred to by its usual name inside the generated files (other
+ * source files must reach it through the segment, as RES1__VAR1 is no longer a variable).
+ * The segments are listed in __iec_retain_segments[] (NULL terminated), declared in the generated
+ * configuration file, so the runtime may save and restore all the retain data with a single
+ * copy of each segment.
+ * NOTE: RETAIN variables declared inside programs and function blocks are not placed in the segments.
+ */
+typedef struct {
+	const char   *name;   // of the configuration or resource
+	void         *data;
+	unsigned int  size;
+} __IEC_RETAIN_SEGMENT_t;
+
+#define __DECLARE_RETAIN(type, name)\
+	__IEC_##type##_t name;
+#define __DECLARE_RETAIN_FB(type, name)\
+	type name;
+#define __DECLARE_RETAIN_SEGMENT(domain)\
+	const __IEC_RETAIN_SEGMENT_t domain##__retain_segment = {#domain, &domain##__retain, sizeof(domain##__retain)};
+#define __DECLARE_GLOBAL_RETAIN(type, domain, name)\
+	__DECLARE_GLOBAL_ACCESSORS(type, domain, name)
+#define __DECLARE_GLOBAL_FB_RETAIN(type, domain, name)\
+	__DECLARE_GLOBAL_FB_ACCESSORS(type, domain, name)
+
+
 // variable initialization macros
 #define __INIT_RETAIN(name, retained)\
     name.flags |= retained?__IEC_RETAIN_FLAG:0;
@@ -83,24 +204,125 @@
 	*(name.value) = initial;
 
 
+// Forcing variables
+/* By default every access to a variable that may be forced (i.e. every __SET_xxx(), and every __GET_xxx()
+ * of an external or located variable) tests the variable's __IEC_FORCE_FLAG.
+ * With IEC_PRODUCTION_ACCESSORS defined (iec2c's '-O f' option) these accesses are plain loads and stores,
+ * and the forced variables are instead listed in a force table (declared in the generated
+ * configuration file with __DECLARE_FORCE_TABLE), whose forced values are copied onto
+ * the variables at the start and at the end of each cycle by config_run__().
+ * NOTE: In this mode forcing an external or located variable forces the global (or the located)
+ *       variable itself, and not just the values read through that reference.
+ *
+ * The runtime should force variables with the following macros, which work in both modes:
+ *   __FORCE_VAR(var, value)     / __UNFORCE_VAR(var)      for __IEC_xxx_t variables
+ *   __FORCE_REF(var, value)     / __UNFORCE_REF(var)      for __IEC_xxx_p variables (externals and located)
+ * Only variables of elementary types may be placed in the force table.
+ */
+typedef struct {
+	void        *value;   // the variable, as read and written by the generated code
+	unsigned int size;
+	union {IEC_LWORD align; char bytes[sizeof(IEC_STRING)];} fvalue;  // a copy of the forced value (elementary types only)
+} __IEC_FORCE_ENTRY_t;
+
+#ifndef __IEC_FORCE_TABLE_SIZE
+#define __IEC_FORCE_TABLE_SIZE 256
+#endif
+
+#ifdef IEC_PRODUCTION_ACCESSORS
+#define __DECLARE_FORCE_TABLE\
+	static __IEC_FORCE_ENTRY_t __force_table[__IEC_FORCE_TABLE_SIZE];\
+	static unsigned int __force_count = 0;\
+	int __force_entry(void *value, const void *fvalue, unsigned int size) {\
+		unsigned int i;\
+		for (i = 0; i < __force_count && __force_table[i].value != value; i++);\
+		if (i == __IEC_FORCE_TABLE_SIZE || size > sizeof(__force_table[i].fvalue)) return -1;\
+		if (i == __force_count) __force_count++;\
+		__force_table[i].value = value;\
+		__force_table[i].size  = size;\
+		memcpy(&(__force_table[i].fvalue), fvalue, size);\
+		memcpy(value, fvalue, size);\
+		return 0;\
+	}\
+	void __unforce_entry(void *value) {\
+		unsigned int i;\
+		for (i = 0; i < __force_count; i++)\
+			if (__force_table[i].value == value) {__force_table[i] = __force_table[--__force_count]; return;}\
+	}\
+	void __apply_force_table(void) {\
+		unsigned int i;\
+		for (i = 0; i < __force_count; i++)\
+			memcpy(__force_table[i].value, &(__force_table[i].fvalue), __force_table[i].size);\
+	}
+#define __APPLY_FORCE_TABLE\
+	__apply_force_table();
+
+extern int  __force_entry(void *value, const void *fvalue, unsigned int size);
+extern void __unforce_entry(void *value);
+#define __FORCE_VAR(var, forced_value)\
+	{(var).value = (forced_value); (var).flags |= __IEC_FORCE_FLAG;\
+	 __force_entry(&((var).value), &((var).value), sizeof((var).value));}
+#define __FORCE_REF(var, forced_value)\
+	{(var).fvalue = (forced_value); (var).flags |= __IEC_FORCE_FLAG;\
+	 __force_entry((var).value, &((var).fvalue), sizeof(*((var).value)));}
+#define __UNFORCE_VAR(var)\
+	{(var).flags &= ~__IEC_FORCE_FLAG; __unforce_entry(&((var).value));}
+#define __UNFORCE_REF(var)\
+	{(var).flags &= ~__IEC_FORCE_FLAG; __unforce_entry((var).value);}
+#else
+#define __DECLARE_FORCE_TABLE
+#define __APPLY_FORCE_TABLE
+#define __FORCE_VAR(var, forced_value)\
+	{(var).value = (forced_value); (var).flags |= __IEC_FORCE_FLAG;}
+#define __FORCE_REF(var, forced_value)\
+	{(var).fvalue = (forced_value); (var).flags |= __IEC_FORCE_FLAG;}
+#define __UNFORCE_VAR(var)\
+	{(var).flags &= ~__IEC_FORCE_FLAG;}
+#define __UNFORCE_REF(var)\
+	__UNFORCE_VAR(var)
+#endif
+
+
 // variable getting macros
 #define __GET_VAR(name, ...)\
 	name.value __VA_ARGS__
+#ifdef IEC_PRODUCTION_ACCESSORS
+#define __GET_EXTERNAL(name, ...)\
+	((*(name.value)) __VA_ARGS__)
+#else
 #define __GET_EXTERNAL(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? name.fvalue __VA_ARGS__ : (*(name.value)) __VA_ARGS__)
+#endif
 #define __GET_EXTERNAL_FB(name, ...)\
 	__GET_VAR(((*name) __VA_ARGS__))
+#ifdef IEC_PRODUCTION_ACCESSORS
+#define __GET_LOCATED(name, ...)\
+	((*(name.value)) __VA_ARGS__)
+#else
 #define __GET_LOCATED(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? name.fvalue __VA_ARGS__ : (*(name.value)) __VA_ARGS__)
+#endif
 
+#ifdef IEC_PRODUCTION_ACCESSORS
+#define __GET_VAR_BY_REF(name, ...)\
+	(&(name.value __VA_ARGS__))
+#define __GET_EXTERNAL_BY_REF(name, ...)\
+	(&((*(name.value)) __VA_ARGS__))
+#else
 #define __GET_VAR_BY_REF(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : &(name.value __VA_ARGS__))
 #define __GET_EXTERNAL_BY_REF(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : &((*(name.value)) __VA_ARGS__))
+#endif
 #define __GET_EXTERNAL_FB_BY_REF(name, ...)\
 	__GET_EXTERNAL_BY_REF(((*name) __VA_ARGS__))
+#ifdef IEC_PRODUCTION_ACCESSORS
+#define __GET_LOCATED_BY_REF(name, ...)\
+	(&((*(name.value)) __VA_ARGS__))
+#else
 #define __GET_LOCATED_BY_REF(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : &((*(name.value)) __VA_ARGS__))
+#endif
 
 #define __GET_VAR_REF(name, ...)\
 	(&(name.value __VA_ARGS__))
@@ -122,15 +344,27 @@
 
 
 // variable setting macros
+#ifdef IEC_PRODUCTION_ACCESSORS
+#define __SET_VAR(prefix, name, suffix, new_value)\
+	prefix name.value suffix = new_value
+#define __SET_EXTERNAL(prefix, name, suffix, new_value)\
+	(*(prefix name.value)) suffix = new_value
+#else
 #define __SET_VAR(prefix, name, suffix, new_value)\
 	if (!(prefix name.flags & __IEC_FORCE_FLAG)) prefix name.value suffix = new_value
 #define __SET_EXTERNAL(prefix, name, suffix, new_value)\
 	{extern IEC_BYTE __IS_GLOBAL_##name##_FORCED(void);\
     if (!(prefix name.flags & __IEC_FORCE_FLAG || __IS_GLOBAL_##name##_FORCED()))\
 		(*(prefix name.value)) suffix = new_value;}
+#endif
 #define __SET_EXTERNAL_FB(prefix, name, suffix, new_value)\
 	__SET_VAR((*(prefix name)), suffix, new_value)
+#ifdef IEC_PRODUCTION_ACCESSORS
+#define __SET_LOCATED(prefix, name, suffix, new_value)\
+	*(prefix name.value) suffix = new_value
+#else
 #define __SET_LOCATED(prefix, name, suffix, new_value)\
 	if (!(prefix name.flags & __IEC_FORCE_FLAG)) *(prefix name.value) suffix = new_value
+#endif
 
 #endif //__ACCESSOR_H
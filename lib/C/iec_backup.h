@@ -0,0 +1,240 @@
+/*
+ * Incremental backup and restore of the internal PLC state.
+ *
+ * Included by the configuration file generated by iec2c with the '-O b' option, which
+ * then also defines (besides config_backup__() and config_restore__()):
+ *
+ *   int config_backup_delta__ (void **buffer, int *maxsize);
+ *   int config_restore_delta__(void **buffer, int *maxsize);
+ *
+ * config_backup_delta__() writes to the buffer only the blocks of the internal state that
+ * changed since the previous call (a delta). The first call (generation 0) writes all the blocks,
+ * i.e. the base image. To restore the state, the base image and then each of the following deltas
+ * are passed, in order, to config_restore_delta__(). Restoring a delta also brings the
+ * state of the incremental backup up to date, so the next backup continues the same sequence.
+ *
+ * Both functions work on the buffer as config_backup__() and config_restore__() do, and
+ * return 0 on success, or -1 if:
+ *   - backup : the buffer is too small (*maxsize returns negative). The sequence is then
+ *              restarted, i.e. the next call writes a new base image.
+ *   - restore: the delta is malformed, or does not follow the last restored delta. Nothing is restored.
+ *
+ * The internal state is the image written by config_backup__(), split into blocks of
+ * IEC_BACKUP_BLOCK_SIZE bytes (and at the boundaries of each variable). Each changed block is
+ * found by comparing it with a copy of the image as of the last delta (kept in RAM), and
+ * adjacent changed blocks are written out as a single record.
+ * Delta format (all fields in the byte order of the PLC):
+ *   header : uint32 magic, uint32 generation, uint32 image size
+ *   records: uint32 offset into the image, uint32 length, followed by length bytes
+ *            (in increasing order of offset, without overlaps)
+ *   end    : uint32 image size, uint32 0
+ *
+ * The runtime may also call:
+ *   void __iec_backup_delta_reset(void);    the next backup writes a new base image (e.g. after config_restore__())
+ *   int  __iec_backup_delta_max_size(void); size of the largest possible delta
+ */
+
+#ifndef _IEC_BACKUP_H
+#define _IEC_BACKUP_H
+
+#ifndef IEC_BACKUP_BLOCK_SIZE
+#define IEC_BACKUP_BLOCK_SIZE 64
+#endif
+
+#define __IEC_DELTA_MAGIC 0x494543DEUL
+
+
+/* defined in the generated configuration file */
+void config_backup__(void **buffer, int *maxsize);
+
+
+typedef struct {
+  char     *shadow;        /* the image as of the last delta. NULL: the next delta is a base image */
+  uint32_t  size;          /* of the image */
+  uint32_t  chunks;        /* number of blocks the image is split into */
+  uint32_t  generation;    /* of the last delta */
+  uint32_t  offset;        /* into the image, of the variable being handled */
+  int       full;          /* writing out a base image */
+  int       error;
+  /* backup: the last record written out, that may be extended */
+  char     *last;          /* NULL: none */
+  uint32_t  last_end;
+  /* restore: the record being applied */
+  uint32_t  rec_offset;
+  uint32_t  rec_length;
+} __iec_delta_state_t;
+
+static __iec_delta_state_t __iec_delta = {NULL, 0, 0, 0, 0, 0, 0, NULL, 0, 0, 0};
+
+
+void __iec_backup_delta_reset(void) {
+  free(__iec_delta.shadow);
+  __iec_delta.shadow = NULL;
+}
+
+int __iec_backup_delta_max_size(void) {
+  int size = 0;
+  if (NULL == __iec_delta.shadow) {config_backup__(NULL, &size); return 3*4 + -size + 2*2*4;}
+  /* each record is preceded by at least one unchanged block */
+  return 3*4 + __iec_delta.size + (__iec_delta.chunks/2 + 2) * 2*4;
+}
+
+
+static void __iec_delta_put(void **buffer, int *maxsize, const void *data, uint32_t size) {
+  if ((int)size <= *maxsize) {memcpy(*buffer, data, size); *buffer = (char *)*buffer + size;}
+  *maxsize -= size;
+}
+
+static int __iec_delta_get(void **buffer, int *maxsize, void *data, uint32_t size) {
+  if ((int)size > *maxsize) return 0;
+  memcpy(data, *buffer, size); *buffer = (char *)*buffer + size;
+  *maxsize -= size;
+  return 1;
+}
+
+
+/************/
+/*  Backup  */
+/************/
+
+static void __iec_backup_delta_beg(void **buffer, int *maxsize) {
+  uint32_t header[3];
+  __iec_delta.full = (NULL == __iec_delta.shadow);
+  if (__iec_delta.full) {
+    int size = 0;
+    config_backup__(NULL, &size);
+    __iec_delta.size       = -size;
+    __iec_delta.shadow     = (char *)malloc(__iec_delta.size + 1);
+    __iec_delta.generation = 0;
+  } else
+    __iec_delta.generation++;
+  __iec_delta.error  = (NULL == __iec_delta.shadow);
+  __iec_delta.offset = 0;
+  __iec_delta.chunks = 0;
+  __iec_delta.last   = NULL;
+  header[0] = __IEC_DELTA_MAGIC; header[1] = __iec_delta.generation; header[2] = __iec_delta.size;
+  __iec_delta_put(buffer, maxsize, header, sizeof(header));
+}
+
+static void __iec_backup_delta_add(void **buffer, int *maxsize, uint32_t offset, const char *data, uint32_t length) {
+  if ((NULL != __iec_delta.last) && (__iec_delta.last_end == offset) && ((int)length <= *maxsize)) {
+    /* extend the last record */
+    uint32_t last_length;
+    memcpy(&last_length, __iec_delta.last, sizeof(last_length));
+    last_length += length;
+    memcpy(__iec_delta.last, &last_length, sizeof(last_length));
+  } else {
+    uint32_t record[2];
+    record[0] = offset; record[1] = length;
+    __iec_delta_put(buffer, maxsize, record, sizeof(record));
+    __iec_delta.last = (*maxsize >= 0)? (char *)*buffer - sizeof(uint32_t) : NULL;
+  }
+  __iec_delta_put(buffer, maxsize, data, length);
+  __iec_delta.last_end = offset + length;
+}
+
+static void __iec_backup_delta_var(void *varptr, int varsize, void **buffer, int *maxsize) {
+  const char *var = (const char *)varptr;
+  uint32_t pos, len, offset;
+  if (__iec_delta.error) return;
+  for (pos = 0; pos < (uint32_t)varsize; pos += len) {
+    offset = __iec_delta.offset + pos;
+    len    = IEC_BACKUP_BLOCK_SIZE - offset % IEC_BACKUP_BLOCK_SIZE;
+    if (len > varsize - pos) len = varsize - pos;
+    __iec_delta.chunks++;
+    if (__iec_delta.full || (memcmp(__iec_delta.shadow + offset, var + pos, len) != 0)) {
+      memcpy(__iec_delta.shadow + offset, var + pos, len);
+      __iec_backup_delta_add(buffer, maxsize, offset, var + pos, len);
+    }
+  }
+  __iec_delta.offset += varsize;
+}
+
+static int __iec_backup_delta_end(void **buffer, int *maxsize) {
+  uint32_t record[2];
+  record[0] = __iec_delta.size; record[1] = 0;
+  __iec_delta_put(buffer, maxsize, record, sizeof(record));
+  if (__iec_delta.error || (*maxsize < 0)) {
+    /* the shadow no longer matches the deltas written out */
+    __iec_backup_delta_reset();
+    return -1;
+  }
+  return 0;
+}
+
+
+/*************/
+/*  Restore  */
+/*************/
+
+static int __iec_restore_delta_next(void **buffer, int *maxsize) {
+  uint32_t record[2];
+  if (!__iec_delta_get(buffer, maxsize, record, sizeof(record))) return 0;
+  __iec_delta.rec_offset = record[0];
+  __iec_delta.rec_length = record[1];
+  return 1;
+}
+
+/* Check the whole delta before anything is restored */
+static void __iec_restore_delta_beg(void **buffer, int *maxsize) {
+  uint32_t header[3], end = 0;
+  void *pos = *buffer;
+  int   left = *maxsize;
+  int   size = 0;
+
+  config_backup__(NULL, &size);
+  __iec_delta.error = 1;
+  if (!__iec_delta_get(&pos, &left, header, sizeof(header))) return;
+  if ((header[0] != __IEC_DELTA_MAGIC) || (header[2] != (uint32_t)-size)) return;
+  if ((header[1] != 0) && ((NULL == __iec_delta.shadow) || (header[1] != __iec_delta.generation + 1))) return;
+  do {
+    if (!__iec_restore_delta_next(&pos, &left)) return;
+    if ((__iec_delta.rec_offset < end) || (__iec_delta.rec_offset > header[2])) return;
+    if (__iec_delta.rec_length > header[2] - __iec_delta.rec_offset) return;
+    if ((int)__iec_delta.rec_length > left) return;
+    pos   = (char *)pos + __iec_delta.rec_length;
+    left -= __iec_delta.rec_length;
+    end   = __iec_delta.rec_offset + __iec_delta.rec_length;
+  } while (__iec_delta.rec_length > 0);
+
+  if (NULL == __iec_delta.shadow) {
+    __iec_delta.size   = header[2];
+    __iec_delta.shadow = (char *)malloc(__iec_delta.size + 1);
+    if (NULL == __iec_delta.shadow) return;
+  }
+  __iec_delta.error      = 0;
+  __iec_delta.generation = header[1];
+  __iec_delta.offset     = 0;
+  __iec_delta_get(buffer, maxsize, header, sizeof(header));
+  __iec_restore_delta_next(buffer, maxsize);
+}
+
+static void __iec_restore_delta_var(void *varptr, int varsize, void **buffer, int *maxsize) {
+  char *var = (char *)varptr;
+  uint32_t beg = __iec_delta.offset, end = __iec_delta.offset + varsize;
+  uint32_t from, to;
+  if (__iec_delta.error) return;
+  while ((__iec_delta.rec_length > 0) && (__iec_delta.rec_offset < end)) {
+    from = (__iec_delta.rec_offset > beg)? __iec_delta.rec_offset : beg;
+    to   = __iec_delta.rec_offset + __iec_delta.rec_length;
+    if (to > end) to = end;
+    if (from < to) {
+      memcpy(var + (from - beg), (char *)*buffer + (from - __iec_delta.rec_offset), to - from);
+      memcpy(__iec_delta.shadow + from, var + (from - beg), to - from);
+    }
+    if (__iec_delta.rec_offset + __iec_delta.rec_length > end) break;
+    /* done with this record */
+    *buffer   = (char *)*buffer + __iec_delta.rec_length;
+    *maxsize -= __iec_delta.rec_length;
+    __iec_restore_delta_next(buffer, maxsize);
+  }
+  __iec_delta.offset = end;
+}
+
+static int __iec_restore_delta_end(void **buffer, int *maxsize) {
+  (void)buffer; (void)maxsize;
+  return __iec_delta.error? -1 : 0;
+}
+
+
+#endif /* _IEC_BACKUP_H */
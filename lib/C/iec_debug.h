@@ -0,0 +1,141 @@
+/*
+ * Compiled debug symbol index.
+ *
+ * With the '-O d' option iec2c lists the variables of VARIABLES.csv (with the same numbers) in a
+ * table of entries, so a debugger may find and read them without parsing any text:
+ *
+ *   - each generated configuration and resource file ends with the entries of its own variables
+ *     (<DOMAIN>__debug_entries[]);
+ *   - DEBUG_INDEX.c holds __iec_debug_entries[] (the entry of each variable, by number), the names
+ *     of the variables, and a perfect hash table over those names;
+ *   - DEBUG_INDEX.bin holds the same names and hash table (and the type and class of each variable),
+ *     for a debugger that runs outside the PLC.
+ *
+ * The runtime (linked with DEBUG_INDEX.c) may then call:
+ *   int   __iec_debug_find (const char *name);      number of the variable (e.g. "CONFIG.RES1.INST0.X",
+ *                                                   case insensitive), or -1 if not found
+ *   void *__iec_debug_value(unsigned int number);   address of the current value, or NULL
+ *   int   __iec_debug_read (const unsigned int *numbers, int count, void *buffer, int maxsize);
+ *                                                   copy the values of the variables, one after the other,
+ *                                                   into the buffer. Returns the number of bytes copied,
+ *                                                   or -1 (nothing copied) if any variable is not available,
+ *                                                   or the values do not fit in maxsize bytes.
+ * NOTE: the values read are those the program works on, i.e. not the forced value of a located
+ *       or external variable (__IEC_xxx_p.fvalue).
+ *
+ * Perfect hash: the 64 bit FNV-1a hash h of the name (in upper case) selects a bucket,
+ * (h >> 32) % buckets. The displacement d of the bucket then selects the slot,
+ * __iec_debug_mix((uint32_t)h, d) % slot_count, which holds the number of the variable (or 0xFFFFFFFF).
+ * A name is found with a single probe, and a name that is not in the index with a single string compare.
+ * Variables with the same name as a previous one (e.g. two SFC transitions between the same steps)
+ * keep their number, but are not in the hash table.
+ *
+ * DEBUG_INDEX.bin (all fields uint32 in the byte order of the compiler's host, unless noted):
+ *   header   : char magic[8] = "IECDBGI1", count, buckets, slot_count, size of the names
+ *   disp     : buckets displacements
+ *   slots    : slot_count variable numbers
+ *   variables: count x {uint32 offset of the name, uint16 type (__IEC_types_enum), uint8 class, uint8 0}
+ *   names    : the names, each terminated by '\0'
+ */
+
+#ifndef _IEC_DEBUG_H
+#define _IEC_DEBUG_H
+
+#include <string.h>
+#include "iec_types_all.h"
+
+/* The class of each variable, as in VARIABLES.csv */
+typedef enum {
+  __IEC_DEBUG_VAR_CLASS = 0,  /* __IEC_xxx_t */
+  __IEC_DEBUG_EXT_CLASS,      /* __IEC_xxx_p */
+  __IEC_DEBUG_IN_CLASS,       /* __IEC_xxx_p */
+  __IEC_DEBUG_OUT_CLASS,      /* __IEC_xxx_p */
+  __IEC_DEBUG_MEM_CLASS,      /* __IEC_xxx_p */
+  __IEC_DEBUG_FB_CLASS,       /* the function block instance */
+  __IEC_DEBUG_EXT_FB_CLASS    /* pointer to the function block instance */
+} __IEC_DEBUG_CLASS_t;
+
+typedef struct {
+  void           *ptr;     /* the variable. NULL: not available */
+  unsigned int    size;    /* of its value */
+  unsigned short  type;    /* __IEC_types_enum */
+  unsigned char   vclass;  /* __IEC_DEBUG_CLASS_t */
+} __IEC_DEBUG_ENTRY_t;
+
+/* the entries, used by the generated code */
+#define __IEC_DEBUG_VAR(var, type)         {(void *)&(var), sizeof((var).value),   type, __IEC_DEBUG_VAR_CLASS}
+#define __IEC_DEBUG_REF(var, type, vclass) {(void *)&(var), sizeof(*((var).value)), type, vclass}
+#define __IEC_DEBUG_FB(var)                {(void *)&(var), sizeof(var),           UNKNOWN_ENUM, __IEC_DEBUG_FB_CLASS}
+#define __IEC_DEBUG_EXT_FB(var)            {(void *)&(var), sizeof(*(var)),        UNKNOWN_ENUM, __IEC_DEBUG_EXT_FB_CLASS}
+#define __IEC_DEBUG_NONE(vclass)           {NULL, 0, UNKNOWN_ENUM, vclass}
+
+#define __IEC_DEBUG_NO_SLOT 0xFFFFFFFFUL
+
+
+/* defined in DEBUG_INDEX.c */
+extern const unsigned int               __iec_debug_count;
+extern const unsigned int               __iec_debug_buckets;
+extern const unsigned int               __iec_debug_slot_count;
+extern const uint32_t                   __iec_debug_disp[];
+extern const uint32_t                   __iec_debug_slots[];
+extern const char                *const __iec_debug_names[];
+extern const __IEC_DEBUG_ENTRY_t *const __iec_debug_entries[];
+
+
+static inline char __iec_debug_upper(char c) {
+  return ((c >= 'a') && (c <= 'z'))? c - 'a' + 'A' : c;
+}
+
+static inline uint64_t __iec_debug_hash(const char *name) {
+  uint64_t h = 14695981039346656037ULL;
+  for (; *name != '\0'; name++) {h ^= (unsigned char)__iec_debug_upper(*name); h *= 1099511628211ULL;}
+  return h;
+}
+
+static inline uint32_t __iec_debug_mix(uint32_t x, uint32_t d) {
+  x ^= d * 0x9E3779B9UL;
+  x ^= x >> 16; x *= 0x85EBCA6BUL;
+  x ^= x >> 13; x *= 0xC2B2AE35UL;
+  x ^= x >> 16;
+  return x;
+}
+
+static inline int __iec_debug_find(const char *name) {
+  uint64_t h = __iec_debug_hash(name);
+  uint32_t n;
+  const char *s;
+  if (0 == __iec_debug_count) return -1;
+  n = __iec_debug_slots[__iec_debug_mix((uint32_t)h, __iec_debug_disp[(uint32_t)(h >> 32) % __iec_debug_buckets]) % __iec_debug_slot_count];
+  if (n >= __iec_debug_count) return -1;
+  for (s = __iec_debug_names[n]; (*s != '\0') && (*s == __iec_debug_upper(*name)); s++, name++);
+  return (*s == __iec_debug_upper(*name))? (int)n : -1;
+}
+
+static inline void *__iec_debug_value(unsigned int number) {
+  const __IEC_DEBUG_ENTRY_t *entry;
+  if (number >= __iec_debug_count) return NULL;
+  entry = __iec_debug_entries[number];
+  if (NULL == entry->ptr) return NULL;
+  switch (entry->vclass) {
+    case __IEC_DEBUG_VAR_CLASS:
+    case __IEC_DEBUG_FB_CLASS: return entry->ptr;
+    /* the value pointer is the first field of __IEC_xxx_p */
+    default                  : return *(void **)entry->ptr;
+  }
+}
+
+static inline int __iec_debug_read(const unsigned int *numbers, int count, void *buffer, int maxsize) {
+  int i, size = 0;
+  for (i = 0; i < count; i++) {
+    if ((NULL == __iec_debug_value(numbers[i])) || ((int)__iec_debug_entries[numbers[i]]->size > maxsize - size)) return -1;
+    size += __iec_debug_entries[numbers[i]]->size;
+  }
+  for (i = 0, size = 0; i < count; i++) {
+    memcpy((char *)buffer + size, __iec_debug_value(numbers[i]), __iec_debug_entries[numbers[i]]->size);
+    size += __iec_debug_entries[numbers[i]]->size;
+  }
+  return size;
+}
+
+
+#endif /* _IEC_DEBUG_H */
@@ -0,0 +1,101 @@
+/*
+ * Cycle time instrumentation of the POUs.
+ *
+ * Included (by POUS.h) in the code generated by iec2c with the '-O c' option, which then records,
+ * in a counter of type __IEC_PROFILE_t:
+ *   - each call to the body of each function block and program type (<POU>__profile),
+ *   - each call of each program instance by its resource (<RESOURCE>__<INSTANCE>__profile),
+ *   - each call to the run function of each resource (<RESOURCE>__profile).
+ * Without '-O c' none of this is generated, i.e. it costs nothing.
+ *
+ * The configuration file lists all the counters in __iec_profile_table[] (terminated by NULL),
+ * for the runtime to export them. The runtime may also call __iec_profile_reset().
+ *
+ * NOTES:
+ *   - the times include those of the POUs called from the one being timed;
+ *   - the function blocks of the standard library (TON, CTU, ...) are not instrumented;
+ *   - the body of a function block with EN = FALSE is not timed (nor counted);
+ *   - with resource threads ('-O r'), two units that call the same POU type at the same time
+ *     may lose some of the updates to its counter (the counters are not atomic).
+ *
+ * The clock is clock_gettime(CLOCK_MONOTONIC_RAW), i.e. times are in nanoseconds. When the runtime
+ * is compiled with IEC_PROFILE_RDTSC defined (x86 only), it is the time stamp counter, in TSC ticks.
+ *
+ * Overhead per instrumented call, measured with tests/benchmark/profile_bench.c (make profile)
+ * on x86-64 (Linux 6.x, in a virtual machine, gcc -O2), against ~2.5 ns for the call itself:
+ *   clock_gettime(CLOCK_MONOTONIC_RAW) : ~56 ns
+ *   rdtsc (IEC_PROFILE_RDTSC)          : ~31 ns
+ * This is paid by every call to a function block (or program), so it mostly shows in
+ * programs that call many small function blocks each cycle. tests/benchmark/accessors.sh
+ * also compares the cycle time of a whole configuration compiled with and without '-O c'.
+ */
+
+#ifndef _IEC_PROFILE_H
+#define _IEC_PROFILE_H
+
+#include <time.h>
+#ifdef IEC_PROFILE_RDTSC
+#include <x86intrin.h>
+#endif
+
+
+typedef struct {
+  const char         *name;   /* of the POU type, resource, or program instance (<RESOURCE>.<INSTANCE>) */
+  unsigned long long  count;  /* of calls */
+  unsigned long long  min;    /* shortest call (~0ULL if never called) */
+  unsigned long long  max;    /* longest call */
+  unsigned long long  total;  /* of all the calls */
+} __IEC_PROFILE_t;
+
+/* defined in the generated configuration file */
+extern __IEC_PROFILE_t *const __iec_profile_table[];
+
+
+static inline unsigned long long __iec_profile_clock(void) {
+#ifdef IEC_PROFILE_RDTSC
+  return __rdtsc();
+#else
+  struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+  clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+static inline void __iec_profile_add(__IEC_PROFILE_t *counter, unsigned long long time) {
+  counter->count++;
+  counter->total += time;
+  if (time < counter->min) counter->min = time;
+  if (time > counter->max) counter->max = time;
+}
+
+static inline void __iec_profile_reset(void) {
+  __IEC_PROFILE_t *const *counter;
+  for (counter = __iec_profile_table; NULL != *counter; counter++) {
+    (*counter)->count = 0;
+    (*counter)->min   = ~0ULL;
+    (*counter)->max   = 0;
+    (*counter)->total = 0;
+  }
+}
+
+
+/* the counters */
+#define __DECLARE_PROFILE(name, text)\
+  __IEC_PROFILE_t name##__profile = {text, 0, ~0ULL, 0, 0};
+#define __DECLARE_EXTERN_PROFILE(name)\
+  extern __IEC_PROFILE_t name##__profile;
+
+/* time the rest of a function body (up to __IEC_PROFILE_END), or a single call */
+#define __IEC_PROFILE_BEGIN\
+  unsigned long long __iec_profile_start = __iec_profile_clock();
+#define __IEC_PROFILE_END(name)\
+  __iec_profile_add(&name##__profile, __iec_profile_clock() - __iec_profile_start);
+#define __IEC_PROFILE_CALL(name, call)\
+  {__IEC_PROFILE_BEGIN call; __IEC_PROFILE_END(name)}
+
+
+#endif /* _IEC_PROFILE_H */
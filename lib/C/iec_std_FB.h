@@ -1431,7 +1431,7 @@ __SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
     __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, (UINT)2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
@@ -1496,7 +1496,7 @@ __SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
       __SET_VAR(data__->,STATE,,0);
     } else if ((__GET_VAR(data__->STATE,) == 1)) {
-      if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+      if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, (UINT)2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
         __SET_VAR(data__->,STATE,,2);
         __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
         __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
@@ -1556,7 +1556,7 @@ __SET_VAR(data__->,CURRENT_TIME,,__CURRENT_TIME)
       __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
       __SET_VAR(data__->,STATE,,0);
     } else if ((__GET_VAR(data__->STATE,) == 1)) {
-      if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+      if (LE_TIME(__BOOL_LITERAL(TRUE), NULL, (UINT)2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
         __SET_VAR(data__->,STATE,,2);
         __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
       } else {
@@ -1787,7 +1787,7 @@ static void RAMP_body__(RAMP *data__) {
 
   __SET_VAR(data__->,BUSY,,__GET_VAR(data__->RUN,));
   if (__GET_VAR(data__->RUN,)) {
-    if (GE_TIME(__BOOL_LITERAL(TRUE), NULL, 2, __GET_VAR(data__->T,), __GET_VAR(data__->TR,))) {
+    if (GE_TIME(__BOOL_LITERAL(TRUE), NULL, (UINT)2, __GET_VAR(data__->T,), __GET_VAR(data__->TR,))) {
       __SET_VAR(data__->,BUSY,,0);
       __SET_VAR(data__->,XOUT,,__GET_VAR(data__->X1,));
     } else {
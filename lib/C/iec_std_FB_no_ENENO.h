@@ -1166,7 +1166,7 @@ if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __G
   __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
   __SET_VAR(data__->,START_TIME,,__GET_VAR(data__->CURRENT_TIME,));
 } else if ((__GET_VAR(data__->STATE,) == 1)) {
-  if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+  if (LE_TIME((UINT)2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
     __SET_VAR(data__->,STATE,,2);
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
     __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
@@ -1221,7 +1221,7 @@ if ((((__GET_VAR(data__->STATE,) == 0) && !(__GET_VAR(data__->PREV_IN,))) && __G
     __SET_VAR(data__->,Q,,__BOOL_LITERAL(FALSE));
     __SET_VAR(data__->,STATE,,0);
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    if (LE_TIME((UINT)2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,Q,,__BOOL_LITERAL(TRUE));
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
@@ -1271,7 +1271,7 @@ if ((((__GET_VAR(data__->STATE,) == 0) && __GET_VAR(data__->PREV_IN,)) && !(__GE
     __SET_VAR(data__->,ET,,__time_to_timespec(1, 0, 0, 0, 0, 0));
     __SET_VAR(data__->,STATE,,0);
   } else if ((__GET_VAR(data__->STATE,) == 1)) {
-    if (LE_TIME(2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
+    if (LE_TIME((UINT)2, __time_add(__GET_VAR(data__->START_TIME,), __GET_VAR(data__->PT,)), __GET_VAR(data__->CURRENT_TIME,))) {
       __SET_VAR(data__->,STATE,,2);
       __SET_VAR(data__->,ET,,__GET_VAR(data__->PT,));
     } else {
@@ -1448,7 +1448,7 @@ static void RAMP_body__(RAMP *data__) {
 
 __SET_VAR(data__->,BUSY,,__GET_VAR(data__->RUN,));
 if (__GET_VAR(data__->RUN,)) {
-  if (GE_TIME(2, __GET_VAR(data__->T,), __GET_VAR(data__->TR,))) {
+  if (GE_TIME((UINT)2, __GET_VAR(data__->T,), __GET_VAR(data__->TR,))) {
     __SET_VAR(data__->,BUSY,,0);
     __SET_VAR(data__->,XOUT,,__GET_VAR(data__->X1,));
   } else {
@@ -145,7 +145,7 @@ __ANY_NBIT(__convert_num_to_bool)
 #define __convert_time_to_bool(TYPENAME) \
 static inline BOOL TYPENAME##_TO_BOOL(EN_ENO_PARAMS TYPENAME op){\
   TEST_EN(BOOL)\
-  return op.tv_sec == 0 && op.tv_nsec == 0 ? 0 : 1;\
+  return __time_sec(op) == 0 && __time_nsec(op) == 0 ? 0 : 1;\
 }
 __convert_time_to_bool(TIME)
 __ANY_DATE(__convert_time_to_bool)
@@ -619,6 +619,112 @@ __ANY_REAL(__atan)
 	}								\
 									\
 
+/* NOTE: Like the arithmetic based functions (see the note before __arith_expand() above), the
+ *       extensible MAX, MIN and XOR (of BOOL) functions have 8 optimized versions (for when they are
+ *       called with 1 to 8 INput parameters), and an extra non-optimized version for every other case.
+ *       Their standard names are also declared as macros (using ARITH_OPERATION__TYPE__TYPE), which
+ *       choose at compilation time the correct version to call.
+ *
+ *       The result is computed by combining the parameters from left to right, using
+ *           static inline TYPENAME fname__step(TYPENAME op1, TYPENAME op2)
+ *       which must be declared before using __fold_expand(fname, TYPENAME).
+ */
+#define __fold_expand(fname, TYPENAME)				\
+								\
+	static inline TYPENAME fname##1(EN_ENO_PARAMS			\
+					TYPENAME op1) {			\
+		TEST_EN(TYPENAME);					\
+		return op1;	\
+	}								\
+								\
+	static inline TYPENAME fname##2(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2) {			\
+		TEST_EN(TYPENAME);					\
+		return fname##__step(op1, op2);	\
+	}								\
+								\
+	static inline TYPENAME fname##3(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3) {			\
+		TEST_EN(TYPENAME);					\
+		return fname##__step(fname##__step(op1, op2), op3);	\
+	}								\
+								\
+	static inline TYPENAME fname##4(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4) {			\
+		TEST_EN(TYPENAME);					\
+		return fname##__step(fname##__step(fname##__step(op1, op2), op3), op4);	\
+	}								\
+								\
+	static inline TYPENAME fname##5(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4,			\
+					TYPENAME op5) {			\
+		TEST_EN(TYPENAME);					\
+		return fname##__step(fname##__step(fname##__step(fname##__step(op1, op2), op3), op4), op5);	\
+	}								\
+								\
+	static inline TYPENAME fname##6(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4,			\
+					TYPENAME op5,			\
+					TYPENAME op6) {			\
+		TEST_EN(TYPENAME);					\
+		return fname##__step(fname##__step(fname##__step(fname##__step(fname##__step(op1, op2), op3), op4), op5), op6);	\
+	}								\
+								\
+	static inline TYPENAME fname##7(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4,			\
+					TYPENAME op5,			\
+					TYPENAME op6,			\
+					TYPENAME op7) {			\
+		TEST_EN(TYPENAME);					\
+		return fname##__step(fname##__step(fname##__step(fname##__step(fname##__step(fname##__step(op1, op2), op3), op4), op5), op6), op7);	\
+	}								\
+								\
+	static inline TYPENAME fname##8(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4,			\
+					TYPENAME op5,			\
+					TYPENAME op6,			\
+					TYPENAME op7,			\
+					TYPENAME op8) {			\
+		TEST_EN(TYPENAME);					\
+		return fname##__step(fname##__step(fname##__step(fname##__step(fname##__step(fname##__step(fname##__step(op1, op2), op3), op4), op5), op6), op7), op8);	\
+	}								\
+								\
+	static inline TYPENAME fname##_VAR(EN_ENO_PARAMS		\
+					UINT param_count,		\
+					TYPENAME op1, ...){		\
+		va_list ap;						\
+		UINT i;							\
+		TEST_EN(TYPENAME)					\
+									\
+		va_start (ap, op1);         /* Initialize the argument list.  */ \
+									\
+		for (i = 0; i < param_count - 1; i++){			\
+			op1 = fname##__step(op1, va_arg (ap, VA_ARGS_##TYPENAME)); \
+		}							\
+									\
+		va_end (ap);                  /* Clean up.  */		\
+		return op1;						\
+	}								\
+									\
+
 /* macros needed for #if-like behaviour inside of macro */
 #define ARITH_OPERATION_COND_IGNORE(...)
 #define ARITH_OPERATION_COND_IDENT(...) __VA_ARGS__
@@ -642,22 +748,35 @@ __ANY_REAL(__atan)
  */
 #define CLEAR_TYPECAST(X)
 #define MAX_INLINE_PARAM_COUNT 8
+/* DISABLE_FIXED_ARITY_FUNCTIONS: always call the non-optimized version, whatever the number of
+ * input parameters (only used to measure the gain of the optimized versions, see tests/benchmark).
+ */
 #ifdef DISABLE_EN_ENO_PARAMETERS
 
+#ifdef DISABLE_FIXED_ARITY_FUNCTIONS
+#define ARITH_OPERATION_CALL__(FNAME, PARAM_COUNT, ...)			\
+	(FNAME##_VAR(PARAM_COUNT, __VA_ARGS__))
+#else
 #define ARITH_OPERATION_CALL__(FNAME, PARAM_COUNT, ...)			\
 	ARITH_OPERATION_COND(ARITH_OPERATION_LE(PARAM_COUNT, MAX_INLINE_PARAM_COUNT)) \
 	(FNAME##_VAR(PARAM_COUNT, __VA_ARGS__))				\
 	(FNAME##PARAM_COUNT(      __VA_ARGS__))
+#endif
 
 #define ARITH_OPERATION_CALL_( FNAME, PARAM_COUNT, ...)    ARITH_OPERATION_CALL__(FNAME, PARAM_COUNT, __VA_ARGS__)
 #define ARITH_OPERATION_CALL(  FNAME, PARAM_COUNT, ...)    ARITH_OPERATION_CALL_( FNAME, CLEAR_TYPECAST PARAM_COUNT, __VA_ARGS__)
 
 #else
 
+#ifdef DISABLE_FIXED_ARITY_FUNCTIONS
+#define ARITH_OPERATION_CALL__(EN, ENO, FNAME, PARAM_COUNT, ...)	\
+	(FNAME##_VAR(       (EN), (ENO), PARAM_COUNT, __VA_ARGS__))
+#else
 #define ARITH_OPERATION_CALL__(EN, ENO, FNAME, PARAM_COUNT, ...)	\
 	ARITH_OPERATION_COND(ARITH_OPERATION_LE(PARAM_COUNT, MAX_INLINE_PARAM_COUNT)) \
 	(FNAME##_VAR(       (EN), (ENO), PARAM_COUNT, __VA_ARGS__))	\
 	(FNAME##PARAM_COUNT((EN), (ENO), __VA_ARGS__))
+#endif
 
 
 #define ARITH_OPERATION_CALL_( EN, ENO, FNAME, PARAM_COUNT, ...)    ARITH_OPERATION_CALL__(EN, ENO, FNAME, PARAM_COUNT, __VA_ARGS__)
@@ -1014,25 +1133,16 @@ __ANY_NBIT(__iec_)
   /*     XOR    */
   /**************/
 #define __xorbool_expand(fname) \
-static inline BOOL fname(EN_ENO_PARAMS UINT param_count, BOOL op1, ...){ \
-  va_list ap; \
-  UINT i; \
-  TEST_EN(BOOL) \
-\
-  va_start (ap, op1);         /* Initialize the argument list.  */ \
-\
-  for (i = 0; i < param_count - 1; i++){ \
-    BOOL tmp = va_arg (ap, VA_ARGS_BOOL); \
-    op1 = (op1 && !tmp) || (!op1 && tmp); \
-  } \
-\
-  va_end (ap);                  /* Clean up.  */ \
-  return op1; \
-}
+static inline BOOL fname##__step(BOOL op1, BOOL tmp) {return (op1 && !tmp) || (!op1 && tmp);}\
+__fold_expand(fname, BOOL)
 
 __xorbool_expand(XOR_BOOL) /* The explicitly typed standard functions */
 __xorbool_expand(XOR__BOOL__BOOL) /* Overloaded function */
 
+#define XOR_BOOL(...)        ARITH_OPERATION__TYPE__TYPE(EN_PFX, XOR_BOOL,        __VA_ARGS__)
+#define XOR__BOOL__BOOL(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, XOR__BOOL__BOOL, __VA_ARGS__)
+
+
 #define __iec_(TYPENAME) \
 __arith_expand(XOR_##TYPENAME, TYPENAME, ^) /* The explicitly typed standard functions */\
 __arith_expand(XOR__##TYPENAME##__##TYPENAME, TYPENAME, ^) /* Overloaded function */
@@ -1129,21 +1239,8 @@ __ANY(__iec_)
     /**************/
 
 #define __extrem_(fname,TYPENAME, COND) \
-static inline TYPENAME fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...){\
-  va_list ap;\
-  UINT i;\
-  TEST_EN(TYPENAME)\
-  \
-  va_start (ap, op1);         /* Initialize the argument list.  */\
-  \
-  for (i = 0; i < param_count - 1; i++){\
-    TYPENAME tmp = va_arg (ap, VA_ARGS_##TYPENAME);\
-    op1 = COND ? tmp : op1;\
-  }\
-  \
-  va_end (ap);                  /* Clean up.  */\
-  return op1;\
-}
+static inline TYPENAME fname##__step(TYPENAME op1, TYPENAME tmp) {return COND ? tmp : op1;}\
+__fold_expand(fname, TYPENAME)
 
 /* Max for numerical data types */	
 #define __iec_(TYPENAME) \
@@ -1167,6 +1264,67 @@ __iec_(TIME)
 __extrem_(MAX_STRING, STRING, __STR_CMP(op1,tmp) < 0) /* The explicitly typed standard functions */
 __extrem_(MAX__STRING__STRING, STRING, __STR_CMP(op1,tmp) < 0) /* Overloaded function */
 
+#define MAX_BYTE(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_BYTE,            __VA_ARGS__)
+#define MAX__BYTE__BYTE(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__BYTE__BYTE,     __VA_ARGS__)
+
+#define MAX_WORD(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_WORD,            __VA_ARGS__)
+#define MAX__WORD__WORD(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__WORD__WORD,     __VA_ARGS__)
+
+#define MAX_DWORD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_DWORD,           __VA_ARGS__)
+#define MAX__DWORD__DWORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__DWORD__DWORD,   __VA_ARGS__)
+
+#define MAX_LWORD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_LWORD,           __VA_ARGS__)
+#define MAX__LWORD__LWORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__LWORD__LWORD,   __VA_ARGS__)
+
+#define MAX_BOOL(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_BOOL,            __VA_ARGS__)
+#define MAX__BOOL__BOOL(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__BOOL__BOOL,     __VA_ARGS__)
+
+#define MAX_REAL(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_REAL,            __VA_ARGS__)
+#define MAX__REAL__REAL(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__REAL__REAL,     __VA_ARGS__)
+
+#define MAX_LREAL(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_LREAL,           __VA_ARGS__)
+#define MAX__LREAL__LREAL(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__LREAL__LREAL,   __VA_ARGS__)
+
+#define MAX_SINT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_SINT,            __VA_ARGS__)
+#define MAX__SINT__SINT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__SINT__SINT,     __VA_ARGS__)
+
+#define MAX_INT(...)             ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_INT,             __VA_ARGS__)
+#define MAX__INT__INT(...)       ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__INT__INT,       __VA_ARGS__)
+
+#define MAX_DINT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_DINT,            __VA_ARGS__)
+#define MAX__DINT__DINT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__DINT__DINT,     __VA_ARGS__)
+
+#define MAX_LINT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_LINT,            __VA_ARGS__)
+#define MAX__LINT__LINT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__LINT__LINT,     __VA_ARGS__)
+
+#define MAX_USINT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_USINT,           __VA_ARGS__)
+#define MAX__USINT__USINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__USINT__USINT,   __VA_ARGS__)
+
+#define MAX_UINT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_UINT,            __VA_ARGS__)
+#define MAX__UINT__UINT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__UINT__UINT,     __VA_ARGS__)
+
+#define MAX_UDINT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_UDINT,           __VA_ARGS__)
+#define MAX__UDINT__UDINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__UDINT__UDINT,   __VA_ARGS__)
+
+#define MAX_ULINT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_ULINT,           __VA_ARGS__)
+#define MAX__ULINT__ULINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__ULINT__ULINT,   __VA_ARGS__)
+
+#define MAX_DATE(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_DATE,            __VA_ARGS__)
+#define MAX__DATE__DATE(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__DATE__DATE,     __VA_ARGS__)
+
+#define MAX_TOD(...)             ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_TOD,             __VA_ARGS__)
+#define MAX__TOD__TOD(...)       ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__TOD__TOD,       __VA_ARGS__)
+
+#define MAX_DT(...)              ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_DT,              __VA_ARGS__)
+#define MAX__DT__DT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__DT__DT,         __VA_ARGS__)
+
+#define MAX_TIME(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_TIME,            __VA_ARGS__)
+#define MAX__TIME__TIME(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__TIME__TIME,     __VA_ARGS__)
+
+#define MAX_STRING(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX_STRING,          __VA_ARGS__)
+#define MAX__STRING__STRING(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, MAX__STRING__STRING, __VA_ARGS__)
+
+
     /**************/
     /*     MIN    */
     /**************/
@@ -1190,6 +1348,64 @@ __iec_(TIME)
 __extrem_(MIN_STRING, STRING, __STR_CMP(op1,tmp) > 0) /* The explicitly typed standard functions */
 __extrem_(MIN__STRING__STRING, STRING, __STR_CMP(op1,tmp) > 0) /* Overloaded function */
 
+#define MIN_BYTE(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_BYTE,            __VA_ARGS__)
+#define MIN__BYTE__BYTE(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__BYTE__BYTE,     __VA_ARGS__)
+
+#define MIN_WORD(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_WORD,            __VA_ARGS__)
+#define MIN__WORD__WORD(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__WORD__WORD,     __VA_ARGS__)
+
+#define MIN_DWORD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_DWORD,           __VA_ARGS__)
+#define MIN__DWORD__DWORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__DWORD__DWORD,   __VA_ARGS__)
+
+#define MIN_LWORD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_LWORD,           __VA_ARGS__)
+#define MIN__LWORD__LWORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__LWORD__LWORD,   __VA_ARGS__)
+
+#define MIN_REAL(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_REAL,            __VA_ARGS__)
+#define MIN__REAL__REAL(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__REAL__REAL,     __VA_ARGS__)
+
+#define MIN_LREAL(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_LREAL,           __VA_ARGS__)
+#define MIN__LREAL__LREAL(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__LREAL__LREAL,   __VA_ARGS__)
+
+#define MIN_SINT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_SINT,            __VA_ARGS__)
+#define MIN__SINT__SINT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__SINT__SINT,     __VA_ARGS__)
+
+#define MIN_INT(...)             ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_INT,             __VA_ARGS__)
+#define MIN__INT__INT(...)       ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__INT__INT,       __VA_ARGS__)
+
+#define MIN_DINT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_DINT,            __VA_ARGS__)
+#define MIN__DINT__DINT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__DINT__DINT,     __VA_ARGS__)
+
+#define MIN_LINT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_LINT,            __VA_ARGS__)
+#define MIN__LINT__LINT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__LINT__LINT,     __VA_ARGS__)
+
+#define MIN_USINT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_USINT,           __VA_ARGS__)
+#define MIN__USINT__USINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__USINT__USINT,   __VA_ARGS__)
+
+#define MIN_UINT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_UINT,            __VA_ARGS__)
+#define MIN__UINT__UINT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__UINT__UINT,     __VA_ARGS__)
+
+#define MIN_UDINT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_UDINT,           __VA_ARGS__)
+#define MIN__UDINT__UDINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__UDINT__UDINT,   __VA_ARGS__)
+
+#define MIN_ULINT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_ULINT,           __VA_ARGS__)
+#define MIN__ULINT__ULINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__ULINT__ULINT,   __VA_ARGS__)
+
+#define MIN_DATE(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_DATE,            __VA_ARGS__)
+#define MIN__DATE__DATE(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__DATE__DATE,     __VA_ARGS__)
+
+#define MIN_TOD(...)             ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_TOD,             __VA_ARGS__)
+#define MIN__TOD__TOD(...)       ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__TOD__TOD,       __VA_ARGS__)
+
+#define MIN_DT(...)              ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_DT,              __VA_ARGS__)
+#define MIN__DT__DT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__DT__DT,         __VA_ARGS__)
+
+#define MIN_TIME(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_TIME,            __VA_ARGS__)
+#define MIN__TIME__TIME(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__TIME__TIME,     __VA_ARGS__)
+
+#define MIN_STRING(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN_STRING,          __VA_ARGS__)
+#define MIN__STRING__STRING(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, MIN__STRING__STRING, __VA_ARGS__)
+
+
     /**************/
     /*   LIMIT    */
     /**************/
@@ -1287,30 +1503,120 @@ __ANY(__in1_anyint_)
 /***   Standard comparison functions    ***/
 /******************************************/
 
+/* NOTE: The extensible comparison functions (GT, GE, EQ, LE, LT) have 8 optimized versions
+ *       (for when they are called with 1 to 8 INput parameters) and an extra non-optimized version
+ *       for every other case, just like the arithmetic based functions (see __arith_expand() above).
+ *       The result is TRUE when every pair of consecutive parameters satisfies
+ *           static inline BOOL fname__step(TYPENAME op1, TYPENAME op2)
+ *       which must be declared before using __chain_expand(fname, TYPENAME).
+ */
+#define __chain_expand(fname, TYPENAME)				\
+								\
+	static inline BOOL fname##1(EN_ENO_PARAMS			\
+					TYPENAME op1) {			\
+		TEST_EN(BOOL);					\
+		return 1;	\
+	}								\
+								\
+	static inline BOOL fname##2(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2) {			\
+		TEST_EN(BOOL);					\
+		return fname##__step(op1, op2);	\
+	}								\
+								\
+	static inline BOOL fname##3(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3) {			\
+		TEST_EN(BOOL);					\
+		return fname##__step(op1, op2) && fname##__step(op2, op3);	\
+	}								\
+								\
+	static inline BOOL fname##4(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4) {			\
+		TEST_EN(BOOL);					\
+		return fname##__step(op1, op2) && fname##__step(op2, op3) && fname##__step(op3, op4);	\
+	}								\
+								\
+	static inline BOOL fname##5(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4,			\
+					TYPENAME op5) {			\
+		TEST_EN(BOOL);					\
+		return fname##__step(op1, op2) && fname##__step(op2, op3) && fname##__step(op3, op4) && fname##__step(op4, op5);	\
+	}								\
+								\
+	static inline BOOL fname##6(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4,			\
+					TYPENAME op5,			\
+					TYPENAME op6) {			\
+		TEST_EN(BOOL);					\
+		return fname##__step(op1, op2) && fname##__step(op2, op3) && fname##__step(op3, op4) && fname##__step(op4, op5) && fname##__step(op5, op6);	\
+	}								\
+								\
+	static inline BOOL fname##7(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4,			\
+					TYPENAME op5,			\
+					TYPENAME op6,			\
+					TYPENAME op7) {			\
+		TEST_EN(BOOL);					\
+		return fname##__step(op1, op2) && fname##__step(op2, op3) && fname##__step(op3, op4) && fname##__step(op4, op5) && fname##__step(op5, op6) && fname##__step(op6, op7);	\
+	}								\
+								\
+	static inline BOOL fname##8(EN_ENO_PARAMS			\
+					TYPENAME op1,			\
+					TYPENAME op2,			\
+					TYPENAME op3,			\
+					TYPENAME op4,			\
+					TYPENAME op5,			\
+					TYPENAME op6,			\
+					TYPENAME op7,			\
+					TYPENAME op8) {			\
+		TEST_EN(BOOL);					\
+		return fname##__step(op1, op2) && fname##__step(op2, op3) && fname##__step(op3, op4) && fname##__step(op4, op5) && fname##__step(op5, op6) && fname##__step(op6, op7) && fname##__step(op7, op8);	\
+	}								\
+								\
+	static inline BOOL fname##_VAR(EN_ENO_PARAMS			\
+					UINT param_count,		\
+					TYPENAME op1, ...){		\
+		va_list ap;						\
+		UINT i;							\
+		TEST_EN(BOOL)						\
+									\
+		va_start (ap, op1);         /* Initialize the argument list.  */ \
+		DBG(#fname #TYPENAME "\n")				\
+		DBG_TYPE(TYPENAME, op1)					\
+									\
+		for (i = 0; i < param_count - 1; i++){			\
+			TYPENAME tmp = va_arg (ap, VA_ARGS_##TYPENAME);	\
+			DBG_TYPE(TYPENAME, tmp)				\
+			if (!fname##__step(op1, tmp)) {			\
+				va_end (ap);          /* Clean up.  */	\
+				return 0;				\
+			}						\
+			op1 = tmp;					\
+		}							\
+									\
+		va_end (ap);                  /* Clean up.  */		\
+		return 1;						\
+	}								\
+									\
+
 #define __compare_(fname,TYPENAME, COND) \
-static inline BOOL fname(EN_ENO_PARAMS UINT param_count, TYPENAME op1, ...){\
-  va_list ap;\
-  UINT i;\
-  TEST_EN(BOOL)\
-  \
-  va_start (ap, op1);         /* Initialize the argument list.  */\
-  DBG(#fname #TYPENAME "\n")\
-  DBG_TYPE(TYPENAME, op1)\
-  \
-  for (i = 0; i < param_count - 1; i++){\
-    TYPENAME tmp = va_arg (ap, VA_ARGS_##TYPENAME);\
-    DBG_TYPE(TYPENAME, tmp)\
-    if(COND){\
-        op1 = tmp;\
-    }else{\
-        va_end (ap);                  /* Clean up.  */\
-        return 0;\
-    }\
-  }\
-  \
-  va_end (ap);                  /* Clean up.  */\
-  return 1;\
-}
+static inline BOOL fname##__step(TYPENAME op1, TYPENAME tmp) {return COND;}\
+__chain_expand(fname, TYPENAME)
 
 #define __compare_num(fname, TYPENAME, TEST) __compare_(fname, TYPENAME, op1 TEST tmp )
 #define __compare_time(fname, TYPENAME, TEST) __compare_(fname, TYPENAME, __time_cmp(op1, tmp) TEST 0)
@@ -1340,6 +1646,64 @@ __iec_(TIME)
 __compare_string(GT_STRING, > ) /* The explicitly typed standard functions */
 __compare_string(GT__BOOL__STRING, > ) /* Overloaded function */
 
+#define GT_BYTE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_BYTE,          __VA_ARGS__)
+#define GT__BOOL__BYTE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__BYTE,   __VA_ARGS__)
+
+#define GT_WORD(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_WORD,          __VA_ARGS__)
+#define GT__BOOL__WORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__WORD,   __VA_ARGS__)
+
+#define GT_DWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_DWORD,         __VA_ARGS__)
+#define GT__BOOL__DWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__DWORD,  __VA_ARGS__)
+
+#define GT_LWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_LWORD,         __VA_ARGS__)
+#define GT__BOOL__LWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__LWORD,  __VA_ARGS__)
+
+#define GT_REAL(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_REAL,          __VA_ARGS__)
+#define GT__BOOL__REAL(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__REAL,   __VA_ARGS__)
+
+#define GT_LREAL(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_LREAL,         __VA_ARGS__)
+#define GT__BOOL__LREAL(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__LREAL,  __VA_ARGS__)
+
+#define GT_SINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_SINT,          __VA_ARGS__)
+#define GT__BOOL__SINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__SINT,   __VA_ARGS__)
+
+#define GT_INT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_INT,           __VA_ARGS__)
+#define GT__BOOL__INT(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__INT,    __VA_ARGS__)
+
+#define GT_DINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_DINT,          __VA_ARGS__)
+#define GT__BOOL__DINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__DINT,   __VA_ARGS__)
+
+#define GT_LINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_LINT,          __VA_ARGS__)
+#define GT__BOOL__LINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__LINT,   __VA_ARGS__)
+
+#define GT_USINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_USINT,         __VA_ARGS__)
+#define GT__BOOL__USINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__USINT,  __VA_ARGS__)
+
+#define GT_UINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_UINT,          __VA_ARGS__)
+#define GT__BOOL__UINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__UINT,   __VA_ARGS__)
+
+#define GT_UDINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_UDINT,         __VA_ARGS__)
+#define GT__BOOL__UDINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__UDINT,  __VA_ARGS__)
+
+#define GT_ULINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_ULINT,         __VA_ARGS__)
+#define GT__BOOL__ULINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__ULINT,  __VA_ARGS__)
+
+#define GT_DATE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_DATE,          __VA_ARGS__)
+#define GT__BOOL__DATE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__DATE,   __VA_ARGS__)
+
+#define GT_TOD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_TOD,           __VA_ARGS__)
+#define GT__BOOL__TOD(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__TOD,    __VA_ARGS__)
+
+#define GT_DT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_DT,            __VA_ARGS__)
+#define GT__BOOL__DT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__DT,     __VA_ARGS__)
+
+#define GT_TIME(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_TIME,          __VA_ARGS__)
+#define GT__BOOL__TIME(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__TIME,   __VA_ARGS__)
+
+#define GT_STRING(...)        ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT_STRING,        __VA_ARGS__)
+#define GT__BOOL__STRING(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, GT__BOOL__STRING, __VA_ARGS__)
+
+
     /**************/
     /*     GE     */
     /**************/
@@ -1363,6 +1727,64 @@ __iec_(TIME)
 __compare_string(GE_STRING, >= ) /* The explicitly typed standard functions */
 __compare_string(GE__BOOL__STRING, >= ) /* Overloaded function */
 
+#define GE_BYTE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_BYTE,          __VA_ARGS__)
+#define GE__BOOL__BYTE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__BYTE,   __VA_ARGS__)
+
+#define GE_WORD(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_WORD,          __VA_ARGS__)
+#define GE__BOOL__WORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__WORD,   __VA_ARGS__)
+
+#define GE_DWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_DWORD,         __VA_ARGS__)
+#define GE__BOOL__DWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__DWORD,  __VA_ARGS__)
+
+#define GE_LWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_LWORD,         __VA_ARGS__)
+#define GE__BOOL__LWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__LWORD,  __VA_ARGS__)
+
+#define GE_REAL(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_REAL,          __VA_ARGS__)
+#define GE__BOOL__REAL(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__REAL,   __VA_ARGS__)
+
+#define GE_LREAL(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_LREAL,         __VA_ARGS__)
+#define GE__BOOL__LREAL(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__LREAL,  __VA_ARGS__)
+
+#define GE_SINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_SINT,          __VA_ARGS__)
+#define GE__BOOL__SINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__SINT,   __VA_ARGS__)
+
+#define GE_INT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_INT,           __VA_ARGS__)
+#define GE__BOOL__INT(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__INT,    __VA_ARGS__)
+
+#define GE_DINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_DINT,          __VA_ARGS__)
+#define GE__BOOL__DINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__DINT,   __VA_ARGS__)
+
+#define GE_LINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_LINT,          __VA_ARGS__)
+#define GE__BOOL__LINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__LINT,   __VA_ARGS__)
+
+#define GE_USINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_USINT,         __VA_ARGS__)
+#define GE__BOOL__USINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__USINT,  __VA_ARGS__)
+
+#define GE_UINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_UINT,          __VA_ARGS__)
+#define GE__BOOL__UINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__UINT,   __VA_ARGS__)
+
+#define GE_UDINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_UDINT,         __VA_ARGS__)
+#define GE__BOOL__UDINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__UDINT,  __VA_ARGS__)
+
+#define GE_ULINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_ULINT,         __VA_ARGS__)
+#define GE__BOOL__ULINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__ULINT,  __VA_ARGS__)
+
+#define GE_DATE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_DATE,          __VA_ARGS__)
+#define GE__BOOL__DATE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__DATE,   __VA_ARGS__)
+
+#define GE_TOD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_TOD,           __VA_ARGS__)
+#define GE__BOOL__TOD(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__TOD,    __VA_ARGS__)
+
+#define GE_DT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_DT,            __VA_ARGS__)
+#define GE__BOOL__DT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__DT,     __VA_ARGS__)
+
+#define GE_TIME(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_TIME,          __VA_ARGS__)
+#define GE__BOOL__TIME(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__TIME,   __VA_ARGS__)
+
+#define GE_STRING(...)        ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE_STRING,        __VA_ARGS__)
+#define GE__BOOL__STRING(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, GE__BOOL__STRING, __VA_ARGS__)
+
+
 
 
     /**************/
@@ -1388,6 +1810,64 @@ __iec_(TIME)
 __compare_string(EQ_STRING, == ) /* The explicitly typed standard functions */
 __compare_string(EQ__BOOL__STRING, == ) /* Overloaded function */
 
+#define EQ_BYTE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_BYTE,          __VA_ARGS__)
+#define EQ__BOOL__BYTE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__BYTE,   __VA_ARGS__)
+
+#define EQ_WORD(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_WORD,          __VA_ARGS__)
+#define EQ__BOOL__WORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__WORD,   __VA_ARGS__)
+
+#define EQ_DWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_DWORD,         __VA_ARGS__)
+#define EQ__BOOL__DWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__DWORD,  __VA_ARGS__)
+
+#define EQ_LWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_LWORD,         __VA_ARGS__)
+#define EQ__BOOL__LWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__LWORD,  __VA_ARGS__)
+
+#define EQ_REAL(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_REAL,          __VA_ARGS__)
+#define EQ__BOOL__REAL(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__REAL,   __VA_ARGS__)
+
+#define EQ_LREAL(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_LREAL,         __VA_ARGS__)
+#define EQ__BOOL__LREAL(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__LREAL,  __VA_ARGS__)
+
+#define EQ_SINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_SINT,          __VA_ARGS__)
+#define EQ__BOOL__SINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__SINT,   __VA_ARGS__)
+
+#define EQ_INT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_INT,           __VA_ARGS__)
+#define EQ__BOOL__INT(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__INT,    __VA_ARGS__)
+
+#define EQ_DINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_DINT,          __VA_ARGS__)
+#define EQ__BOOL__DINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__DINT,   __VA_ARGS__)
+
+#define EQ_LINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_LINT,          __VA_ARGS__)
+#define EQ__BOOL__LINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__LINT,   __VA_ARGS__)
+
+#define EQ_USINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_USINT,         __VA_ARGS__)
+#define EQ__BOOL__USINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__USINT,  __VA_ARGS__)
+
+#define EQ_UINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_UINT,          __VA_ARGS__)
+#define EQ__BOOL__UINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__UINT,   __VA_ARGS__)
+
+#define EQ_UDINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_UDINT,         __VA_ARGS__)
+#define EQ__BOOL__UDINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__UDINT,  __VA_ARGS__)
+
+#define EQ_ULINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_ULINT,         __VA_ARGS__)
+#define EQ__BOOL__ULINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__ULINT,  __VA_ARGS__)
+
+#define EQ_DATE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_DATE,          __VA_ARGS__)
+#define EQ__BOOL__DATE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__DATE,   __VA_ARGS__)
+
+#define EQ_TOD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_TOD,           __VA_ARGS__)
+#define EQ__BOOL__TOD(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__TOD,    __VA_ARGS__)
+
+#define EQ_DT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_DT,            __VA_ARGS__)
+#define EQ__BOOL__DT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__DT,     __VA_ARGS__)
+
+#define EQ_TIME(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_TIME,          __VA_ARGS__)
+#define EQ__BOOL__TIME(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__TIME,   __VA_ARGS__)
+
+#define EQ_STRING(...)        ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ_STRING,        __VA_ARGS__)
+#define EQ__BOOL__STRING(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, EQ__BOOL__STRING, __VA_ARGS__)
+
+
 
     /**************/
     /*     LT     */
@@ -1412,6 +1892,64 @@ __iec_(TIME)
 __compare_string(LT_STRING, < ) /* The explicitly typed standard functions */
 __compare_string(LT__BOOL__STRING, < ) /* Overloaded function */
 
+#define LT_BYTE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_BYTE,          __VA_ARGS__)
+#define LT__BOOL__BYTE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__BYTE,   __VA_ARGS__)
+
+#define LT_WORD(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_WORD,          __VA_ARGS__)
+#define LT__BOOL__WORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__WORD,   __VA_ARGS__)
+
+#define LT_DWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_DWORD,         __VA_ARGS__)
+#define LT__BOOL__DWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__DWORD,  __VA_ARGS__)
+
+#define LT_LWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_LWORD,         __VA_ARGS__)
+#define LT__BOOL__LWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__LWORD,  __VA_ARGS__)
+
+#define LT_REAL(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_REAL,          __VA_ARGS__)
+#define LT__BOOL__REAL(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__REAL,   __VA_ARGS__)
+
+#define LT_LREAL(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_LREAL,         __VA_ARGS__)
+#define LT__BOOL__LREAL(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__LREAL,  __VA_ARGS__)
+
+#define LT_SINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_SINT,          __VA_ARGS__)
+#define LT__BOOL__SINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__SINT,   __VA_ARGS__)
+
+#define LT_INT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_INT,           __VA_ARGS__)
+#define LT__BOOL__INT(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__INT,    __VA_ARGS__)
+
+#define LT_DINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_DINT,          __VA_ARGS__)
+#define LT__BOOL__DINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__DINT,   __VA_ARGS__)
+
+#define LT_LINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_LINT,          __VA_ARGS__)
+#define LT__BOOL__LINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__LINT,   __VA_ARGS__)
+
+#define LT_USINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_USINT,         __VA_ARGS__)
+#define LT__BOOL__USINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__USINT,  __VA_ARGS__)
+
+#define LT_UINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_UINT,          __VA_ARGS__)
+#define LT__BOOL__UINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__UINT,   __VA_ARGS__)
+
+#define LT_UDINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_UDINT,         __VA_ARGS__)
+#define LT__BOOL__UDINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__UDINT,  __VA_ARGS__)
+
+#define LT_ULINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_ULINT,         __VA_ARGS__)
+#define LT__BOOL__ULINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__ULINT,  __VA_ARGS__)
+
+#define LT_DATE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_DATE,          __VA_ARGS__)
+#define LT__BOOL__DATE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__DATE,   __VA_ARGS__)
+
+#define LT_TOD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_TOD,           __VA_ARGS__)
+#define LT__BOOL__TOD(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__TOD,    __VA_ARGS__)
+
+#define LT_DT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_DT,            __VA_ARGS__)
+#define LT__BOOL__DT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__DT,     __VA_ARGS__)
+
+#define LT_TIME(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_TIME,          __VA_ARGS__)
+#define LT__BOOL__TIME(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__TIME,   __VA_ARGS__)
+
+#define LT_STRING(...)        ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT_STRING,        __VA_ARGS__)
+#define LT__BOOL__STRING(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, LT__BOOL__STRING, __VA_ARGS__)
+
+
 
     /**************/
     /*     LE     */
@@ -1436,6 +1974,64 @@ __iec_(TIME)
 __compare_string(LE_STRING, <= ) /* The explicitly typed standard functions */
 __compare_string(LE__BOOL__STRING, <= ) /* Overloaded function */
 
+#define LE_BYTE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_BYTE,          __VA_ARGS__)
+#define LE__BOOL__BYTE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__BYTE,   __VA_ARGS__)
+
+#define LE_WORD(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_WORD,          __VA_ARGS__)
+#define LE__BOOL__WORD(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__WORD,   __VA_ARGS__)
+
+#define LE_DWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_DWORD,         __VA_ARGS__)
+#define LE__BOOL__DWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__DWORD,  __VA_ARGS__)
+
+#define LE_LWORD(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_LWORD,         __VA_ARGS__)
+#define LE__BOOL__LWORD(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__LWORD,  __VA_ARGS__)
+
+#define LE_REAL(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_REAL,          __VA_ARGS__)
+#define LE__BOOL__REAL(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__REAL,   __VA_ARGS__)
+
+#define LE_LREAL(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_LREAL,         __VA_ARGS__)
+#define LE__BOOL__LREAL(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__LREAL,  __VA_ARGS__)
+
+#define LE_SINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_SINT,          __VA_ARGS__)
+#define LE__BOOL__SINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__SINT,   __VA_ARGS__)
+
+#define LE_INT(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_INT,           __VA_ARGS__)
+#define LE__BOOL__INT(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__INT,    __VA_ARGS__)
+
+#define LE_DINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_DINT,          __VA_ARGS__)
+#define LE__BOOL__DINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__DINT,   __VA_ARGS__)
+
+#define LE_LINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_LINT,          __VA_ARGS__)
+#define LE__BOOL__LINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__LINT,   __VA_ARGS__)
+
+#define LE_USINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_USINT,         __VA_ARGS__)
+#define LE__BOOL__USINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__USINT,  __VA_ARGS__)
+
+#define LE_UINT(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_UINT,          __VA_ARGS__)
+#define LE__BOOL__UINT(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__UINT,   __VA_ARGS__)
+
+#define LE_UDINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_UDINT,         __VA_ARGS__)
+#define LE__BOOL__UDINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__UDINT,  __VA_ARGS__)
+
+#define LE_ULINT(...)         ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_ULINT,         __VA_ARGS__)
+#define LE__BOOL__ULINT(...)  ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__ULINT,  __VA_ARGS__)
+
+#define LE_DATE(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_DATE,          __VA_ARGS__)
+#define LE__BOOL__DATE(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__DATE,   __VA_ARGS__)
+
+#define LE_TOD(...)           ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_TOD,           __VA_ARGS__)
+#define LE__BOOL__TOD(...)    ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__TOD,    __VA_ARGS__)
+
+#define LE_DT(...)            ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_DT,            __VA_ARGS__)
+#define LE__BOOL__DT(...)     ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__DT,     __VA_ARGS__)
+
+#define LE_TIME(...)          ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_TIME,          __VA_ARGS__)
+#define LE__BOOL__TIME(...)   ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__TIME,   __VA_ARGS__)
+
+#define LE_STRING(...)        ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE_STRING,        __VA_ARGS__)
+#define LE__BOOL__STRING(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, LE__BOOL__STRING, __VA_ARGS__)
+
+
 
     /**************/
     /*     NE     */
@@ -1501,6 +2097,78 @@ __ne_string(NE__BOOL__STRING__STRING, STRING) /* Overloaded function */
 
 
 
+/* NOTE: The string functions are implemented by the __str_xxx() helpers below, which take their
+ *       STRING parameters, and the result, by reference, and copy only the characters in use
+ *       (never the whole STR_MAX_LEN body).
+ *       The standard functions themselves keep taking and returning STRING by value (this is how
+ *       the generated code calls them), but they are all inline, so once they are inlined the compiler
+ *       is free to drop these copies.
+ *       Like the arithmetic based functions, CONCAT has 8 optimized versions (for 1 to 8 INput parameters),
+ *       and an extra version for every other case (CONCAT_VAR), which must copy each parameter through va_arg().
+ */
+
+static inline void __str_left(STRING *res, const STRING *IN, size_t L) {
+  if (L > (size_t)IN->len) L = IN->len;
+  memcpy(res->body, IN->body, L);
+  res->len = (__strlen_t)L;
+}
+
+static inline void __str_right(STRING *res, const STRING *IN, size_t L) {
+  if (L > (size_t)IN->len) L = IN->len;
+  memcpy(res->body, &IN->body[IN->len - L], L);
+  res->len = (__strlen_t)L;
+}
+
+/* P counts from 1 */
+static inline void __str_mid(STRING *res, const STRING *IN, size_t L, size_t P) {
+  res->len = 0;
+  if (P > (size_t)IN->len) return;
+  if (P > 0) P -= 1; /* now can be used as [index]*/
+  if (L + P > (size_t)IN->len) L = IN->len - P;
+  memcpy(res->body, &IN->body[P], L);
+  res->len = (__strlen_t)L;
+}
+
+/* append IN to res (up to STR_MAX_LEN characters) */
+static inline void __str_append(STRING *res, const STRING *IN) {
+  size_t to_copy = STR_MAX_LEN - res->len;
+  if (to_copy > (size_t)IN->len) to_copy = IN->len;
+  memcpy(&res->body[res->len], IN->body, to_copy);
+  res->len += (__strlen_t)to_copy;
+}
+
+/* append the characters of IN starting at [P] to res (up to STR_MAX_LEN characters) */
+static inline void __str_append_from(STRING *res, const STRING *IN, size_t P) {
+  size_t to_copy;
+  if (P >= (size_t)IN->len) return;
+  to_copy = STR_MAX_LEN - res->len;
+  if (to_copy > IN->len - P) to_copy = IN->len - P;
+  memcpy(&res->body[res->len], &IN->body[P], to_copy);
+  res->len += (__strlen_t)to_copy;
+}
+
+static inline void __str_insert(STRING *res, const STRING *IN1, const STRING *IN2, size_t P) {
+  __str_left(res, IN1, P);
+  P = res->len;
+  __str_append(res, IN2);
+  __str_append_from(res, IN1, P);
+}
+
+static inline void __str_delete(STRING *res, const STRING *IN, size_t L, size_t P) {
+  __str_left(res, IN, (P > (size_t)IN->len)? IN->len : P - 1);
+  __str_append_from(res, IN, res->len + L);
+}
+
+static inline void __str_replace(STRING *res, const STRING *IN1, const STRING *IN2, size_t L, size_t P) {
+  STRING tmp;
+  __str_left(res, IN1, (P > (size_t)IN1->len)? IN1->len : P - 1);
+  P = res->len;
+  __str_left(&tmp, IN2, L);
+  __str_append(res, &tmp);
+  __str_append_from(res, IN1, P + L);
+}
+
+
     /***************/
     /*     LEN     */
     /***************/
@@ -1526,10 +2194,7 @@ __ANY_INT(__iec_)
 static inline STRING LEFT__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L){\
     STRING res;\
     TEST_EN_COND(STRING, L < 0)\
-    res = __INIT_STRING;\
-    L = L < (TYPENAME)IN.len ? L : (TYPENAME)IN.len;\
-    memcpy(&res.body, &IN.body, (size_t)L);\
-    res.len = (__strlen_t)L;\
+    __str_left(&res, &IN, (size_t)L);\
     return res;\
 }
 __ANY_INT(__left)
@@ -1543,10 +2208,7 @@ __ANY_INT(__left)
 static inline STRING RIGHT__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L){\
   STRING res;\
   TEST_EN_COND(STRING, L < 0)\
-  res = __INIT_STRING;\
-  L = L < (TYPENAME)IN.len ? L : (TYPENAME)IN.len;\
-  memcpy(&res.body, &IN.body[(TYPENAME)IN.len - L], (size_t)L);\
-  res.len = (__strlen_t)L;\
+  __str_right(&res, &IN, (size_t)L);\
   return res;\
 }
 __ANY_INT(__right)
@@ -1560,13 +2222,7 @@ __ANY_INT(__right)
 static inline STRING MID__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING IN, TYPENAME L, TYPENAME P){\
   STRING res;\
   TEST_EN_COND(STRING, L < 0 || P < 0)\
-  res = __INIT_STRING;\
-  if(P <= (TYPENAME)IN.len){\
-	P -= 1; /* now can be used as [index]*/\
-	L = L + P <= (TYPENAME)IN.len ? L : (TYPENAME)IN.len - P;\
-	memcpy(&res.body, &IN.body[P] , (size_t)L);\
-	res.len = (__strlen_t)L;\
-  }\
+  __str_mid(&res, &IN, (size_t)L, (size_t)P);\
   return res;\
 }
 __ANY_INT(__mid)
@@ -1576,60 +2232,85 @@ __ANY_INT(__mid)
     /*     CONCAT     */
     /******************/
 
-static inline STRING CONCAT(EN_ENO_PARAMS UINT param_count, ...){
+static inline STRING CONCAT1(EN_ENO_PARAMS STRING op1){
+  TEST_EN(STRING)
+  return op1;
+}
+
+static inline STRING CONCAT2(EN_ENO_PARAMS STRING op1, STRING op2){
+  TEST_EN(STRING)
+  __str_append(&op1, &op2);
+  return op1;
+}
+
+static inline STRING CONCAT3(EN_ENO_PARAMS STRING op1, STRING op2, STRING op3){
+  TEST_EN(STRING)
+  __str_append(&op1, &op2); __str_append(&op1, &op3);
+  return op1;
+}
+
+static inline STRING CONCAT4(EN_ENO_PARAMS STRING op1, STRING op2, STRING op3, STRING op4){
+  TEST_EN(STRING)
+  __str_append(&op1, &op2); __str_append(&op1, &op3); __str_append(&op1, &op4);
+  return op1;
+}
+
+static inline STRING CONCAT5(EN_ENO_PARAMS STRING op1, STRING op2, STRING op3, STRING op4, STRING op5){
+  TEST_EN(STRING)
+  __str_append(&op1, &op2); __str_append(&op1, &op3); __str_append(&op1, &op4); __str_append(&op1, &op5);
+  return op1;
+}
+
+static inline STRING CONCAT6(EN_ENO_PARAMS STRING op1, STRING op2, STRING op3, STRING op4, STRING op5, STRING op6){
+  TEST_EN(STRING)
+  __str_append(&op1, &op2); __str_append(&op1, &op3); __str_append(&op1, &op4); __str_append(&op1, &op5);
+  __str_append(&op1, &op6);
+  return op1;
+}
+
+static inline STRING CONCAT7(EN_ENO_PARAMS STRING op1, STRING op2, STRING op3, STRING op4, STRING op5, STRING op6, STRING op7){
+  TEST_EN(STRING)
+  __str_append(&op1, &op2); __str_append(&op1, &op3); __str_append(&op1, &op4); __str_append(&op1, &op5);
+  __str_append(&op1, &op6); __str_append(&op1, &op7);
+  return op1;
+}
+
+static inline STRING CONCAT8(EN_ENO_PARAMS STRING op1, STRING op2, STRING op3, STRING op4, STRING op5, STRING op6, STRING op7, STRING op8){
+  TEST_EN(STRING)
+  __str_append(&op1, &op2); __str_append(&op1, &op3); __str_append(&op1, &op4); __str_append(&op1, &op5);
+  __str_append(&op1, &op6); __str_append(&op1, &op7); __str_append(&op1, &op8);
+  return op1;
+}
+
+static inline STRING CONCAT_VAR(EN_ENO_PARAMS UINT param_count, STRING op1, ...){
   UINT i;
-  STRING res;
   va_list ap;
-  __strlen_t charcount;
   TEST_EN(STRING)
-  charcount = 0;
-  res = __INIT_STRING;
 
-  va_start (ap, param_count);         /* Initialize the argument list.  */
+  va_start (ap, op1);         /* Initialize the argument list.  */
 
-  for (i = 0; i < param_count && charcount < STR_MAX_LEN; i++)
+  for (i = 0; i < param_count - 1 && op1.len < STR_MAX_LEN; i++)
   {
     STRING tmp = va_arg(ap, STRING);
-    __strlen_t charrem = STR_MAX_LEN - charcount;
-    __strlen_t to_write = tmp.len > charrem ? charrem : tmp.len;
-    memcpy(&res.body[charcount], &tmp.body , to_write);
-    charcount += to_write;
+    __str_append(&op1, &tmp);
   }
 
-  res.len = charcount;
-
   va_end (ap);                  /* Clean up.  */
-  return res;
+  return op1;
 }
 
+#define CONCAT(...) ARITH_OPERATION__TYPE__TYPE(EN_PFX, CONCAT, __VA_ARGS__)
+
     /******************/
     /*     INSERT     */
     /******************/
 
-static inline STRING __insert(STRING IN1, STRING IN2, __strlen_t P){
-    STRING res;
-    __strlen_t to_copy;
-    res = __INIT_STRING;
-
-    to_copy = P > IN1.len ? IN1.len : P;
-    memcpy(&res.body, &IN1.body , to_copy);
-    P = res.len = to_copy;
-
-    to_copy = IN2.len + res.len > STR_MAX_LEN ? STR_MAX_LEN - res.len : IN2.len;
-    memcpy(&res.body[res.len], &IN2.body , to_copy);
-    res.len += to_copy;
-
-    to_copy = IN1.len - P < STR_MAX_LEN - res.len ? IN1.len - P : STR_MAX_LEN - res.len ;
-    memcpy(&res.body[res.len], &IN1.body[P] , to_copy);
-    res.len += to_copy;
-
-    return res;
-}
-
 #define __iec_(TYPENAME) \
 static inline STRING INSERT__STRING__STRING__STRING__##TYPENAME(EN_ENO_PARAMS STRING str1, STRING str2, TYPENAME P){\
+  STRING res;\
   TEST_EN_COND(STRING, P < 0)\
-  return (STRING)__insert(str1,str2,(__strlen_t)P);\
+  __str_insert(&res, &str1, &str2, (size_t)P);\
+  return res;\
 }
 __ANY_INT(__iec_)
 #undef __iec_
@@ -1639,28 +2320,12 @@ __ANY_INT(__iec_)
     /*     DELETE     */
     /******************/
 
-static inline STRING __delete(STRING IN, __strlen_t L, __strlen_t P){
-    STRING res;
-    __strlen_t to_copy;
-    res = __INIT_STRING;
-
-    to_copy = P > IN.len ? IN.len : P-1;
-    memcpy(&res.body, &IN.body , to_copy);
-    P = res.len = to_copy;
-
-    if( IN.len > P + L ){
-        to_copy = IN.len - P - L;
-        memcpy(&res.body[res.len], &IN.body[P + L], to_copy);
-        res.len += to_copy;
-    }
-
-    return res;
-}
-
 #define __iec_(TYPENAME) \
 static inline STRING DELETE__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING str, TYPENAME L, TYPENAME P){\
+  STRING res;\
   TEST_EN_COND(STRING, L < 0 || P < 0)\
-  return (STRING)__delete(str,(__strlen_t)L,(__strlen_t)P);\
+  __str_delete(&res, &str, (size_t)L, (size_t)P);\
+  return res;\
 }
 __ANY_INT(__iec_)
 #undef __iec_
@@ -1670,38 +2335,12 @@ __ANY_INT(__iec_)
     /*     REPLACE     */
     /*******************/
 
-static inline STRING __replace(STRING IN1, STRING IN2, __strlen_t L, __strlen_t P){
-    STRING res;
-    __strlen_t to_copy;
-    res = __INIT_STRING;
-
-    to_copy = P > IN1.len ? IN1.len : P-1;
-    memcpy(&res.body, &IN1.body , to_copy);
-    P = res.len = to_copy;
-
-    to_copy = IN2.len < L ? IN2.len : L;
-
-    if( to_copy + res.len > STR_MAX_LEN )
-       to_copy = STR_MAX_LEN - res.len;
-
-    memcpy(&res.body[res.len], &IN2.body , to_copy);
-    res.len += to_copy;
-
-    P += L;
-    if( res.len <  STR_MAX_LEN && P < IN1.len)
-    {
-        to_copy = IN1.len - P;
-        memcpy(&res.body[res.len], &IN1.body[P] , to_copy);
-        res.len += to_copy;
-    }
-
-    return res;
-}
-
 #define __iec_(TYPENAME) \
 static inline STRING REPLACE__STRING__STRING__STRING__##TYPENAME##__##TYPENAME(EN_ENO_PARAMS STRING str1, STRING str2, TYPENAME L, TYPENAME P){\
+  STRING res;\
   TEST_EN_COND(STRING, L < 0 || P < 0)\
-  return (STRING)__replace(str1,str2,(__strlen_t)L,(__strlen_t)P);\
+  __str_replace(&res, &str1, &str2, (size_t)L, (size_t)P);\
+  return res;\
 }
 __ANY_INT(__iec_)
 #undef __iec_
@@ -1710,7 +2349,7 @@ __ANY_INT(__iec_)
     /*     FIND     */
     /****************/
 
-static inline __strlen_t __pfind(STRING* IN1, STRING* IN2){
+static inline __strlen_t __pfind(const STRING* IN1, const STRING* IN2){
     UINT count1 = 0; /* offset of first matching char in IN1 */
     UINT count2 = 0; /* count of matching char */
     while(count1 + count2 < IN1->len && count2 < IN2->len)
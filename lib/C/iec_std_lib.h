@@ -55,7 +55,11 @@
  */
 #include "iec_types_all.h"
 
+#ifdef IEC_RESOURCE_THREADS
+extern __thread TIME __CURRENT_TIME;  /* each resource thread keeps its own time (see iec_threads.h) */
+#else
 extern TIME __CURRENT_TIME;
+#endif
 extern BOOL __DEBUG;
 
 /* TODO
@@ -173,6 +177,25 @@ static inline double __expt(double in1, double in2) {
 }
 
 
+/*************************************/
+/* Access to the fields of TIME etc. */
+/*************************************/
+/* TIME, DATE, TOD and DT are either a timespec (the default), or a 64 bit count of
+ * nanoseconds (if IEC_TIME_INT64 is defined, see iec_types.h).
+ * Code that does not depend on the representation should use these macros,
+ * instead of accessing the tv_sec/tv_nsec fields directly.
+ */
+#ifdef IEC_TIME_INT64
+#define __time_sec(t)  ((t) / 1000000000)
+#define __time_nsec(t) ((t) % 1000000000)
+#define __time_from_sec_nsec(TYPE, sec, nsec) ((TYPE)((IEC_TIME_NS)(sec) * 1000000000 + (IEC_TIME_NS)(nsec)))
+#else
+#define __time_sec(t)  ((t).tv_sec)
+#define __time_nsec(t) ((t).tv_nsec)
+#define __time_from_sec_nsec(TYPE, sec, nsec) ((TYPE){(sec), (nsec)})
+#endif
+
+
 /*******************************/
 /* Time normalization function */
 /*******************************/
@@ -234,6 +257,11 @@ static inline IEC_TIMESPEC __time_to_timespec(int sign, double mseconds, double
  *       They are therefore commented out. This however means that any change to the definition of IEC_TIMESPEC may require this
  *       macro to be updated too!
  */
+/* NOTE: With IEC_TIME_INT64 the macro results in an integer constant expression, rounded to the nearest nanosecond. */
+#ifdef IEC_TIME_INT64
+#define __time_to_timespec(sign,mseconds,seconds,minutes,hours,days) \
+          ((IEC_TIME_NS)(((sign>=0)?1:-1)*(((((long double)days*24 + (long double)hours)*60 + (long double)minutes)*60 + (long double)seconds + (long double)mseconds/1e3)*1e9 + 0.5)))
+#else
 #define __time_to_timespec(sign,mseconds,seconds,minutes,hours,days) \
           ((IEC_TIMESPEC){\
               /*tv_sec  =*/ ((long int)   (((sign>=0)?1:-1)*((((long double)days*24 + (long double)hours)*60 + (long double)minutes)*60 + (long double)seconds + (long double)mseconds/1e3))), \
@@ -242,6 +270,7 @@ static inline IEC_TIMESPEC __time_to_timespec(int sign, double mseconds, double
                             ((long int)   (((sign>=0)?1:-1)*((((long double)days*24 + (long double)hours)*60 + (long double)minutes)*60 + (long double)seconds + (long double)mseconds/1e3)))   \
                             )*1e9))\
         })
+#endif
 
 
 
@@ -259,6 +288,10 @@ static inline IEC_TIMESPEC __tod_to_timespec(double seconds, double minutes, dou
   return ts;
 }
 */
+#ifdef IEC_TIME_INT64
+#define __tod_to_timespec(seconds,minutes,hours) \
+          ((IEC_TIME_NS)(((((long double)hours)*60 + (long double)minutes)*60 + (long double)seconds)*1e9 + 0.5))
+#else
 #define __tod_to_timespec(seconds,minutes,hours) \
           ((IEC_TIMESPEC){\
               /*tv_sec  =*/ ((long int)   ((((long double)hours)*60 + (long double)minutes)*60 + (long double)seconds)), \
@@ -267,6 +300,7 @@ static inline IEC_TIMESPEC __tod_to_timespec(double seconds, double minutes, dou
                             ((long int)   ((((long double)hours)*60 + (long double)minutes)*60 + (long double)seconds))   \
                             )*1e9))\
         })
+#endif
 
 
 #define EPOCH_YEAR 1970
@@ -327,8 +361,7 @@ static inline tm convert_seconds_to_date_and_time(long int seconds) {
   return dt;
 }
 
-static inline IEC_TIMESPEC __date_to_timespec(int day, int month, int year) {
-  IEC_TIMESPEC ts;
+static inline DATE __date_to_timespec(int day, int month, int year) {
   int a4, b4, a100, b100, a400, b400;
   int yday;
   int intervening_leap_days;
@@ -349,25 +382,35 @@ static inline IEC_TIMESPEC __date_to_timespec(int day, int month, int year) {
   b400 = b100 >> 2;
   intervening_leap_days = (a4 - b4) - (a100 - b100) + (a400 - b400);
   
-  ts.tv_sec = ((year - EPOCH_YEAR) * 365 + intervening_leap_days + yday - 1) * 24 * 60 * 60;
-  ts.tv_nsec = 0;
-
-  return ts;
+  return __time_from_sec_nsec(DATE, ((year - EPOCH_YEAR) * 365 + intervening_leap_days + yday - 1) * 24 * 60 * 60, 0);
 }
 
-static inline IEC_TIMESPEC __dt_to_timespec(double seconds, double minutes, double hours, int day, int month, int year) {
+static inline DT __dt_to_timespec(double seconds, double minutes, double hours, int day, int month, int year) {
+#ifdef IEC_TIME_INT64
+  return __date_to_timespec(day, month, year) + __tod_to_timespec(seconds, minutes, hours);
+#else
   IEC_TIMESPEC ts_date = __date_to_timespec(day, month, year);
   IEC_TIMESPEC ts = __tod_to_timespec(seconds, minutes, hours);
 
   ts.tv_sec += ts_date.tv_sec;
 
   return ts;
+#endif
 }
 
 /*******************/
 /* Time operations */
 /*******************/
 
+#ifdef IEC_TIME_INT64
+/* Time operations on the 64 bit nanosecond count are plain integer operations */
+#define __time_cmp(t1, t2) (((t1) > (t2)) - ((t1) < (t2)))
+
+static inline TIME __time_add(TIME IN1, TIME IN2) {return IN1 + IN2;}
+static inline TIME __time_sub(TIME IN1, TIME IN2) {return IN1 - IN2;}
+static inline TIME __time_mul(TIME IN1, LREAL IN2) {return (TIME)((LREAL)IN1 * IN2);}
+static inline TIME __time_div(TIME IN1, LREAL IN2) {return (TIME)((LREAL)IN1 / IN2);}
+#else
 #define __time_cmp(t1, t2) (t2.tv_sec == t1.tv_sec ? t1.tv_nsec - t2.tv_nsec : t1.tv_sec - t2.tv_sec)
 
 static inline TIME __time_add(TIME IN1, TIME IN2){
@@ -399,6 +442,87 @@ static inline TIME __time_div(TIME IN1, LREAL IN2){
   __normalize_timespec(&res);
   return res;
 }
+#endif
+
+
+/*****************/
+/* SFC execution */
+/*****************/
+
+/* The SFC code keeps the indexes of the active steps, and of the actions that have work to do,
+ * in small sorted lists, so each cycle only visits these (and not all the steps and actions of the chart).
+ * Inserts index into the sorted list, unless it is already there.
+ */
+static inline void __sfc_list_insert(UINT *list, UINT *count, UINT index) {
+  UINT i = *count;
+  for (; i > 0 && list[i-1] >= index; i--)
+    if (list[i-1] == index) return;
+  memmove(&list[i+1], &list[i], (*count - i) * sizeof(UINT));
+  list[i] = index;
+  (*count)++;
+}
+
+
+/*****************/
+/* Task dispatch */
+/*****************/
+
+/* The generated resources activate their periodic tasks from a table with the tasks due at each tick
+ * of the hyperperiod. When the tasks do not fit in a small table, they use this (hashed) timer wheel instead,
+ * so each tick only visits the tasks in one slot of the wheel.
+ * __task_wheel_tick() must be called exactly once per tick, starting at tick 0 (i.e. the tick counter
+ * may be wrapped around, but only at a multiple of every period, e.g. at greatest_tick_count__).
+ * A task is due in the current tick if (entries[task].fired == wheel->tick).
+ */
+#define __TASK_WHEEL_SLOTS 64  /* must be a power of 2 */
+
+typedef struct {
+  ULINT period;   /* in ticks */
+  ULINT rounds;   /* turns of the wheel still to go before the task is due */
+  ULINT fired;    /* the last tick in which the task was due */
+  INT   next;     /* the next task in the same slot, or -1 */
+} __task_wheel_entry_t;
+
+typedef struct {
+  ULINT tick;     /* the current tick */
+  INT   head[__TASK_WHEEL_SLOTS];
+} __task_wheel_t;
+
+static inline void __task_wheel_insert(__task_wheel_t *wheel, __task_wheel_entry_t *entries, INT task, ULINT delay) {
+  UDINT slot = (wheel->tick + delay) & (__TASK_WHEEL_SLOTS - 1);
+  entries[task].rounds = (delay - 1) / __TASK_WHEEL_SLOTS;
+  entries[task].next   = wheel->head[slot];
+  wheel->head[slot]    = task;
+}
+
+/* All the tasks are due at tick 0 */
+static inline void __task_wheel_init(__task_wheel_t *wheel, __task_wheel_entry_t *entries, INT count) {
+  INT i;
+  wheel->tick = (ULINT)-1;
+  for (i = 0; i < __TASK_WHEEL_SLOTS; i++) wheel->head[i] = -1;
+  for (i = 0; i < count; i++) {
+    entries[i].fired = (ULINT)-2;
+    __task_wheel_insert(wheel, entries, i, 1);
+  }
+}
+
+static inline void __task_wheel_tick(__task_wheel_t *wheel, __task_wheel_entry_t *entries) {
+  UDINT slot = (++wheel->tick) & (__TASK_WHEEL_SLOTS - 1);
+  INT task = wheel->head[slot];
+  wheel->head[slot] = -1;
+  while (task >= 0) {
+    INT next = entries[task].next;
+    if (entries[task].rounds == 0) {
+      entries[task].fired = wheel->tick;
+      __task_wheel_insert(wheel, entries, task, entries[task].period);
+    } else {
+      entries[task].rounds--;
+      entries[task].next = wheel->head[slot];
+      wheel->head[slot]  = task;
+    }
+    task = next;
+  }
+}
 
 
 /***************/
@@ -429,28 +553,24 @@ static inline STRING __bool_to_string(BOOL IN) {
 }
 static inline STRING __bit_to_string(LWORD IN) {
     STRING res;
-    res = __INIT_STRING;
     res.len = snprintf((char*)res.body, STR_MAX_LEN, "16#%llx",(long long unsigned int)IN);
     if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
 }
 static inline STRING __real_to_string(LREAL IN) {
     STRING res;
-    res = __INIT_STRING;
     res.len = snprintf((char*)res.body, STR_MAX_LEN, "%.10g", IN);
     if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
 }
 static inline STRING __sint_to_string(LINT IN) {
     STRING res;
-    res = __INIT_STRING;
     res.len = snprintf((char*)res.body, STR_MAX_LEN, "%lld", (long long int)IN);
     if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
 }
 static inline STRING __uint_to_string(ULINT IN) {
     STRING res;
-    res = __INIT_STRING;
     res.len = snprintf((char*)res.body, STR_MAX_LEN, "%llu", (long long unsigned int)IN);
     if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
@@ -544,8 +664,8 @@ static inline LREAL __string_to_real(STRING IN) {
     /***************/
     /*   TO_TIME   */
     /***************/
-static inline TIME    __int_to_time(LINT IN)  {return (TIME){IN, 0};}
-static inline TIME   __real_to_time(LREAL IN) {return (TIME){IN, (IN - (LINT)IN) * 1000000000};}
+static inline TIME    __int_to_time(LINT IN)  {return __time_from_sec_nsec(TIME, IN, 0);}
+static inline TIME   __real_to_time(LREAL IN) {return __time_from_sec_nsec(TIME, (LINT)IN, (IN - (LINT)IN) * 1000000000);}
 static inline TIME __string_to_time(STRING IN){
     __strlen_t l;
     /* TODO :
@@ -574,9 +694,9 @@ static inline TIME __string_to_time(STRING IN){
     while(--l > 0 && IN.body[l] != '.');
     if(l != 0){
         LREAL IN_val = atof((const char *)&IN.body);
-        return  (TIME){(long)IN_val, (long)(IN_val - (LINT)IN_val)*1000000000};
+        return  __time_from_sec_nsec(TIME, (long)IN_val, (long)(IN_val - (LINT)IN_val)*1000000000);
     }else{
-        return  (TIME){(long)__pstring_to_sint(&IN), 0};
+        return  __time_from_sec_nsec(TIME, (long)__pstring_to_sint(&IN), 0);
     }
 }
 
@@ -584,30 +704,29 @@ static inline TIME __string_to_time(STRING IN){
     /*  FROM_TIME  */
     /***************/
 static inline LREAL __time_to_real(TIME IN){
-    return (LREAL)IN.tv_sec + ((LREAL)IN.tv_nsec/1000000000);
+    return (LREAL)__time_sec(IN) + ((LREAL)__time_nsec(IN)/1000000000);
 }
-static inline LINT __time_to_int(TIME IN) {return IN.tv_sec;}
+static inline LINT __time_to_int(TIME IN) {return __time_sec(IN);}
 static inline STRING __time_to_string(TIME IN){
     STRING res;
     div_t days;
     /*t#5d14h12m18s3.5ms*/
-    res = __INIT_STRING;
-    days = div(IN.tv_sec, SECONDS_PER_DAY);
-    if(!days.rem && IN.tv_nsec == 0){
+    days = div(__time_sec(IN), SECONDS_PER_DAY);
+    if(!days.rem && __time_nsec(IN) == 0){
         res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd", days.quot);
     }else{
         div_t hours = div(days.rem, SECONDS_PER_HOUR);
-        if(!hours.rem && IN.tv_nsec == 0){
+        if(!hours.rem && __time_nsec(IN) == 0){
             res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh", days.quot, hours.quot);
         }else{
             div_t minuts = div(hours.rem, SECONDS_PER_MINUTE);
-            if(!minuts.rem && IN.tv_nsec == 0){
+            if(!minuts.rem && __time_nsec(IN) == 0){
                 res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh%dm", days.quot, hours.quot, minuts.quot);
             }else{
-                if(IN.tv_nsec == 0){
+                if(__time_nsec(IN) == 0){
                     res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh%dm%ds", days.quot, hours.quot, minuts.quot, minuts.rem);
                 }else{
-                    res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh%dm%ds%gms", days.quot, hours.quot, minuts.quot, minuts.rem, (LREAL)IN.tv_nsec / 1000000);
+                    res.len = snprintf((char*)&res.body, STR_MAX_LEN, "T#%dd%dh%dm%ds%gms", days.quot, hours.quot, minuts.quot, minuts.rem, (LREAL)__time_nsec(IN) / 1000000);
                 }
             }
         }
@@ -619,8 +738,7 @@ static inline STRING __date_to_string(DATE IN){
     STRING res;
     tm broken_down_time;
     /* D#1984-06-25 */
-    broken_down_time = convert_seconds_to_date_and_time(IN.tv_sec);
-    res = __INIT_STRING;
+    broken_down_time = convert_seconds_to_date_and_time(__time_sec(IN));
     res.len = snprintf((char*)&res.body, STR_MAX_LEN, "D#%d-%2.2d-%2.2d",
              broken_down_time.tm_year,
              broken_down_time.tm_mon,
@@ -633,14 +751,13 @@ static inline STRING __tod_to_string(TOD IN){
     tm broken_down_time;
     time_t seconds;
     /* TOD#15:36:55.36 */
-    seconds = IN.tv_sec;
+    seconds = __time_sec(IN);
     if (seconds >= SECONDS_PER_DAY){
 		__iec_error();
 		return (STRING){9,"TOD#ERROR"};
 	}
     broken_down_time = convert_seconds_to_date_and_time(seconds);
-    res = __INIT_STRING;
-    if(IN.tv_nsec == 0){
+    if(__time_nsec(IN) == 0){
         res.len = snprintf((char*)&res.body, STR_MAX_LEN, "TOD#%2.2d:%2.2d:%2.2d",
                  broken_down_time.tm_hour,
                  broken_down_time.tm_min,
@@ -649,7 +766,7 @@ static inline STRING __tod_to_string(TOD IN){
         res.len = snprintf((char*)&res.body, STR_MAX_LEN, "TOD#%2.2d:%2.2d:%09.6f",
                  broken_down_time.tm_hour,
                  broken_down_time.tm_min,
-                 (LREAL)broken_down_time.tm_sec + (LREAL)IN.tv_nsec / 1e9);
+                 (LREAL)broken_down_time.tm_sec + (LREAL)__time_nsec(IN) / 1e9);
     }
     if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
@@ -658,8 +775,8 @@ static inline STRING __dt_to_string(DT IN){
     STRING res;
     tm broken_down_time;
     /* DT#1984-06-25-15:36:55.36 */
-    broken_down_time = convert_seconds_to_date_and_time(IN.tv_sec);
-    if(IN.tv_nsec == 0){
+    broken_down_time = convert_seconds_to_date_and_time(__time_sec(IN));
+    if(__time_nsec(IN) == 0){
         res.len = snprintf((char*)&res.body, STR_MAX_LEN, "DT#%d-%2.2d-%2.2d-%2.2d:%2.2d:%2.2d",
                  broken_down_time.tm_year,
                  broken_down_time.tm_mon,
@@ -674,7 +791,7 @@ static inline STRING __dt_to_string(DT IN){
                  broken_down_time.tm_day,
                  broken_down_time.tm_hour,
                  broken_down_time.tm_min,
-                 (LREAL)broken_down_time.tm_sec + ((LREAL)IN.tv_nsec / 1e9));
+                 (LREAL)broken_down_time.tm_sec + ((LREAL)__time_nsec(IN) / 1e9));
     }
     if(res.len > STR_MAX_LEN) res.len = STR_MAX_LEN;
     return res;
@@ -685,14 +802,14 @@ static inline STRING __dt_to_string(DT IN){
     /**********************************************/
 
 static inline TOD __date_and_time_to_time_of_day(DT IN) {
-	return (TOD){
-		IN.tv_sec % SECONDS_PER_DAY + (IN.tv_sec < 0 ? SECONDS_PER_DAY : 0),
-		IN.tv_nsec};
+	return __time_from_sec_nsec(TOD,
+		__time_sec(IN) % SECONDS_PER_DAY + (__time_sec(IN) < 0 ? SECONDS_PER_DAY : 0),
+		__time_nsec(IN));
 }
 static inline DATE __date_and_time_to_date(DT IN){
-	return (DATE){
-		IN.tv_sec - IN.tv_sec % SECONDS_PER_DAY - (IN.tv_sec < 0 ? SECONDS_PER_DAY : 0),
-		0};
+	return __time_from_sec_nsec(DATE,
+		__time_sec(IN) - __time_sec(IN) % SECONDS_PER_DAY - (__time_sec(IN) < 0 ? SECONDS_PER_DAY : 0),
+		0);
 }
 
     /*****************/
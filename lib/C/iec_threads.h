@@ -0,0 +1,141 @@
+/*
+ * Runtime support for running the resources (or the tasks) of a configuration on their own threads.
+ *
+ * To be used with the code generated by iec2c with the '-O r' option (see accessor.h), and
+ * included by exactly one source file of the runtime (it defines __CURRENT_TIME and the
+ * functions that lock the global variables).
+ *
+ *   int  __iec_start_threads(int per_task, const int *cpus, int cpu_count);
+ *   void __iec_stop_threads(void);
+ *
+ * config_init__() must be called before __iec_start_threads().
+ * With per_task == 0 a thread is started for each resource (running <resource>_run__() with the
+ * period of the resource), otherwise for each execution unit (running <resource>_run_unit__() with
+ * the interval of its task). Thread i is pinned to cpus[i % cpu_count] (if cpu_count > 0).
+ * Each thread keeps its own __CURRENT_TIME, read from CLOCK_REALTIME at the start of each cycle.
+ * The threads use absolute deadlines (CLOCK_MONOTONIC), so a cycle that overruns its period
+ * shortens the following sleep, and the next cycles start immediately until the thread catches up.
+ *
+ * While the threads are running config_run__() must not be called.
+ *
+ * NOTE: Pinning the threads requires _GNU_SOURCE to be defined before any system header is included.
+ */
+
+#ifndef _IEC_THREADS_H
+#define _IEC_THREADS_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "iec_std_lib.h"
+#include "accessor.h"
+
+
+__thread TIME __CURRENT_TIME;
+
+static pthread_mutex_t __iec_globals_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+void __iec_lock_globals  (void) {pthread_mutex_lock  (&__iec_globals_mutex);}
+void __iec_unlock_globals(void) {pthread_mutex_unlock(&__iec_globals_mutex);}
+
+
+/* declared in the generated configuration file */
+extern const int              __iec_resource_count;
+extern const __IEC_RESOURCE_t __iec_resources[];
+extern const int              __iec_unit_count;
+extern const __IEC_UNIT_t     __iec_units[];
+
+
+typedef struct {
+	pthread_t thread;
+	int       index;     // into __iec_units[] (per_task), or __iec_resources[]
+	int       per_task;
+	int       cpu;       // -1: not pinned
+} __iec_thread_t;
+
+static __iec_thread_t *__iec_threads       = NULL;
+static int             __iec_thread_count  = 0;
+static volatile int    __iec_threads_running = 0;
+
+void __iec_stop_threads(void);
+
+
+static void __iec_timespec_add(struct timespec *ts, unsigned long long ns) {
+	ts->tv_sec  += ns / 1000000000ULL;
+	ts->tv_nsec += ns % 1000000000ULL;
+	if (ts->tv_nsec >= 1000000000L) {ts->tv_sec++; ts->tv_nsec -= 1000000000L;}
+}
+
+
+static void *__iec_thread_main(void *arg) {
+	__iec_thread_t *self = (__iec_thread_t *)arg;
+	unsigned long long period = self->per_task? __iec_units[self->index].period : __iec_resources[self->index].period;
+	unsigned long tick = 0;
+	struct timespec next, now;
+
+#if defined(__linux__) && defined(_GNU_SOURCE)
+	if (self->cpu >= 0) {
+		cpu_set_t cpuset;
+		CPU_ZERO(&cpuset);
+		CPU_SET(self->cpu, &cpuset);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+	}
+#endif
+
+	clock_gettime(CLOCK_MONOTONIC, &next);
+	while (__iec_threads_running) {
+		clock_gettime(CLOCK_REALTIME, &now);
+		__CURRENT_TIME = __time_from_sec_nsec(TIME, now.tv_sec, now.tv_nsec);
+		if (self->per_task) {
+			__iec_units[self->index].run(self->index, tick);
+			tick += __iec_units[self->index].tick_step;
+		} else {
+			__iec_resources[self->index].run(tick);
+			tick++;
+		}
+		__iec_timespec_add(&next, period);
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+	}
+	return NULL;
+}
+
+
+/* Returns 0 on success, or the error returned by pthread_create() (no thread is left running) */
+int __iec_start_threads(int per_task, const int *cpus, int cpu_count) {
+	int i, res;
+	if (__iec_threads_running) return -1;
+
+	__iec_thread_count = per_task? __iec_unit_count : __iec_resource_count;
+	__iec_threads = (__iec_thread_t *)calloc(__iec_thread_count, sizeof(__iec_thread_t));
+	if ((NULL == __iec_threads) && (__iec_thread_count > 0)) return -1;
+
+	__iec_threads_running = 1;
+	for (i = 0; i < __iec_thread_count; i++) {
+		__iec_threads[i].index    = i;
+		__iec_threads[i].per_task = per_task;
+		__iec_threads[i].cpu      = (cpu_count > 0)? cpus[i % cpu_count] : -1;
+		res = pthread_create(&(__iec_threads[i].thread), NULL, __iec_thread_main, &(__iec_threads[i]));
+		if (res != 0) {
+			__iec_thread_count = i;
+			__iec_stop_threads();
+			return res;
+		}
+	}
+	return 0;
+}
+
+
+/* Waits for the current cycle of each thread to finish */
+void __iec_stop_threads(void) {
+	int i;
+	__iec_threads_running = 0;
+	for (i = 0; i < __iec_thread_count; i++)
+		pthread_join(__iec_threads[i].thread, NULL);
+	free(__iec_threads);
+	__iec_threads      = NULL;
+	__iec_thread_count = 0;
+}
+
+
+#endif /* _IEC_THREADS_H */
@@ -39,10 +39,25 @@ typedef struct {
     long int tv_nsec;           /* Nanoseconds.  */
 } /* __attribute__((packed)) */ IEC_TIMESPEC;  /* packed is gcc specific! */
 
+#ifdef IEC_TIME_INT64
+/* TIME, DATE, DT and TOD stored as a (signed) 64 bit count of nanoseconds (i.e. a range of +-292 years),
+ * so that adding, subtracting and comparing them are single integer operations.
+ * WARNING: All the code sharing these variables (the generated code, and the runtime that
+ *          sets __CURRENT_TIME) must be compiled with the same setting. iec2c's '-O t' option
+ *          defines IEC_TIME_INT64 in all the generated files.
+ */
+typedef int64_t IEC_TIME_NS;
+
+typedef IEC_TIME_NS IEC_TIME;
+typedef IEC_TIME_NS IEC_DATE;
+typedef IEC_TIME_NS IEC_DT;
+typedef IEC_TIME_NS IEC_TOD;
+#else
 typedef IEC_TIMESPEC IEC_TIME;
 typedef IEC_TIMESPEC IEC_DATE;
 typedef IEC_TIMESPEC IEC_DT;
 typedef IEC_TIMESPEC IEC_TOD;
+#endif
 
 #ifndef STR_MAX_LEN
 #define STR_MAX_LEN 126
@@ -62,7 +77,6 @@ typedef IEC_TIMESPEC IEC_TOD;
 #define __INIT_UINT 0
 #define __INIT_UDINT 0
 #define __INIT_ULINT 0
-#define __INIT_TIME (TIME){0,0}
 #define __INIT_BOOL 0
 #define __INIT_BYTE 0
 #define __INIT_WORD 0
@@ -70,9 +84,17 @@ typedef IEC_TIMESPEC IEC_TOD;
 #define __INIT_LWORD 0
 #define __INIT_STRING (STRING){0,""}
 //#define __INIT_WSTRING
+#ifdef IEC_TIME_INT64
+#define __INIT_TIME 0
+#define __INIT_DATE 0
+#define __INIT_TOD 0
+#define __INIT_DT 0
+#else
+#define __INIT_TIME (TIME){0,0}
 #define __INIT_DATE (DATE){0,0}
 #define __INIT_TOD (TOD){0,0}
 #define __INIT_DT (DT){0,0}
+#endif
 
 typedef STR_LEN_TYPE __strlen_t;
 typedef struct {
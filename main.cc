@@ -81,6 +81,8 @@
 #include "stage1_2/stage1_2.hh"
 #include "stage3/stage3.hh"
 #include "stage4/stage4.hh"
+#include "util/pass_report.hh"
+#include "server.hh"
 #include "main.hh"
 
 
@@ -109,7 +111,8 @@ void error_exit(const char *file_name, int line_no, const char *errmsg, ...) {
 
 
 static void printusage(const char *cmd) {
-  printf("\nsyntax: %s [<options>] [-O <output_options>] [-I <include_directory>] [-T <target_directory>] <input_file>\n", cmd);
+  printf("\nsyntax: %s [<options>] [-O <output_options>] [-I <include_directory>] [-T <target_directory>] [-L <cache_directory>] [-j <threads>] [-t <report_file>] <input_file>\n", cmd);
+  printf("        %s [<options>] [-O <output_options>] [-I <include_directory>] [-L <cache_directory>] -S <socket>|-\n", cmd);
   printf(" -h : show this help message\n");
   printf(" -v : print version number\n");  
   printf(" -f : display full token location on error messages\n");
@@ -125,6 +128,13 @@ static void printusage(const char *cmd) {
   printf(" -b : allow functions returning VOID                 (a non-standard extension!)\n");
   printf(" -e : disable generation of implicit EN and ENO parameters.\n");
   printf(" -c : create conversion functions for enumerated data types\n");
+  printf(" -L : cache the parsed standard library in <cache_directory>, and reuse it in later runs\n");
+  printf(" -j : analyse the POUs (and, with -O p, generate their code) using <threads> threads (default: 1)\n");
+  printf(" -t : write the time and memory used by each compiler pass, and the number of AST nodes of each class,\n");
+  printf("        to <report_file> (in JSON), or to stderr (as a table) if <report_file> is '-'\n");
+  printf(" -S : run as a compiler server, that keeps the parsed standard library in memory, and compiles each\n");
+  printf("        request read from the unix domain <socket> (or from stdin if <socket> is '-'). Each request is\n");
+  printf("        a line with the options and input file of a compilation, as in the command line.\n");
   printf(" -O : options for output (code generation) stage. Available options for %s are...\n", cmd);
   runtime_options.allow_missing_var_in    = false; /* disable: allow definition and invocation of POUs with no input, output and in_out parameters! */
   stage4_print_options();
@@ -138,41 +148,76 @@ static void printusage(const char *cmd) {
 /* declare the global options variable */
 runtime_options_t runtime_options;
 
+/* the command line options that are not runtime_options... */
+static char       *builddir      = NULL;  /* -T */
+static const char *server_socket = NULL;  /* -S */
 
-int main(int argc, char **argv) {
+
+/* Run the compiler passes on the input file */
+static int compile(const char *input_file, const char *builddir) {
   symbol_c *tree_root, *ordered_tree_root;
-  char * builddir = NULL;
-  int optres, errflg = 0;
-  int path_len;
 
-  /* Default values for the command line options... */
-  runtime_options.allow_void_datatype     = false; /* disable: allow declaration of functions returning VOID  */
-  runtime_options.allow_missing_var_in    = false; /* disable: allow definition and invocation of POUs with no input, output and in_out parameters! */
-  runtime_options.disable_implicit_en_eno = false; /* disable: do not generate EN and ENO parameters */
-  runtime_options.pre_parsing             = false; /* disable: allow use of forward references (run pre-parsing phase before the definitive parsing phase that builds the AST) */
-  runtime_options.safe_extensions         = false; /* disable: allow use of SAFExxx datatypes */
-  runtime_options.full_token_loc          = false; /* disable: error messages specify full token location */
-  runtime_options.conversion_functions    = false; /* disable: create a conversion function for derived datatype */
-  runtime_options.nested_comments         = false; /* disable: Allow the use of nested comments. */
-  runtime_options.ref_standard_extensions = false; /* disable: Allow the use of REFerences (keywords REF_TO, REF, DREF, ^, NULL). */
-  runtime_options.ref_nonstand_extensions = false; /* disable: Allow the use of non-standard extensions to REF_TO datatypes: REF_TO ANY, and REF_TO in struct elements! */
-  runtime_options.nonliteral_in_array_size= false; /* disable: Allow the use of constant non-literals when specifying size of arrays (ARRAY [1..max] OF INT) */
-  runtime_options.includedir              = NULL;  /* Include directory, where included files will be searched for... */
+  /* 1st Pass */
+  pass_report_c::begin("stage1_2");
+  int res = stage1_2(input_file, &tree_root);
+  pass_report_c::end();
+  if (res < 0)
+    return EXIT_FAILURE;
+  pass_report_c::count_nodes(tree_root);
 
-  /* Default values for the command line options... */
-  runtime_options.relaxed_datatype_model    = false; /* by default use the strict datatype equivalence model */
+  /* 2nd Pass */
+    /* basically loads some symbol tables to speed up look ups later on */
+  pass_report_c::begin("absyntax_utils_init");
+  absyntax_utils_init(tree_root);  
+  pass_report_c::end();
+    /* moved to bison, although it could perfectly well still be here instead of in bison code. */
+  //add_en_eno_param_decl_c::add_to(tree_root);
+
+  /* Do semantic verification of code */
+  pass_report_c::begin("stage3");
+  res = stage3(tree_root, &ordered_tree_root);
+  pass_report_c::end();
+  if (res < 0)
+    return EXIT_FAILURE;
   
-  /******************************************/
-  /*   Parse command line options...        */
-  /******************************************/
-  while ((optres = getopt(argc, argv, ":nehvfplsrRabicI:T:O:")) != -1) {
+  /* 3rd Pass */
+  pass_report_c::begin("stage4");
+  res = stage4(ordered_tree_root, builddir);
+  pass_report_c::end();
+  if (res < 0)
+    return EXIT_FAILURE;
+
+  /* 4th Pass */
+  /* Call gcc, g++, or whatever... */
+  /* Currently implemented in the Makefile! */
+
+  return 0;
+}
+
+
+/* Compile the input file, and write out the pass report (-t) */
+static int compile_and_report(const char *input_file) {
+  pass_report_c::set_input_file(input_file);
+  int result = compile(input_file, builddir);
+  if (pass_report_c::print() < 0)
+    result = EXIT_FAILURE;
+  return result;
+}
+
+
+/* Parse the command line options. Returns the number of errors found. */
+static int parse_options(int argc, char **argv) {
+  int optres, errflg = 0;
+  int path_len;
+
+  while ((optres = getopt(argc, argv, ":nehvfplsrRabicI:T:O:L:j:t:S:")) != -1) {
     switch(optres) {
     case 'h':
       printusage(argv[0]);
-      return 0;
+      exit(EXIT_SUCCESS);
     case 'v':
       fprintf(stdout, "%s version %s\n" "changeset id: %s\n", PACKAGE_NAME, PACKAGE_VERSION, HGVERSION);      
-      return 0;
+      exit(EXIT_SUCCESS);
     case 'l': runtime_options.relaxed_datatype_model   = true;  break;
     case 'p': runtime_options.pre_parsing              = true;  break;
     case 'f': runtime_options.full_token_loc           = true;  break;
@@ -202,10 +247,29 @@ int main(int argc, char **argv) {
       if (optarg[path_len] == '\\') optarg[path_len]= '\0';
       builddir = optarg;
       break;
+    case 'L':
+      /* NOTE: see note above */
+      path_len = strlen(optarg) - 1;
+      if (optarg[path_len] == '\\') optarg[path_len]= '\0';
+      runtime_options.library_cache_dir = optarg;
+      break;
+    case 'j':
+      runtime_options.threads = atoi(optarg);
+      if (runtime_options.threads < 1) {
+        fprintf(stderr, "Invalid number of threads: %s\n", optarg);
+        errflg++;
+      }
+      break;
+    case 't':
+      pass_report_c::enable(optarg);
+      break;
+    case 'S':
+      server_socket = optarg;
+      break;
     case 'O':
       if (stage4_parse_options(optarg) < 0) errflg++;
       break;
-    case ':':       /* -I, -T, or -O without operand */
+    case ':':       /* -I, -T, -L, -j, -t, -S, or -O without operand */
       fprintf(stderr, "Option -%c requires an operand\n", optopt);
       errflg++;
       break;
@@ -220,6 +284,107 @@ int main(int argc, char **argv) {
     }
   }
 
+  return errflg;
+}
+
+
+/* The options of stage 1_2 affect the parsing of the standard library, so the compiler server
+ * (that keeps the standard library resident) only accepts them on its own command line.
+ */
+static bool same_stage1_2_options(const runtime_options_t &a, const runtime_options_t &b) {
+  return (   (a.allow_void_datatype      == b.allow_void_datatype)
+          && (a.allow_missing_var_in     == b.allow_missing_var_in)
+          && (a.disable_implicit_en_eno  == b.disable_implicit_en_eno)
+          && (a.pre_parsing              == b.pre_parsing)
+          && (a.safe_extensions          == b.safe_extensions)
+          && (a.full_token_loc           == b.full_token_loc)
+          && (a.conversion_functions     == b.conversion_functions)
+          && (a.nested_comments          == b.nested_comments)
+          && (a.ref_standard_extensions  == b.ref_standard_extensions)
+          && (a.ref_nonstand_extensions  == b.ref_nonstand_extensions)
+          && (a.nonliteral_in_array_size == b.nonliteral_in_array_size)
+          && (((NULL == a.includedir) && (NULL == b.includedir)) ||
+              ((NULL != a.includedir) && (NULL != b.includedir) && (strcmp(a.includedir, b.includedir) == 0))));
+}
+
+
+/* Handle a request of the compiler server (see server.hh), in the process forked for it.
+ * The request has the same options and input file as the command line of iec2c, on top of
+ * the options given to the server.
+ */
+static int compile_request(int argc, char **argv) {
+  runtime_options_t server_options = runtime_options;
+  int errflg;
+
+  server_socket = NULL;
+#ifdef __GLIBC__
+  optind = 0;  /* make GNU getopt start over, on a new argv */
+#else
+  optind = 1;
+#endif
+  errflg = parse_options(argc, argv);
+  if (NULL != server_socket) {
+    fprintf(stderr, "Option -S is not allowed in a request to the compiler server\n");
+    errflg++;
+  }
+  if (!same_stage1_2_options(runtime_options, server_options)) {
+    fprintf(stderr, "Options -I, -p, -f, -s, -n, -r, -R, -a, -i, -b, -e and -c must be given when starting the compiler server\n");
+    errflg++;
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, (optind == argc)? "Missing input file\n" : "Too many input files\n");
+    errflg++;
+  }
+  if (errflg)
+    return EXIT_FAILURE;
+
+  return compile_and_report(argv[optind]);
+}
+
+
+int main(int argc, char **argv) {
+  int errflg = 0;
+
+  /* Default values for the command line options... */
+  runtime_options.allow_void_datatype     = false; /* disable: allow declaration of functions returning VOID  */
+  runtime_options.allow_missing_var_in    = false; /* disable: allow definition and invocation of POUs with no input, output and in_out parameters! */
+  runtime_options.disable_implicit_en_eno = false; /* disable: do not generate EN and ENO parameters */
+  runtime_options.pre_parsing             = false; /* disable: allow use of forward references (run pre-parsing phase before the definitive parsing phase that builds the AST) */
+  runtime_options.safe_extensions         = false; /* disable: allow use of SAFExxx datatypes */
+  runtime_options.full_token_loc          = false; /* disable: error messages specify full token location */
+  runtime_options.conversion_functions    = false; /* disable: create a conversion function for derived datatype */
+  runtime_options.nested_comments         = false; /* disable: Allow the use of nested comments. */
+  runtime_options.ref_standard_extensions = false; /* disable: Allow the use of REFerences (keywords REF_TO, REF, DREF, ^, NULL). */
+  runtime_options.ref_nonstand_extensions = false; /* disable: Allow the use of non-standard extensions to REF_TO datatypes: REF_TO ANY, and REF_TO in struct elements! */
+  runtime_options.nonliteral_in_array_size= false; /* disable: Allow the use of constant non-literals when specifying size of arrays (ARRAY [1..max] OF INT) */
+  runtime_options.includedir              = NULL;  /* Include directory, where included files will be searched for... */
+  runtime_options.library_cache_dir       = NULL;  /* Directory where the parsed standard library is cached... */
+
+  /* Default values for the command line options... */
+  runtime_options.relaxed_datatype_model    = false; /* by default use the strict datatype equivalence model */
+  runtime_options.threads                   = 1;     /* by default do not use any additional threads */
+  
+  /******************************************/
+  /*   Parse command line options...        */
+  /******************************************/
+  errflg = parse_options(argc, argv);
+
+  if (NULL != server_socket) {
+    if (optind != argc) {
+      fprintf(stderr, "No input file may be given to the compiler server (-S)\n");
+      errflg++;
+    }
+    if (pass_report_c::enabled()) {
+      fprintf(stderr, "Option -t must be given in each request to the compiler server (-S)\n");
+      errflg++;
+    }
+    if (errflg) {
+      printusage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    return server_run(server_socket, compile_request);
+  }
+
   if (optind == argc) {
     fprintf(stderr, "Missing input file\n");
     errflg++;
@@ -239,29 +404,7 @@ int main(int argc, char **argv) {
   /***************************/
   /*   Run the compiler...   */
   /***************************/
-  /* 1st Pass */
-  if (stage1_2(argv[optind], &tree_root) < 0)
-    return EXIT_FAILURE;
-
-  /* 2nd Pass */
-    /* basically loads some symbol tables to speed up look ups later on */
-  absyntax_utils_init(tree_root);  
-    /* moved to bison, although it could perfectly well still be here instead of in bison code. */
-  //add_en_eno_param_decl_c::add_to(tree_root);
-
-  /* Do semantic verification of code */
-  if (stage3(tree_root, &ordered_tree_root) < 0)
-    return EXIT_FAILURE;
-  
-  /* 3rd Pass */
-  if (stage4(ordered_tree_root, builddir) < 0)
-    return EXIT_FAILURE;
-
-  /* 4th Pass */
-  /* Call gcc, g++, or whatever... */
-  /* Currently implemented in the Makefile! */
-
-  return 0;
+  return compile_and_report(argv[optind]);
 }
 
 
@@ -52,9 +52,13 @@ typedef struct {
 	bool ref_nonstand_extensions;  /* Allow the use of non-standard extensions to REF_TO datatypes: REF_TO ANY, and REF_TO in struct elements! */
 	bool nonliteral_in_array_size; /* Allow the use of constant non-literals when specifying size of arrays (ARRAY [1..max] OF INT) */
 	const char *includedir;        /* Include directory, where included files will be searched for... */
+	const char *library_cache_dir; /* Directory where the parsed standard library is cached (NULL: do not use the cache) */
 	
    /* options specific to stage3 */
 	bool relaxed_datatype_model;   /* Use the relaxed datatype equivalence model, instead of the default strict equivalence model */
+
+   /* options common to several stages */
+	int  threads;                  /* Number of threads used to analyse (stage3) and generate the code of (stage4, -O p) the POUs. 1 (the default): use only the main thread. */
 } runtime_options_t;
 
 extern runtime_options_t runtime_options;
@@ -0,0 +1,250 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ * The compiler server (-S option).
+ *
+ * See server.hh for details.
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "absyntax/absyntax.hh"
+#include "absyntax_utils/absyntax_utils.hh"
+#include "stage1_2/stage1_2.hh"
+#include "server.hh"
+#include "main.hh"
+
+
+#if defined(_WIN32) || defined(__WIN32__)
+
+int server_run(const char *socket_path, int (*compile_request)(int argc, char **argv)) {
+  fprintf(stderr, "The compiler server (-S) is not available on this platform\n");
+  return EXIT_FAILURE;
+}
+
+#else
+
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+
+/* Time (in seconds) a client has to send its request, once connected */
+#define REQUEST_TIMEOUT 10
+
+
+/* Reads the requests, one line at a time.
+ * NOTE: We do not use stdio to read stdin, as the forked processes would then also
+ *       share (and, on exit, flush) its buffer.
+ */
+class line_reader_c {
+  public:
+    line_reader_c(int fd_) {fd = fd_;}
+    /* Returns false at the end of the input, or on error (e.g. a timeout) */
+    bool read_line(std::string &line) {
+      size_t end;
+      while ((end = buffer.find('\n')) == std::string::npos) {
+        char    chunk[4096];
+        ssize_t len = read(fd, chunk, sizeof(chunk));
+        if ((len < 0) && (errno == EINTR)) continue;
+        if (len < 0) return false;  /* do not run what may be only part of a request */
+        if (len == 0) {
+          /* the last line may not end with a newline */
+          if (buffer.empty()) return false;
+          line.swap(buffer);
+          buffer.clear();
+          return true;
+        }
+        buffer.append(chunk, len);
+      }
+      line = buffer.substr(0, end);
+      buffer.erase(0, end + 1);
+      return true;
+    }
+
+  private:
+    int         fd;
+    std::string buffer;  /* read, but not yet returned */
+};
+
+
+/* Split the request into its arguments (in place), handling "double quotes" and backslashes. */
+static void split_request(char *request, std::vector<char *> &args) {
+  char *from = request, *to = request;
+
+  while (true) {
+    while ((*from == ' ') || (*from == '\t') || (*from == '\r')) from++;
+    if (*from == '\0') return;
+    args.push_back(to);
+    bool quoted = false;
+    for (; *from != '\0'; from++) {
+      if      ((*from == '\\') && (from[1] != '\0'))                                 *to++ = *++from;
+      else if (*from == '"')                                                         quoted = !quoted;
+      else if (!quoted && ((*from == ' ') || (*from == '\t') || (*from == '\r')))    break;
+      else                                                                           *to++ = *from;
+    }
+    if (*from != '\0') from++;
+    *to++ = '\0';
+  }
+}
+
+
+/* Compile a request in a forked process, with its messages going to out_fd (-1: to stdout and stderr).
+ * Returns the exit status of the compilation, or -1 if the request was empty.
+ */
+static int run_request(std::string &request, int out_fd, int (*compile_request)(int argc, char **argv)) {
+  std::vector<char> line(request.begin(), request.end());
+  std::vector<char *> args;
+  line.push_back('\0');
+  args.push_back((char *)"iec2c");
+  split_request(&line[0], args);
+  if (args.size() == 1) return -1;
+  args.push_back(NULL);
+
+  /* do not let the child process print out again whatever is still in our buffers */
+  fflush(stdout);
+  fflush(stderr);
+  pid_t pid = fork();
+  if (pid < 0) {
+    perror("Could not fork the process to compile the request");
+    return EXIT_FAILURE;
+  }
+  if (pid == 0) {
+    if (out_fd >= 0) {
+      dup2(out_fd, STDOUT_FILENO);
+      dup2(out_fd, STDERR_FILENO);
+    }
+    exit(compile_request(args.size() - 1, &args[0]));
+  }
+
+  int status;
+  while (waitpid(pid, &status, 0) < 0)
+    if (errno != EINTR) {perror("waitpid"); return EXIT_FAILURE;}
+  if (WIFEXITED(status))   return WEXITSTATUS(status);
+  if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);  /* i.e. the compiler crashed */
+  return EXIT_FAILURE;
+}
+
+
+static int serve_stdin(int (*compile_request)(int argc, char **argv)) {
+  line_reader_c reader(STDIN_FILENO);
+  std::string   request;
+
+  while (reader.read_line(request)) {
+    int status = run_request(request, -1, compile_request);
+    if (status < 0) continue;
+    printf("END %d\n", status);
+    fflush(stdout);
+  }
+  return EXIT_SUCCESS;
+}
+
+
+static int serve_socket(const char *socket_path, int (*compile_request)(int argc, char **argv)) {
+  struct sockaddr_un addr;
+  int sock;
+
+  if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "Socket path is too long: %s\n", socket_path);
+    return EXIT_FAILURE;
+  }
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, socket_path);
+
+  if ((sock = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+    perror("socket");
+    return EXIT_FAILURE;
+  }
+  /* remove the socket left behind by a previous server (but nothing else!) */
+  struct stat st;
+  if (lstat(socket_path, &st) == 0) {
+    if (!S_ISSOCK(st.st_mode)) {
+      fprintf(stderr, "%s already exists, and is not a socket\n", socket_path);
+      close(sock);
+      return EXIT_FAILURE;
+    }
+    unlink(socket_path);
+  }
+  if ((bind(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0) || (listen(sock, 16) < 0)) {
+    perror(socket_path);
+    close(sock);
+    return EXIT_FAILURE;
+  }
+  /* a client closing the connection early must not kill the server */
+  signal(SIGPIPE, SIG_IGN);
+  fprintf(stderr, "iec2c: compiler server listening on %s\n", socket_path);
+
+  while (true) {
+    int conn = accept(sock, NULL, NULL);
+    if (conn < 0) {
+      if (errno == EINTR) continue;
+      perror("accept");
+      close(sock);
+      return EXIT_FAILURE;
+    }
+    /* a client that does not send its request must not hold up all the others */
+    struct timeval timeout = {REQUEST_TIMEOUT, 0};
+    setsockopt(conn, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    line_reader_c reader(conn);
+    std::string   request;
+    if (reader.read_line(request)) {
+      int status = run_request(request, conn, compile_request);
+      if (status >= 0) {
+        char end[32];
+        int  len = snprintf(end, sizeof(end), "END %d\n", status);
+        if (write(conn, end, len) != len) {/* client is gone, nothing else to do */}
+      }
+    }
+    close(conn);
+  }
+}
+
+
+int server_run(const char *socket_path, int (*compile_request)(int argc, char **argv)) {
+  symbol_c *library;
+
+  /* the standard library, and its symbol tables, shared by all the requests */
+  if (stage1_2_library(&library) < 0)
+    return EXIT_FAILURE;
+  absyntax_utils_init(library);
+
+  if (strcmp(socket_path, "-") == 0)
+    return serve_stdin(compile_request);
+  return serve_socket(socket_path, compile_request);
+}
+
+#endif /* defined(_WIN32) || defined(__WIN32__) */
@@ -0,0 +1,68 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ * The compiler server (-S option).
+ *
+ * Parses the standard library once, and then compiles each request it receives, without
+ * parsing the standard library (and rebuilding its symbol tables) all over again.
+ *
+ * Each request is a single line with the options and the input file of a compilation, exactly
+ * as they would be given on the command line of iec2c (e.g. "-T build -O p project.st"), separated
+ * by white space. Use "double quotes", or a backslash, to include white space in an argument.
+ * The options given to the server itself apply to every request (e.g. -O options), and the
+ * options that change how the standard library is parsed (-I, -p, -s, -r, ...) may only be
+ * given to the server.
+ *
+ * The requests are read:
+ *   - from stdin (-S -): the messages of the compiler go to the stdout and stderr of the server,
+ *     and each request is followed by a line "END <exit status>" on stdout.
+ *   - from a unix domain socket (-S <path>): each client connects, sends a single request,
+ *     and then reads the messages of the compiler followed by the line "END <exit status>",
+ *     until the server closes the connection. The requests are handled one at a time, so a client
+ *     that does not send its request in time is disconnected. An existing socket at <path> (left
+ *     behind by a previous server) is replaced, but any other file is left alone.
+ *
+ * Each request is compiled by a process forked from the server, so all the memory allocated
+ * while compiling it (the AST of the input file, the symbol tables, ...) is freed when that
+ * process exits, and the server is always left with just the standard library. This also
+ * means that the compiler bailing out on an error (which simply calls exit()) only ends
+ * the request it was compiling.
+ */
+
+
+
+#ifndef _SERVER_HH
+#define _SERVER_HH
+
+
+/* Run the compiler server, reading the requests from socket_path ("-": from stdin).
+ * compile_request() is called (in the process forked for each request) with the arguments
+ * of the request, as in main() (i.e. argv[0] is the program name).
+ * Only returns on error, or at the end of stdin.
+ */
+int server_run(const char *socket_path, int (*compile_request)(int argc, char **argv));
+
+
+#endif /*  _SERVER_HH */
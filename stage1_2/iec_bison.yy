@@ -101,6 +101,7 @@ void yyerror (const char *error_msg);
 /* The interface through which bison and flex interact. */
 #include "stage1_2_priv.hh"
 #include "create_enumtype_conversion_functions.hh"
+#include "library_cache.hh"
 
 #include "../absyntax_utils/add_en_eno_param_decl.hh"	/* required for  add_en_eno_param_decl_c */
 
@@ -286,7 +287,7 @@ typedef struct YYLTYPE {
 %union {
     symbol_c 	*leaf;
     list_c	*list;
-    char 	*ID;	/* token value */
+    const char	*ID;	/* token value (interned in the string pool, see absyntax/string_pool.hh) */
 }
 
 /*
@@ -4931,7 +4932,7 @@ standard_function_name_simpleop_clashes:
 /* standard_function_name_NOT_clashes is only used in function invocations, so we use the poutype_identifier_c class! */
 standard_function_name_NOT_clashes:
   NOT
-	{$$ = new poutype_identifier_c(strdup("NOT"), locloc(@$));}
+	{$$ = new poutype_identifier_c("NOT", locloc(@$));}
 ;
 
 /* Add here any other IL simple operators that collide
@@ -4948,20 +4949,20 @@ standard_function_name_simpleop_only_clashes:
 
 /* standard_function_name_expression_clashes is only used in function invocations, so we use the poutype_identifier_c class! */
 standard_function_name_expression_clashes:
-  AND	{$$ = new poutype_identifier_c(strdup("AND"), locloc(@$));}
-| OR	{$$ = new poutype_identifier_c(strdup("OR"), locloc(@$));}
-| XOR	{$$ = new poutype_identifier_c(strdup("XOR"), locloc(@$));}
-| ADD	{$$ = new poutype_identifier_c(strdup("ADD"), locloc(@$));}
-| SUB	{$$ = new poutype_identifier_c(strdup("SUB"), locloc(@$));}
-| MUL	{$$ = new poutype_identifier_c(strdup("MUL"), locloc(@$));}
-| DIV	{$$ = new poutype_identifier_c(strdup("DIV"), locloc(@$));}
-| MOD	{$$ = new poutype_identifier_c(strdup("MOD"), locloc(@$));}
-| GT	{$$ = new poutype_identifier_c(strdup("GT"), locloc(@$));}
-| GE	{$$ = new poutype_identifier_c(strdup("GE"), locloc(@$));}
-| EQ	{$$ = new poutype_identifier_c(strdup("EQ"), locloc(@$));}
-| LT	{$$ = new poutype_identifier_c(strdup("LT"), locloc(@$));}
-| LE	{$$ = new poutype_identifier_c(strdup("LE"), locloc(@$));}
-| NE	{$$ = new poutype_identifier_c(strdup("NE"), locloc(@$));}
+  AND	{$$ = new poutype_identifier_c("AND", locloc(@$));}
+| OR	{$$ = new poutype_identifier_c("OR", locloc(@$));}
+| XOR	{$$ = new poutype_identifier_c("XOR", locloc(@$));}
+| ADD	{$$ = new poutype_identifier_c("ADD", locloc(@$));}
+| SUB	{$$ = new poutype_identifier_c("SUB", locloc(@$));}
+| MUL	{$$ = new poutype_identifier_c("MUL", locloc(@$));}
+| DIV	{$$ = new poutype_identifier_c("DIV", locloc(@$));}
+| MOD	{$$ = new poutype_identifier_c("MOD", locloc(@$));}
+| GT	{$$ = new poutype_identifier_c("GT", locloc(@$));}
+| GE	{$$ = new poutype_identifier_c("GE", locloc(@$));}
+| EQ	{$$ = new poutype_identifier_c("EQ", locloc(@$));}
+| LT	{$$ = new poutype_identifier_c("LT", locloc(@$));}
+| LE	{$$ = new poutype_identifier_c("LE", locloc(@$));}
+| NE	{$$ = new poutype_identifier_c("NE", locloc(@$));}
 /*
   AND_operator	{$$ = il_operator_c_2_poutype_identifier_c($1);}
 //NOTE: AND2 (corresponding to the source code string '&') does not clash
@@ -5667,20 +5668,20 @@ action_qualifier:
 ;
 
 qualifier:
-  N		{$$ = new qualifier_c(strdup("N"), locloc(@$));}
-| R		{$$ = new qualifier_c(strdup("R"), locloc(@$));}
-| S		{$$ = new qualifier_c(strdup("S"), locloc(@$));}
-| P		{$$ = new qualifier_c(strdup("P"), locloc(@$));}
-| P0	{$$ = new qualifier_c(strdup("P0"), locloc(@$));}
-| P1	{$$ = new qualifier_c(strdup("P1"), locloc(@$));}
+  N		{$$ = new qualifier_c("N", locloc(@$));}
+| R		{$$ = new qualifier_c("R", locloc(@$));}
+| S		{$$ = new qualifier_c("S", locloc(@$));}
+| P		{$$ = new qualifier_c("P", locloc(@$));}
+| P0	{$$ = new qualifier_c("P0", locloc(@$));}
+| P1	{$$ = new qualifier_c("P1", locloc(@$));}
 ;
 
 timed_qualifier:
-  L		{$$ = new timed_qualifier_c(strdup("L"), locloc(@$));}
-| D		{$$ = new timed_qualifier_c(strdup("D"), locloc(@$));}
-| SD		{$$ = new timed_qualifier_c(strdup("SD"), locloc(@$));}
-| DS		{$$ = new timed_qualifier_c(strdup("DS"), locloc(@$));}
-| SL		{$$ = new timed_qualifier_c(strdup("SL"), locloc(@$));}
+  L		{$$ = new timed_qualifier_c("L", locloc(@$));}
+| D		{$$ = new timed_qualifier_c("D", locloc(@$));}
+| SD		{$$ = new timed_qualifier_c("SD", locloc(@$));}
+| DS		{$$ = new timed_qualifier_c("DS", locloc(@$));}
+| SL		{$$ = new timed_qualifier_c("SL", locloc(@$));}
 ;
 
 /* NOTE: A step_name may be used as a structured vaqriable, in order to access the status bit (e.g. Step1.X) 
@@ -8620,7 +8621,7 @@ identifier_c *token_2_identifier_c(char *value, ) {
  */
 poutype_identifier_c *il_operator_c_2_poutype_identifier_c(symbol_c *il_operator) {
   identifier_c         *    id = il_operator_c_2_identifier_c(il_operator);
-  poutype_identifier_c *pou_id = new poutype_identifier_c(strdup(id->value));
+  poutype_identifier_c *pou_id = new poutype_identifier_c(id->value);
 
   *(symbol_c *)pou_id = *(symbol_c *)id;
   delete id;
@@ -8695,7 +8696,7 @@ identifier_c *il_operator_c_2_identifier_c(symbol_c *il_operator) {
   if (name == NULL)
     ERROR;
 /*
-  res = new identifier_c(strdup(name), 
+  res = new identifier_c(name, 
                          il_operator->first_line,
                          il_operator->first_column,
                          il_operator->first_file,
@@ -8707,7 +8708,7 @@ identifier_c *il_operator_c_2_identifier_c(symbol_c *il_operator) {
                         );
   free(il_operator);
 */
-  res = new identifier_c(strdup(name));
+  res = new identifier_c(name);
   *(symbol_c *)res = *(symbol_c *)il_operator;
   delete il_operator;
   
@@ -8743,8 +8744,7 @@ NULL
 extern const char *INCLUDE_DIRECTORIES[];
 
 
-static int parse_files(const char *libfilename, const char *filename) {
-  /* first parse the standard library file... */  
+static int parse_library_file(const char *libfilename) {
   /*   Do not debug the standard library, even if debug flag is set!
   #if YYDEBUG
     yydebug = 1;
@@ -8782,7 +8782,14 @@ static int parse_files(const char *libfilename, const char *filename) {
         library_element_symtable.end())
       library_element_symtable.insert(standard_function_block_names[i], standard_function_block_name_token);
 
-  /* now parse the input file... */
+  /* store the result in the library cache (if enabled with the -L option) for later compiler runs... */
+  /* NOTE: When pre-parsing the AST is not complete, so we only store the library_element_symtable */
+  library_cache_save(libfilename, get_preparse_state()? NULL : tree_root);
+  return 0;
+}
+
+
+static int parse_input_file(const char *filename) {
   #if YYDEBUG
     yydebug = 1;
   #endif
@@ -8816,6 +8823,21 @@ static int parse_files(const char *libfilename, const char *filename) {
 }  
 
 
+static int parse_files(const char *libfilename, const char *filename) {
+  int res;
+
+  /* first load the standard library from the cache (if enabled with the -L option)... */
+  /* NOTE: When pre-parsing the library AST will be thrown away, so we do not bother loading it. */
+  if (library_cache_load(libfilename, get_preparse_state()? NULL : &tree_root) < 0)
+    /* ...or parse the standard library file. */
+    if ((res = parse_library_file(libfilename)) < 0)
+      return res;
+
+  /* now parse the input file... */
+  return parse_input_file(filename);
+}  
+
+
 
 
 
@@ -8848,12 +8870,15 @@ static int parse_files(const char *libfilename, const char *filename) {
  *  datatypes will also already be in the library_element_symtable!
  */
 
-int stage2__(const char *filename, 
-             symbol_c **tree_root_ref
-            ) {             
+
+/* The standard library, when kept resident by stage2__library() */
+static symbol_c *resident_library = NULL;
+
+
+/* Determine the full path name of the standard library file... */
+static char *library_file_name(void) {
   char *libfilename = NULL;
 
-  /* Determine the full path name of the standard library file... */
   if (runtime_options.includedir != NULL)
     INCLUDE_DIRECTORIES[0] = runtime_options.includedir;
 
@@ -8861,6 +8886,65 @@ int stage2__(const char *filename,
     fprintf (stderr, "Out of memory. Bailing out!\n");
     exit(EXIT_FAILURE);
   }
+  return libfilename;
+}
+
+
+/* Parse (or load from the cache) only the standard library, and keep its AST and the
+ * library_element_symtable for the following calls to stage2__(), that will then only parse
+ * their input file, appending its library elements to the same AST.
+ *
+ * Used by the compiler server (-S), that forks a new process to handle each request,
+ * so the AST and the library_element_symtable of the parent process only ever contain
+ * the standard library.
+ *
+ * NOTE: The standard library does not use forward references, so it is always parsed
+ *       without pre-parsing. The input files will still be pre-parsed (with the -p option),
+ *       only now after (and not before) the standard library has been parsed, which makes
+ *       no difference unless they re-declare any of the library elements.
+ */
+int stage2__library(symbol_c **tree_root_ref) {
+  char *libfilename = library_file_name();
+  int res;
+
+  tree_root = NULL;
+  rst_preparse_state();
+  if (library_cache_load(libfilename, &tree_root) < 0)
+    if ((res = parse_library_file(libfilename)) < 0)
+      return res;
+  free(libfilename);
+
+  /* the library rule only creates the library_c when it has at least one element */
+  if (tree_root == NULL)
+    tree_root = new library_c();
+  resident_library = tree_root;
+  if (tree_root_ref != NULL)
+    *tree_root_ref = tree_root;
+  return 0;
+}
+
+
+int stage2__(const char *filename, 
+             symbol_c **tree_root_ref
+            ) {             
+  /* Standard library already parsed by stage2__library(), so only parse the input file... */
+  if (resident_library != NULL) {
+    if (runtime_options.pre_parsing) {
+      tree_root = NULL;
+      set_preparse_state();
+      if (parse_input_file(filename) < 0)
+        exit(EXIT_FAILURE);
+    }
+    tree_root = resident_library;
+    rst_preparse_state();
+    if (parse_input_file(filename) < 0)
+      exit(EXIT_FAILURE);
+    if (tree_root_ref != NULL)
+      *tree_root_ref = tree_root;
+    return 0;
+  }
+
+  char *libfilename = library_file_name();
 
   /*******************************/
   /* Do the  PRE parsing run...! */
@@ -0,0 +1,742 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * The standard library cache.
+ *
+ * Parsing the standard library (ieclib.txt and all the files it includes) is a fixed
+ * cost paid on every invocation of the compiler (twice when pre-parsing is enabled),
+ * and it dominates the compile time of small source files.
+ *
+ * When the -L <cache_directory> option is given, the AST obtained from parsing the
+ * standard library, together with the contents of the library_element_symtable, is
+ * stored in a binary file inside <cache_directory>. Later invocations will map this
+ * file into memory (using mmap() when available) and rebuild the AST from it, instead
+ * of parsing the library all over again. Token values and file names in the rebuilt
+ * AST point directly into the mapped file.
+ *
+ * The name of the cache file is built from a hash of the compiler build and of the
+ * command line options that change the way the library is parsed. Inside the cache
+ * file we store the list of source files that contributed to the AST, together with
+ * a hash of their contents. A cache file whose library sources have since been changed
+ * is ignored (and later overwritten).
+ *
+ * NOTE: included files that do not contain a single token (e.g. only comments) do not
+ *       show up in the AST, and are therefore not checked for changes. Any change
+ *       to the list of included files, however, will change ieclib.txt itself.
+ *
+ * NOTE: The function_symtable, type_symtable, etc. are not stored in the cache, as they
+ *       are filled in by absyntax_utils_init() walking the complete AST (library + user
+ *       code) after stage 1_2 has completed.
+ *
+ * File layout (all integers in native byte order - the cache is not meant to be shared
+ * between platforms, which is why the pointer size and the compiler build are part of
+ * the hash used to name the file):
+ *    header_t
+ *    dep_t      deps     [header.dep_count]       -- source files of the standard library
+ *    node_t     nodes    [header.node_count]      -- index 0 is reserved for NULL
+ *    element_t  elements [header.element_count]   -- elements of all the lists, one list after the other
+ *    entry_t    entries  [header.entry_count]     -- the (name, token) pairs in library_element_symtable
+ *    char       strings  [header.strings_size]    -- '\0' terminated strings. Offset 0 is reserved for NULL
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <map>
+
+#include "../config/config.h"
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
+#include "../absyntax/absyntax.hh"
+#include "../absyntax/visitor.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "iec_bison.hh"
+#include "stage1_2_priv.hh"
+#include "library_cache.hh"
+
+
+
+#define CACHE_MAGIC   "IECLIBC"
+#define CACHE_VERSION 1
+#define CACHE_MAXREFS 6   /* SYM_REF6 is the largest AST class */
+
+
+/* The identifier of each class of the AST, as stored in the cache file */
+#define SYM_LIST(class_name_c, ...)                                       class_name_c##_cid,
+#define SYM_TOKEN(class_name_c, ...)                                      class_name_c##_cid,
+#define SYM_REF0(class_name_c, ...)                                       class_name_c##_cid,
+#define SYM_REF1(class_name_c, ref1, ...)                                 class_name_c##_cid,
+#define SYM_REF2(class_name_c, ref1, ref2, ...)                           class_name_c##_cid,
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                     class_name_c##_cid,
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)               class_name_c##_cid,
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)         class_name_c##_cid,
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)   class_name_c##_cid,
+
+typedef enum {
+  null_cid = 0,
+  #include "../absyntax/absyntax.def"
+  cid_count
+} class_id_t;
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+/* The kind of each class of the AST, indexed by class_id_t */
+typedef enum {ref_kind, list_kind, token_kind} node_kind_t;
+
+#define SYM_LIST(class_name_c, ...)                                       list_kind,
+#define SYM_TOKEN(class_name_c, ...)                                      token_kind,
+#define SYM_REF0(class_name_c, ...)                                       ref_kind,
+#define SYM_REF1(class_name_c, ref1, ...)                                 ref_kind,
+#define SYM_REF2(class_name_c, ref1, ref2, ...)                           ref_kind,
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                     ref_kind,
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)               ref_kind,
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)         ref_kind,
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)   ref_kind,
+
+static const node_kind_t class_kind[cid_count] = {
+  ref_kind, /* null_cid */
+  #include "../absyntax/absyntax.def"
+};
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+
+typedef struct {
+  char     magic[8];
+  uint32_t version;
+  uint32_t root;           /* index of the library_c node */
+  uint64_t key;            /* must be the same as the key used to name the file */
+  int64_t  next_order;     /* value of the token order counter in flex after parsing the library */
+  uint32_t dep_count;
+  uint32_t node_count;
+  uint32_t element_count;
+  uint32_t entry_count;
+  uint64_t strings_size;
+} header_t;
+
+typedef struct {
+  uint32_t filename;       /* name of the file, as used in the AST (string offset) */
+  uint32_t fullname;       /* the file we read when hashing its contents (string offset) */
+  uint64_t hash;           /* hash of the file contents */
+} dep_t;
+
+typedef struct {
+  uint32_t class_id;
+  uint32_t parent;         /* node index */
+  uint32_t token;          /* node index */
+  uint32_t value;          /* token_c: the token value (string offset); list_c: index of first element in elements[] */
+  uint32_t element_count;  /* list_c only */
+  int32_t  first_line, first_column, last_line, last_column;
+  uint32_t first_file, last_file;  /* string offset */
+  int64_t  first_order, last_order;
+  uint32_t ref[CACHE_MAXREFS];     /* node index */
+} node_t;
+
+typedef struct {
+  uint32_t symbol;         /* node index */
+  uint32_t token_value;    /* string offset */
+} element_t;
+
+typedef struct {
+  uint32_t name;           /* string offset */
+  int32_t  token;          /* bison token id */
+} entry_t;
+
+
+
+
+/***************************************/
+/* Hashing and file utility functions. */
+/***************************************/
+
+/* 64 bit FNV-1a */
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t len) {
+  const unsigned char *p = (const unsigned char *)data;
+  for (size_t i = 0; i < len; i++) {hash ^= p[i]; hash *= 0x100000001b3ULL;}
+  return hash;
+}
+
+static uint64_t hash_str (uint64_t hash, const char *str) {return hash_bytes(hash, str, strlen(str) + 1);}
+static uint64_t hash_bool(uint64_t hash, bool value)      {char c = value; return hash_bytes(hash, &c, 1);}
+
+static const uint64_t hash_init = 0xcbf29ce484222325ULL;
+
+
+/* hash the contents of a file. Returns false if the file could not be read. */
+static bool hash_file(const char *filename, uint64_t *hash) {
+  FILE *f = fopen(filename, "rb");
+  if (NULL == f) return false;
+
+  char   buf[16384];
+  size_t len;
+  *hash = hash_init;
+  while ((len = fread(buf, 1, sizeof(buf), f)) > 0)
+    *hash = hash_bytes(*hash, buf, len);
+  bool ok = !ferror(f);
+  fclose(f);
+  return ok;
+}
+
+
+/* The key identifying the cache file. It must change whenever the AST or the token ids
+ * produced by parsing the same library could change, i.e. when the compiler is rebuilt,
+ * or when any of the command line options used by stage 1_2 is changed.
+ */
+static uint64_t cache_key(const char *libfilename) {
+  uint64_t key = hash_init;
+  key = hash_str (key, PACKAGE_VERSION);
+  key = hash_str (key, __DATE__ " " __TIME__);   /* the build of this compiler */
+  key = hash_bytes(key, "\x01\x02\x03\x04", 4);  /* byte order... */
+  char ptr_size = sizeof(void *);
+  key = hash_bytes(key, &ptr_size, 1);
+  key = hash_str (key, libfilename);
+  key = hash_bool(key, runtime_options.allow_void_datatype);
+  key = hash_bool(key, runtime_options.allow_missing_var_in);
+  key = hash_bool(key, runtime_options.disable_implicit_en_eno);
+  key = hash_bool(key, runtime_options.safe_extensions);
+  key = hash_bool(key, runtime_options.conversion_functions);
+  key = hash_bool(key, runtime_options.nested_comments);
+  key = hash_bool(key, runtime_options.ref_standard_extensions);
+  key = hash_bool(key, runtime_options.ref_nonstand_extensions);
+  key = hash_bool(key, runtime_options.nonliteral_in_array_size);
+  return key;
+}
+
+
+/* full path name of the cache file. Must be free()'d by the caller. */
+static char *cache_filename(uint64_t key) {
+  char keystr[32];
+  snprintf(keystr, sizeof(keystr), "/ieclib-%016" PRIx64 ".cache", key);
+  return strdup2(runtime_options.library_cache_dir, keystr);
+}
+
+
+extern const char *INCLUDE_DIRECTORIES[];
+
+/* Find the file that flex opened when it came across the file name used in the AST.
+ * Included files are searched for in the same way as is done by include_file() in flex.
+ * Returns a malloc()'d string, or NULL if not found.
+ */
+static char *find_source_file(const char *filename, const char *libfilename) {
+  if (strcmp(filename, libfilename) == 0)
+    return strdup(libfilename);
+
+  for (int i = 0; INCLUDE_DIRECTORIES[i] != NULL; i++) {
+    char *full_name = strdup3(INCLUDE_DIRECTORIES[i], "/", filename);
+    if (full_name == NULL) return NULL;
+    if (access(full_name, R_OK) == 0) return full_name;
+    free(full_name);
+  }
+  return NULL;
+}
+
+
+
+
+/*******************************************************/
+/* Access to the class specific data of each AST node. */
+/*******************************************************/
+/* Used both when writing (get the class and the references to other nodes)
+ * and when reading (set the references to other nodes) the cache.
+ */
+class node_access_c: public visitor_c {
+  public:
+    bool        setting;                /* false: copy refs from node to ref[]; true: copy ref[] into node */
+    class_id_t  class_id;
+    symbol_c   *ref[CACHE_MAXREFS];
+
+  private:
+    void access(symbol_c *&node_ref, int i) {if (setting) node_ref = ref[i]; else ref[i] = node_ref;}
+    void init  (class_id_t cid)             {class_id = cid; if (!setting) for (int i = 0; i < CACHE_MAXREFS; i++) ref[i] = NULL;}
+
+  public:
+    #define SYM_LIST(class_name_c, ...)                                     \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); return NULL;}
+    #define SYM_TOKEN(class_name_c, ...)                                    \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); return NULL;}
+    #define SYM_REF0(class_name_c, ...)                                     \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); return NULL;}
+    #define SYM_REF1(class_name_c, ref1, ...)                               \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); \
+        access(symbol->ref1, 0); return NULL;}
+    #define SYM_REF2(class_name_c, ref1, ref2, ...)                         \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); \
+        access(symbol->ref1, 0); access(symbol->ref2, 1); return NULL;}
+    #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                   \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); \
+        access(symbol->ref1, 0); access(symbol->ref2, 1); access(symbol->ref3, 2); return NULL;}
+    #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)             \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); \
+        access(symbol->ref1, 0); access(symbol->ref2, 1); access(symbol->ref3, 2); access(symbol->ref4, 3); return NULL;}
+    #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)       \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); \
+        access(symbol->ref1, 0); access(symbol->ref2, 1); access(symbol->ref3, 2); access(symbol->ref4, 3); \
+        access(symbol->ref5, 4); return NULL;}
+    #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...) \
+      void *visit(class_name_c *symbol) {init(class_name_c##_cid); \
+        access(symbol->ref1, 0); access(symbol->ref2, 1); access(symbol->ref3, 2); access(symbol->ref4, 3); \
+        access(symbol->ref5, 4); access(symbol->ref6, 5); return NULL;}
+
+    #include "../absyntax/absyntax.def"
+
+    #undef SYM_LIST
+    #undef SYM_TOKEN
+    #undef SYM_REF0
+    #undef SYM_REF1
+    #undef SYM_REF2
+    #undef SYM_REF3
+    #undef SYM_REF4
+    #undef SYM_REF5
+    #undef SYM_REF6
+};
+
+
+/* Create a new (empty) AST node of the requested class */
+static symbol_c *new_node(uint32_t class_id, const char *value) {
+  switch (class_id) {
+    #define SYM_LIST(class_name_c, ...)                                     case class_name_c##_cid: return new class_name_c();
+    #define SYM_TOKEN(class_name_c, ...)                                    case class_name_c##_cid: return new class_name_c(value);
+    #define SYM_REF0(class_name_c, ...)                                     case class_name_c##_cid: return new class_name_c();
+    #define SYM_REF1(class_name_c, ref1, ...)                               case class_name_c##_cid: return new class_name_c(NULL);
+    #define SYM_REF2(class_name_c, ref1, ref2, ...)                         case class_name_c##_cid: return new class_name_c(NULL, NULL);
+    #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                   case class_name_c##_cid: return new class_name_c(NULL, NULL, NULL);
+    #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)             case class_name_c##_cid: return new class_name_c(NULL, NULL, NULL, NULL);
+    #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)       case class_name_c##_cid: return new class_name_c(NULL, NULL, NULL, NULL, NULL);
+    #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...) case class_name_c##_cid: return new class_name_c(NULL, NULL, NULL, NULL, NULL, NULL);
+
+    #include "../absyntax/absyntax.def"
+
+    #undef SYM_LIST
+    #undef SYM_TOKEN
+    #undef SYM_REF0
+    #undef SYM_REF1
+    #undef SYM_REF2
+    #undef SYM_REF3
+    #undef SYM_REF4
+    #undef SYM_REF5
+    #undef SYM_REF6
+    default: break;
+  }
+  return NULL; /* corrupted cache file */
+}
+
+
+
+
+/************************/
+/* Writing the cache... */
+/************************/
+
+/* The contents of the library_element_symtable right after parsing the standard library.
+ * We must take this snapshot during the first parsing of the library (which may be the
+ * pre-parsing), since the user's POU and datatype names found during pre-parsing will
+ * also be in the library_element_symtable during the normal parsing run.
+ */
+static std::vector<std::pair<std::string, int> > symtable_snapshot;
+static bool symtable_snapshot_taken = false;
+
+
+class cache_writer_c {
+  private:
+    std::vector<symbol_c *>         nodes;
+    std::map<symbol_c *, uint32_t>  node_index;
+    std::string                     strings;
+    std::map<std::string, uint32_t> string_index;
+
+    uint32_t add_string(const char *str) {
+      if (NULL == str) return 0;
+      std::map<std::string, uint32_t>::iterator i = string_index.find(str);
+      if (i != string_index.end()) return i->second;
+      uint32_t offset = strings.size();
+      strings.append(str, strlen(str) + 1);
+      string_index[str] = offset;
+      return offset;
+    }
+
+    uint32_t add_node(symbol_c *symbol) {
+      if (NULL == symbol) return 0;
+      std::map<symbol_c *, uint32_t>::iterator i = node_index.find(symbol);
+      if (i != node_index.end()) return i->second;
+      uint32_t index = nodes.size();
+      nodes.push_back(symbol);
+      node_index[symbol] = index;
+      return index;
+    }
+
+  public:
+    cache_writer_c(void) {nodes.push_back(NULL); strings.push_back('\0');}
+
+    bool write(FILE *f, uint64_t key, const char *libfilename, symbol_c *tree_root) {
+      node_access_c           node_access;
+      std::vector<node_t>     node_recs;
+      std::vector<element_t>  elements;
+      std::vector<dep_t>      deps;
+      std::vector<entry_t>    entries;
+      std::map<std::string, bool> files;
+
+      node_access.setting = false;
+      add_node(tree_root);
+      /* NOTE: nodes.size() grows as we go along, as we add every node referenced by the current node! */
+      for (uint32_t n = 1; n < nodes.size(); n++) {
+        symbol_c *symbol = nodes[n];
+        node_t    rec;
+        memset(&rec, 0, sizeof(rec));
+
+        symbol->accept(node_access);
+        rec.class_id     = node_access.class_id;
+        rec.parent       = add_node(symbol->parent);
+        rec.token        = add_node(symbol->token);
+        rec.first_line   = symbol->first_line;
+        rec.first_column = symbol->first_column;
+        rec.first_file   = add_string(symbol->first_file);
+        rec.first_order  = symbol->first_order;
+        rec.last_line    = symbol->last_line;
+        rec.last_column  = symbol->last_column;
+        rec.last_file    = add_string(symbol->last_file);
+        rec.last_order   = symbol->last_order;
+        if (NULL != symbol->first_file) files[symbol->first_file] = true;
+        if (NULL != symbol->last_file ) files[symbol->last_file ] = true;
+
+        switch (class_kind[node_access.class_id]) {
+          case token_kind:
+            rec.value = add_string(dynamic_cast<token_c *>(symbol)->value);
+            break;
+          case list_kind: {
+            list_c *list = dynamic_cast<list_c *>(symbol);
+            rec.value         = elements.size();
+            rec.element_count = list->n;
+            for (int i = 0; i < list->n; i++) {
+              element_t elem;
+              elem.symbol      = add_node(list->get_element(i));
+              elem.token_value = add_string(list->get_element_token_value(i));
+              elements.push_back(elem);
+            }
+            break;
+          }
+          case ref_kind:
+            for (int i = 0; i < CACHE_MAXREFS; i++)
+              rec.ref[i] = add_node(node_access.ref[i]);
+            break;
+        }
+        node_recs.push_back(rec);
+      }
+
+      /* the source files of the library... */
+      for (std::map<std::string, bool>::iterator i = files.begin(); i != files.end(); i++) {
+        if (i->first.empty()) continue; /* code inserted by include_string() (e.g. enum conversion functions). */
+        char *fullname = find_source_file(i->first.c_str(), libfilename);
+        dep_t dep;
+        if ((NULL == fullname) || !hash_file(fullname, &dep.hash)) {free(fullname); return false;}
+        dep.filename = add_string(i->first.c_str());
+        dep.fullname = add_string(fullname);
+        deps.push_back(dep);
+        free(fullname);
+      }
+
+      /* the library_element_symtable... */
+      for (size_t i = 0; i < symtable_snapshot.size(); i++) {
+        entry_t entry;
+        entry.name  = add_string(symtable_snapshot[i].first.c_str());
+        entry.token = symtable_snapshot[i].second;
+        entries.push_back(entry);
+      }
+
+      header_t header;
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+      header.version       = CACHE_VERSION;
+      header.root          = 1;
+      header.key           = key;
+      header.next_order    = get_current_order();
+      header.dep_count     = deps.size();
+      header.node_count    = nodes.size();  /* includes the NULL node at index 0 */
+      header.element_count = elements.size();
+      header.entry_count   = entries.size();
+      header.strings_size  = strings.size();
+
+      node_t null_rec;
+      memset(&null_rec, 0, sizeof(null_rec));
+      return (   (fwrite(&header, sizeof(header), 1, f) == 1)
+              && (fwrite(deps.data(),      sizeof(dep_t),     deps.size(),      f) == deps.size())
+              && (fwrite(&null_rec,        sizeof(node_t),    1,                f) == 1)
+              && (fwrite(node_recs.data(), sizeof(node_t),    node_recs.size(), f) == node_recs.size())
+              && (fwrite(elements.data(),  sizeof(element_t), elements.size(),  f) == elements.size())
+              && (fwrite(entries.data(),   sizeof(entry_t),   entries.size(),   f) == entries.size())
+              && (fwrite(strings.data(),   1,                 strings.size(),   f) == strings.size()));
+    }
+};
+
+
+
+void library_cache_save(const char *libfilename, symbol_c *tree_root) {
+  if (NULL == runtime_options.library_cache_dir) return;
+
+  if (!symtable_snapshot_taken) {
+    library_element_symtable_t::iterator i;
+    for (i = library_element_symtable.begin(); i != library_element_symtable.end(); i++)
+      symtable_snapshot.push_back(std::pair<std::string, int>(i->first, i->second));
+    symtable_snapshot_taken = true;
+  }
+
+  if (NULL == tree_root) return;  /* pre-parsing. AST is not complete! */
+
+  uint64_t key      = cache_key(libfilename);
+  char    *filename = cache_filename(key);
+  char     pidstr[32];
+  snprintf(pidstr, sizeof(pidstr), ".%ld", (long)getpid());
+  char    *tmpname  = strdup2(filename, pidstr);
+  if ((NULL == filename) || (NULL == tmpname)) {
+    fprintf (stderr, "Out of memory. Bailing out!\n");
+    exit(EXIT_FAILURE);
+  }
+
+  /* Write to a temporary file, and then rename it, so concurrent compiler invocations never see an incomplete cache file. */
+  /* A cache that cannot be written is not an error - we simply carry on without it. */
+  FILE *f = fopen(tmpname, "wb");
+  if (NULL != f) {
+    cache_writer_c writer;
+    bool ok = writer.write(f, key, libfilename, tree_root);
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || (rename(tmpname, filename) != 0))
+      remove(tmpname);
+  }
+
+  free(tmpname);
+  free(filename);
+}
+
+
+
+
+/************************/
+/* Reading the cache... */
+/************************/
+
+/* Map the file into memory (read-only data, private copy-on-write mapping). Returns NULL on error */
+static char *map_file(const char *filename, size_t *size) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) return NULL;
+
+  struct stat st;
+  char *data = NULL;
+  if ((fstat(fd, &st) == 0) && (st.st_size >= (off_t)sizeof(header_t))) {
+    *size = st.st_size;
+#ifdef HAVE_SYS_MMAN_H
+    data = (char *)mmap(NULL, *size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (MAP_FAILED == data) data = NULL;
+#else
+    data = (char *)malloc(*size);
+    if ((NULL != data) && (read(fd, data, *size) != (ssize_t)*size)) {free(data); data = NULL;}
+#endif
+  }
+  close(fd);
+  return data;
+}
+
+static void unmap_file(char *data, size_t size) {
+#ifdef HAVE_SYS_MMAN_H
+  munmap(data, size);
+#else
+  free(data);
+#endif
+}
+
+
+/* Check that the cache file is complete and consistent, and was built from the same library sources. */
+static bool check_cache(char *data, size_t size, uint64_t key) {
+  header_t *header = (header_t *)data;
+
+  if (memcmp(header->magic, CACHE_MAGIC, sizeof(header->magic)) != 0) return false;
+  if (header->version != CACHE_VERSION) return false;
+  if (header->key     != key)           return false;
+
+  uint64_t expected_size =   (uint64_t)sizeof(header_t)
+                           + (uint64_t)header->dep_count     * sizeof(dep_t)
+                           + (uint64_t)header->node_count    * sizeof(node_t)
+                           + (uint64_t)header->element_count * sizeof(element_t)
+                           + (uint64_t)header->entry_count   * sizeof(entry_t)
+                           +           header->strings_size;
+  if (expected_size != size)                                             return false;
+  if ((header->node_count < 2) || (header->root >= header->node_count))  return false;
+  if ((header->strings_size == 0) || (data[size - 1] != '\0'))           return false;
+
+  dep_t *deps    = (dep_t *)(data + sizeof(header_t));
+  char  *strings = data + size - header->strings_size;
+  for (uint32_t i = 0; i < header->dep_count; i++) {
+    uint64_t hash;
+    if (deps[i].fullname >= header->strings_size)           return false;
+    if (!hash_file(strings + deps[i].fullname, &hash))      return false;
+    if (hash != deps[i].hash)                               return false;
+  }
+  return true;
+}
+
+
+int library_cache_load(const char *libfilename, symbol_c **tree_root_ref) {
+  if (NULL == runtime_options.library_cache_dir) return -1;
+
+  uint64_t key      = cache_key(libfilename);
+  char    *filename = cache_filename(key);
+  size_t   size     = 0;
+  char    *data     = (NULL == filename)? NULL : map_file(filename, &size);
+  free(filename);
+  if (NULL == data) return -1;
+
+  if (!check_cache(data, size, key)) {
+    unmap_file(data, size);
+    return -1;
+  }
+
+  header_t  *header   = (header_t  *) data;
+  node_t    *recs     = (node_t    *)(data + sizeof(header_t) + header->dep_count * sizeof(dep_t));
+  element_t *elements = (element_t *)(recs     + header->node_count);
+  entry_t   *entries  = (entry_t   *)(elements + header->element_count);
+  char      *strings  =               (char *)(entries  + header->entry_count);
+  #define STR(offset)  (((offset) == 0)? NULL : strings + (offset))
+
+  /* Validate every index in the file before we start building the AST */
+  for (uint32_t n = 1; n < header->node_count; n++) {
+    node_t *rec = &recs[n];
+    bool ok =    (rec->class_id   > null_cid) && (rec->class_id < cid_count)
+              && (rec->parent     < header->node_count) && (rec->token     < header->node_count)
+              && (rec->first_file < header->strings_size) && (rec->last_file < header->strings_size);
+    if (ok && (class_kind[rec->class_id] == token_kind)) ok = (rec->value < header->strings_size);
+    if (ok && (class_kind[rec->class_id] == list_kind )) ok = ((uint64_t)rec->value + rec->element_count <= header->element_count);
+    for (int i = 0; i < CACHE_MAXREFS; i++) ok = ok && (rec->ref[i] < header->node_count);
+    if (!ok) {unmap_file(data, size); return -1;}
+  }
+  for (uint32_t e = 0; e < header->element_count; e++)
+    if ((elements[e].symbol >= header->node_count) || (elements[e].token_value >= header->strings_size))
+      {unmap_file(data, size); return -1;}
+  for (uint32_t e = 0; e < header->entry_count; e++)
+    if (entries[e].name >= header->strings_size)
+      {unmap_file(data, size); return -1;}
+
+  /* The library_element_symtable... */
+  for (uint32_t e = 0; e < header->entry_count; e++)
+    library_element_symtable.insert(strings + entries[e].name, entries[e].token);
+  /* also keep it in case we are asked to save the cache again later (should never really happen) */
+  if (!symtable_snapshot_taken) {
+    for (uint32_t e = 0; e < header->entry_count; e++)
+      symtable_snapshot.push_back(std::pair<std::string, int>(strings + entries[e].name, entries[e].token));
+    symtable_snapshot_taken = true;
+  }
+
+  /* tokens of the user's source code must be ordered after the tokens of the library */
+  if (get_current_order() < header->next_order)
+    set_current_order(header->next_order);
+
+  if (NULL == tree_root_ref) {
+    /* pre-parsing: no AST needed */
+    unmap_file(data, size);
+    return 0;
+  }
+
+  /* The AST...
+   * NOTE: The strings are used directly from the mapped file, so the file
+   *       must remain mapped in memory until the compiler exits.
+   *       Just like the rest of the AST, it is never released.
+   */
+  std::vector<symbol_c *> nodes(header->node_count, (symbol_c *)NULL);
+
+  /* 1st: create all the nodes */
+  for (uint32_t n = 1; n < header->node_count; n++) {
+    nodes[n] = new_node(recs[n].class_id, STR(recs[n].value));
+    if (NULL == nodes[n]) ERROR; /* can't happen, we have already validated the class_id */
+  }
+
+  /* 2nd: link them together */
+  node_access_c node_access;
+  node_access.setting = true;
+  for (uint32_t n = 1; n < header->node_count; n++) {
+    node_t   *rec    = &recs[n];
+    symbol_c *symbol = nodes[n];
+
+    if (class_kind[rec->class_id] == ref_kind) {
+      for (int i = 0; i < CACHE_MAXREFS; i++) node_access.ref[i] = nodes[rec->ref[i]];
+      symbol->accept(node_access);
+    }
+    if (class_kind[rec->class_id] == list_kind) {
+      list_c *list = dynamic_cast<list_c *>(symbol);
+      for (uint32_t e = rec->value; e < rec->value + rec->element_count; e++)
+        list->add_element(nodes[elements[e].symbol], STR(elements[e].token_value));
+    }
+  }
+
+  /* 3rd: set the annotations added by stage 1_2 (overwriting whatever was set by add_element()) */
+  for (uint32_t n = 1; n < header->node_count; n++) {
+    node_t   *rec    = &recs[n];
+    symbol_c *symbol = nodes[n];
+
+    symbol->parent       = nodes[rec->parent];
+    symbol->token        = dynamic_cast<token_c *>(nodes[rec->token]);
+    symbol->first_line   = rec->first_line;
+    symbol->first_column = rec->first_column;
+    symbol->first_file   = STR(rec->first_file);
+    symbol->first_order  = rec->first_order;
+    symbol->last_line    = rec->last_line;
+    symbol->last_column  = rec->last_column;
+    symbol->last_file    = STR(rec->last_file);
+    symbol->last_order   = rec->last_order;
+  }
+  #undef STR
+
+  *tree_root_ref = nodes[header->root];
+  return 0;
+}
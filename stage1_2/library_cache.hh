@@ -0,0 +1,74 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * The standard library cache.
+ *
+ * Stores the AST and the library_element_symtable obtained from parsing the
+ * standard library (ieclib.txt, and all the files it includes) in a binary
+ * file, so that later invocations of the compiler may load it instead of
+ * parsing the library all over again.
+ *
+ * Only used when the -L <cache_directory> command line option is given.
+ */
+
+
+#ifndef _LIBRARY_CACHE_HH
+#define _LIBRARY_CACHE_HH
+
+#include "../absyntax/absyntax.hh"
+
+
+/* Load the standard library from the cache.
+ *
+ * Fills in the library_element_symtable, and (if tree_root_ref != NULL) stores
+ * in *tree_root_ref the root of the AST of the standard library.
+ * During pre-parsing the library AST is discarded anyway, so in that case the
+ * caller should pass a NULL tree_root_ref.
+ *
+ * Returns 0 on success, or < 0 if no valid cache is available (in which case
+ * the library must be parsed as usual).
+ */
+int  library_cache_load(const char *libfilename, symbol_c **tree_root_ref);
+
+/* Store the (just parsed) standard library in the cache.
+ *
+ * Must be called right after parsing the standard library, and before
+ * parsing the user's source code.
+ * During pre-parsing the AST is not complete, so in that case the caller should
+ * pass a NULL tree_root, and only the library_element_symtable will be recorded
+ * (to be written to the cache file when called again during the normal parsing).
+ */
+void library_cache_save(const char *libfilename, symbol_c *tree_root);
+
+
+#endif /* _LIBRARY_CACHE_HH */
@@ -234,6 +234,8 @@ int stage2__(const char *filename,
              symbol_c **tree_root_ref
             );
 
+int stage2__library(symbol_c **tree_root_ref);
+
 
 int stage1_2(const char *filename, symbol_c **tree_root_ref) {
       /* NOTE: we only call stage2 (bison - syntax analysis) directly, as stage 2 will itself call stage1 (flex - lexical analysis)
@@ -249,3 +251,7 @@ int stage1_2(const char *filename, symbol_c **tree_root_ref) {
   return stage2__(filename, tree_root_ref);
 }
 
+
+int stage1_2_library(symbol_c **tree_root_ref) {
+  return stage2__library(tree_root_ref);
+}
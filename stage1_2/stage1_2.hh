@@ -47,6 +47,13 @@
 
 int stage1_2(const char *filename, symbol_c **tree_root);
 
+/* Parse only the standard library, and keep it resident (used by the compiler server, -S).
+ * Any later call to stage1_2() then only parses its input file, and adds its library elements
+ * to the AST of the standard library (returned in *tree_root). As this AST is not copied,
+ * stage1_2() may then only be called once in each (forked) process.
+ */
+int stage1_2_library(symbol_c **tree_root);
+
 
 
 
@@ -142,6 +142,17 @@ void include_string(const char *source_code);
 FILE *parse_file(const char *filename);
 
 
+/***************************************************/
+/* The relative order in which tokens were parsed. */
+/***************************************************/
+/* This is a service that flex provides to bison... */
+/* Used when the standard library is loaded from the library cache
+ * (see library_cache.cc) instead of being parsed.
+ */
+long int get_current_order(void);
+void     set_current_order(long int order);
+
+
 /**********************************************************************************************/
 /* whether bison is doing the pre-parsing, where POU bodies and var declarations are ignored! */
 /**********************************************************************************************/
@@ -41,6 +41,7 @@
 
 
 #include "array_range_check.hh"
+#include "stage3.hh"  /* required for stage3_printf() */
 #include <limits>  // required for std::numeric_limits<XXX>
 
 
@@ -49,28 +50,28 @@
 
 #define STAGE3_ERROR(error_level, symbol1, symbol2, ...) {                                                                  \
   if (current_display_error_level >= error_level) {                                                                         \
-    fprintf(stderr, "%s:%d-%d..%d-%d: error: ",                                                                             \
+    stage3_printf("%s:%d-%d..%d-%d: error: ",                                                                               \
             FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
-    fprintf(stderr, __VA_ARGS__);                                                                                           \
-    fprintf(stderr, "\n");                                                                                                  \
+    stage3_printf(__VA_ARGS__);                                                                                             \
+    stage3_printf("\n");                                                                                                    \
     error_count++;                                                                                                     \
   }                                                                                                                         \
 }
 
 
 #define STAGE3_WARNING(symbol1, symbol2, ...) {                                                                             \
-    fprintf(stderr, "%s:%d-%d..%d-%d: warning: ",                                                                           \
+    stage3_printf("%s:%d-%d..%d-%d: warning: ",                                                                             \
             FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
-    fprintf(stderr, __VA_ARGS__);                                                                                           \
-    fprintf(stderr, "\n");                                                                                                  \
+    stage3_printf(__VA_ARGS__);                                                                                             \
+    stage3_printf("\n");                                                                                                    \
     warning_found = true;                                                                                                   \
 }
 
 
-#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value._##dtype.get())
-#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value._##dtype.is_valid())
+#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value->_##dtype.get())
+#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value->_##dtype.is_valid())
 
 /*  The cmp_unsigned_signed function compares two numbers u and s.
  *  It returns an integer indicating the relationship between the numbers:
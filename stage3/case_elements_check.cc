@@ -44,6 +44,7 @@
 
 
 #include "case_elements_check.hh"
+#include "stage3.hh"  /* required for stage3_printf() */
 
 
 #define FIRST_(symbol1, symbol2) (((symbol1)->first_order < (symbol2)->first_order)   ? (symbol1) : (symbol2))
@@ -51,28 +52,28 @@
 
 #define STAGE3_ERROR(error_level, symbol1, symbol2, ...) {                                                                  \
   if (current_display_error_level >= error_level) {                                                                         \
-    fprintf(stderr, "%s:%d-%d..%d-%d: error: ",                                                                             \
+    stage3_printf("%s:%d-%d..%d-%d: error: ",                                                                               \
             FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
-    fprintf(stderr, __VA_ARGS__);                                                                                           \
-    fprintf(stderr, "\n");                                                                                                  \
+    stage3_printf(__VA_ARGS__);                                                                                             \
+    stage3_printf("\n");                                                                                                    \
     error_count++;                                                                                                     \
   }                                                                                                                         \
 }
 
 
 #define STAGE3_WARNING(symbol1, symbol2, ...) {                                                                             \
-    fprintf(stderr, "%s:%d-%d..%d-%d: warning: ",                                                                           \
+    stage3_printf("%s:%d-%d..%d-%d: warning: ",                                                                             \
             FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
-    fprintf(stderr, __VA_ARGS__);                                                                                           \
-    fprintf(stderr, "\n");                                                                                                  \
+    stage3_printf(__VA_ARGS__);                                                                                             \
+    stage3_printf("\n");                                                                                                    \
     warning_found = true;                                                                                                   \
 }
 
 
-#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value._##dtype.get())
-#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value._##dtype.is_valid())
+#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value->_##dtype.get())
+#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value->_##dtype.is_valid())
 
 
 
@@ -183,7 +184,7 @@ void case_elements_check_c::check_symb_symb(symbol_c *s1, symbol_c *s2) {
       || (dynamic_cast<subrange_c *>(s2) != NULL)) 
     return; // only run this test if neither s1 nor s2 are subranges!
   
-  if (   (s1->const_value.is_const() && s2->const_value.is_const() && (s1->const_value == s2->const_value))  // if const, then compare const values (using overloaded '==' operator!)
+  if (   (s1->const_value->is_const() && s2->const_value->is_const() && (s1->const_value == s2->const_value))  // if const, then compare const values (using overloaded '==' operator!)
       || (compare_identifiers(s1, s2) == 0))  // if token_c, compare tokens! (compare_identifiers() returns 0 when equal tokens!, -1 when either is not token_c)
     STAGE3_WARNING(s1, s2, "Duplicate element found in CASE options.");
 }
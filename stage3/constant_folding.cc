@@ -138,6 +138,7 @@
  */
 
 #include "constant_folding.hh"
+#include "stage3.hh"  /* required for stage3_printf() */
 #include <stdlib.h> /* required for malloc() */
 
 #include <string.h>  /* required for strlen() */
@@ -156,22 +157,22 @@
 
 #define STAGE3_ERROR(error_level, symbol1, symbol2, ...) {                                                                  \
   if (current_display_error_level >= error_level) {                                                                         \
-    fprintf(stderr, "%s:%d-%d..%d-%d: error: ",                                                                             \
+    stage3_printf("%s:%d-%d..%d-%d: error: ",                                                                               \
             FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
-    fprintf(stderr, __VA_ARGS__);                                                                                           \
-    fprintf(stderr, "\n");                                                                                                  \
+    stage3_printf(__VA_ARGS__);                                                                                             \
+    stage3_printf("\n");                                                                                                    \
     error_count++;                                                                                                     \
   }                                                                                                                         \
 }
 
 
 #define STAGE3_WARNING(symbol1, symbol2, ...) {                                                                             \
-    fprintf(stderr, "%s:%d-%d..%d-%d: warning: ",                                                                           \
+    stage3_printf("%s:%d-%d..%d-%d: warning: ",                                                                             \
             FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
-    fprintf(stderr, __VA_ARGS__);                                                                                           \
-    fprintf(stderr, "\n");                                                                                                  \
+    stage3_printf(__VA_ARGS__);                                                                                             \
+    stage3_printf("\n");                                                                                                    \
     warning_found = true;                                                                                                   \
 }
 
@@ -186,16 +187,16 @@
 
 
 
-#define SET_CVALUE(dtype, symbol, new_value)  ((symbol)->const_value._##dtype.set(new_value))
-#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value._##dtype.get())
-#define SET_OVFLOW(dtype, symbol)             ((symbol)->const_value._##dtype.set_overflow())
-#define SET_NONCONST(dtype, symbol)           ((symbol)->const_value._##dtype.set_nonconst())
+#define SET_CVALUE(dtype, symbol, new_value)  ((symbol)->const_value->_##dtype.set(new_value))
+#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value->_##dtype.get())
+#define SET_OVFLOW(dtype, symbol)             ((symbol)->const_value->_##dtype.set_overflow())
+#define SET_NONCONST(dtype, symbol)           ((symbol)->const_value->_##dtype.set_nonconst())
 
-#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value._##dtype.is_valid())
-#define IS_OVFLOW(dtype, symbol)              ((symbol)->const_value._##dtype.is_overflow())
-#define IS_NONCONST(dtype, symbol)            ((symbol)->const_value._##dtype.is_nonconst())
-#define IS_UNDEFINED(dtype, symbol)           ((symbol)->const_value._##dtype.is_undefined())
-#define ISZERO_CVALUE(dtype, symbol)          ((symbol)->const_value._##dtype.is_zero())
+#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value->_##dtype.is_valid())
+#define IS_OVFLOW(dtype, symbol)              ((symbol)->const_value->_##dtype.is_overflow())
+#define IS_NONCONST(dtype, symbol)            ((symbol)->const_value->_##dtype.is_nonconst())
+#define IS_UNDEFINED(dtype, symbol)           ((symbol)->const_value->_##dtype.is_undefined())
+#define ISZERO_CVALUE(dtype, symbol)          ((symbol)->const_value->_##dtype.is_zero())
 
 
 #define ISEQUAL_CVALUE(dtype, symbol1, symbol2) \
@@ -741,7 +742,7 @@ static void *handle_pow(symbol_c *symbol, symbol_c *oper1, symbol_c *oper2) {
 
 /* If the cvalues of all the prev_il_intructions have the same VALID value, then set the local cvalue to that value, otherwise, set it to NONCONST! */
 #define intersect_prev_CVALUE_(dtype, symbol) {                                                                   \
-	symbol->const_value._##dtype = symbol->prev_il_instruction[0]->const_value._##dtype;                      \
+	symbol->const_value->_##dtype = symbol->prev_il_instruction[0]->const_value->_##dtype;                      \
 	for (unsigned int i = 1; i < symbol->prev_il_instruction.size(); i++) {                                   \
 		if (!ISEQUAL_CVALUE(dtype, symbol, symbol->prev_il_instruction[i]))                               \
 			{SET_NONCONST(dtype, symbol); break;}                                                     \
@@ -42,6 +42,7 @@
 
 
 #include "enum_declaration_check.hh"
+#include "stage3.hh"  /* required for stage3_printf() */
 
 
 
@@ -50,22 +51,22 @@
 
 #define STAGE3_ERROR(error_level, symbol1, symbol2, ...) {                                                                  \
   if (current_display_error_level >= error_level) {                                                                         \
-    fprintf(stderr, "%s:%d-%d..%d-%d: error: ",                                                                             \
+    stage3_printf("%s:%d-%d..%d-%d: error: ",                                                                               \
             FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
-    fprintf(stderr, __VA_ARGS__);                                                                                           \
-    fprintf(stderr, "\n");                                                                                                  \
+    stage3_printf(__VA_ARGS__);                                                                                             \
+    stage3_printf("\n");                                                                                                    \
     error_count++;                                                                                                     \
   }                                                                                                                         \
 }
 
 
 #define STAGE3_WARNING(symbol1, symbol2, ...) {                                                                             \
-    fprintf(stderr, "%s:%d-%d..%d-%d: warning: ",                                                                           \
+    stage3_printf("%s:%d-%d..%d-%d: warning: ",                                                                             \
             FIRST_(symbol1,symbol2)->first_file, FIRST_(symbol1,symbol2)->first_line, FIRST_(symbol1,symbol2)->first_column,\
                                                  LAST_(symbol1,symbol2) ->last_line,  LAST_(symbol1,symbol2) ->last_column);\
-    fprintf(stderr, __VA_ARGS__);                                                                                           \
-    fprintf(stderr, "\n");                                                                                                  \
+    stage3_printf(__VA_ARGS__);                                                                                             \
+    stage3_printf("\n");                                                                                                    \
     warning_found = true;                                                                                                   \
 }
 
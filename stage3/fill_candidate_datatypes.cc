@@ -69,9 +69,9 @@
 #include <strings.h>
 
 
-#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value._##dtype.get())
-#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value._##dtype.is_valid())
-#define IS_OVERFLOW(dtype, symbol)            ((symbol)->const_value._##dtype.is_overflow())
+#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value->_##dtype.get())
+#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value->_##dtype.is_valid())
+#define IS_OVERFLOW(dtype, symbol)            ((symbol)->const_value->_##dtype.is_overflow())
 
 
 /* set to 1 to see debug info during execution */
@@ -200,15 +200,17 @@ static populate_globalenumvalue_symtable_c populate_globalenumvalue_symtable;
  *     END_FUNCTION_BLOCK
  */
  
-static enumerated_value_symtable_t local_enumerated_value_symtable;
-
+/* NOTE: The local_enumerated_value_symtable is a member of fill_candidate_datatypes_c (and not a static variable),
+ *       as several fill_candidate_datatypes_c objects may be running simultaneously in distinct threads (see stage3.cc)
+ */
 
 class populate_localenumvalue_symtable_c: public iterator_visitor_c {
   private:
     symbol_c *current_enumerated_type;
+    enumerated_value_symtable_t &local_enumerated_value_symtable;
 
   public:
-     populate_localenumvalue_symtable_c(void) {current_enumerated_type = NULL;};
+     populate_localenumvalue_symtable_c(enumerated_value_symtable_t &symtable): local_enumerated_value_symtable(symtable) {current_enumerated_type = NULL;};
     ~populate_localenumvalue_symtable_c(void) {}
 
   public:
@@ -254,8 +256,6 @@ class populate_localenumvalue_symtable_c: public iterator_visitor_c {
   }
 }; // class populate_enumvalue_symtable_c
 
-static populate_localenumvalue_symtable_c populate_enumvalue_symtable;
-
 
 
 
@@ -278,6 +278,17 @@ fill_candidate_datatypes_c::~fill_candidate_datatypes_c(void) {
 }
 
 
+/* Add the global enum value constants of the whole library to the global_enumerated_value_symtable.
+ * Called by visit(library_c *), or directly when the library elements are visited one at a time (see stage3.cc).
+ */
+void fill_candidate_datatypes_c::populate_global_enumerated_values(symbol_c *tree_root) {
+	tree_root->accept(populate_globalenumvalue_symtable);
+}
+
+void fill_candidate_datatypes_c::freeze_global_enumerated_values  (void) {global_enumerated_value_symtable.freeze();  }
+void fill_candidate_datatypes_c::unfreeze_global_enumerated_values(void) {global_enumerated_value_symtable.unfreeze();}
+
+
 
 
 
@@ -690,7 +701,7 @@ symbol_c *fill_candidate_datatypes_c::base_type(symbol_c *symbol) {
 /***************************/
 /* main entry function! */
 void *fill_candidate_datatypes_c::visit(library_c *symbol) {
-	symbol->accept(populate_globalenumvalue_symtable);
+	populate_global_enumerated_values(symbol);
 	/* Now let the base class iterator_visitor_c iterate through all the library elements */
 	return iterator_visitor_c::visit(symbol);  
 }
@@ -1538,6 +1549,7 @@ void *fill_candidate_datatypes_c::visit(function_declaration_c *symbol) {
 	if (debug) printf("Filling candidate data types list of function %s\n", ((token_c *)(symbol->derived_function_name))->value);
 	local_enumerated_value_symtable.reset();
 	current_scope = symbol;	
+	populate_localenumvalue_symtable_c populate_enumvalue_symtable(local_enumerated_value_symtable);
 	symbol->var_declarations_list->accept(populate_enumvalue_symtable);
 
 	search_var_instance_decl = new search_var_instance_decl_c(symbol);
@@ -1558,6 +1570,7 @@ void *fill_candidate_datatypes_c::visit(function_block_declaration_c *symbol) {
 	if (debug) printf("Filling candidate data types list of FB %s\n", ((token_c *)(symbol->fblock_name))->value);
 	local_enumerated_value_symtable.reset();
 	current_scope = symbol;	
+	populate_localenumvalue_symtable_c populate_enumvalue_symtable(local_enumerated_value_symtable);
 	symbol->var_declarations->accept(populate_enumvalue_symtable);
 
 	search_var_instance_decl = new search_var_instance_decl_c(symbol);
@@ -1584,6 +1597,7 @@ void *fill_candidate_datatypes_c::visit(program_declaration_c *symbol) {
 	if (debug) printf("Filling candidate data types list in program %s\n", ((token_c *)(symbol->program_type_name))->value);
 	local_enumerated_value_symtable.reset();
 	current_scope = symbol;	
+	populate_localenumvalue_symtable_c populate_enumvalue_symtable(local_enumerated_value_symtable);
 	symbol->var_declarations->accept(populate_enumvalue_symtable);
 	
 	search_var_instance_decl = new search_var_instance_decl_c(symbol);
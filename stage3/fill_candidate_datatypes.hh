@@ -77,6 +77,9 @@ class fill_candidate_datatypes_c: public iterator_visitor_c {
      * fill_candidate_datatypes_c::visit(enumerated_value_list_c *symbol) function.
      */
     symbol_c *current_enumerated_spec_type;
+
+    /* The enum values declared anonymously inside the VAR ... END_VAR of the POU currently being analysed */
+    dsymtable_c<symbol_c *> local_enumerated_value_symtable;
     
     /* pointer to the Function, FB, or Program currently being analysed */
     symbol_c *current_scope;
@@ -115,6 +118,15 @@ class fill_candidate_datatypes_c: public iterator_visitor_c {
     fill_candidate_datatypes_c(symbol_c *ignore);
     virtual ~fill_candidate_datatypes_c(void);
 
+    /* The enum values declared inside TYPE ... END_TYPE are shared by all fill_candidate_datatypes_c objects.
+     * When this visitor is not asked to visit the library_c (e.g. when the library elements are being
+     * analysed in parallel, see stage3.cc), these must be populated beforehand.
+     * The table must remain frozen while any other thread may be looking up enum values.
+     */
+    static void populate_global_enumerated_values(symbol_c *tree_root);
+    static void   freeze_global_enumerated_values(void);
+    static void unfreeze_global_enumerated_values(void);
+
     
     /***************************/
     /* B 0 - Programming Model */
@@ -32,7 +32,14 @@
  *
  */
 
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
 #include "stage3.hh"
+#include "../util/thread_pool.hh"
+#include "../util/pass_report.hh"
 
 #include "flow_control_analysis.hh"
 #include "fill_candidate_datatypes.hh"
@@ -89,22 +96,55 @@ static int constant_propagation(symbol_c *tree_root){
 }
 
 
-/* Type safety analysis assumes that 
- *    - flow control analysis 
- *    - constant folding (constant check)
- * has already been completed, so be sure to call those semantic checkers
- * before calling this function
- */
-static int type_safety(symbol_c *tree_root){
+static int fill_candidate_datatypes(symbol_c *tree_root){
 	fill_candidate_datatypes_c fill_candidate_datatypes(tree_root);
 	tree_root->accept(fill_candidate_datatypes);
+	return 0;
+}
+
+static int narrow_candidate_datatypes(symbol_c *tree_root){
 	narrow_candidate_datatypes_c narrow_candidate_datatypes(tree_root);
 	tree_root->accept(narrow_candidate_datatypes);
+	return 0;
+}
+
+static int print_datatypes_error(symbol_c *tree_root){
 	print_datatypes_error_c print_datatypes_error(tree_root);
 	tree_root->accept(print_datatypes_error);
+	return print_datatypes_error.get_error_count();
+}
+
+static int forced_narrow_candidate_datatypes(symbol_c *tree_root){
 	forced_narrow_candidate_datatypes_c forced_narrow_candidate_datatypes(tree_root);
 	tree_root->accept(forced_narrow_candidate_datatypes);
-	return print_datatypes_error.get_error_count();
+	return 0;
+}
+
+
+typedef int (*stage3_pass_t)(symbol_c *tree_root);
+
+/* Run a pass on the whole tree, timing it for the pass report (-t) */
+static int report_pass(const char *name, stage3_pass_t pass, symbol_c *tree_root) {
+	pass_report_c::begin(name);
+	int error_count = pass(tree_root);
+	pass_report_c::end();
+	return error_count;
+}
+
+
+/* Type safety analysis assumes that 
+ *    - flow control analysis 
+ *    - constant folding (constant check)
+ * has already been completed, so be sure to call those semantic checkers
+ * before calling this function
+ */
+static int type_safety(symbol_c *tree_root){
+	int error_count = 0;
+	error_count += report_pass("fill_candidate_datatypes",          fill_candidate_datatypes,          tree_root);
+	error_count += report_pass("narrow_candidate_datatypes",        narrow_candidate_datatypes,        tree_root);
+	error_count += report_pass("print_datatypes_error",             print_datatypes_error,             tree_root);
+	error_count += report_pass("forced_narrow_candidate_datatypes", forced_narrow_candidate_datatypes, tree_root);
+	return error_count;
 }
 
 
@@ -155,17 +195,188 @@ static int remove_forward_dependencies(symbol_c *tree_root, symbol_c **ordered_t
 }
 
 
+
+/**************************************************/
+/* Analysing the POUs in parallel (-j <threads>)  */
+/**************************************************/
+
+/* The type safety, lvalue, array range and case elements checks of a POU only depend on the
+ * declarations of the other library elements, and on the results of the previous passes.
+ * Each of these passes may therefore analyse all the POUs (FUNCTIONs, FUNCTION_BLOCKs and PROGRAMs)
+ * of a library at the same time, on a pool of threads.
+ *
+ * Each pass is run over all the elements of the library before starting the next pass.
+ * Within a pass, the consecutive POUs of the library are analysed in parallel, while any other
+ * library element (data types, configurations, ...) is analysed alone, in the order in which it
+ * appears in the library. The results (and the error messages) are therefore the same as when
+ * the passes are run on the whole library by a single thread.
+ *
+ * The error messages are printed with stage3_printf(). While a POU is being analysed by a worker
+ * thread these are stored in a buffer, which is printed out (in library order) once all the POUs
+ * being analysed in parallel are done.
+ *
+ * The global symbol tables are frozen while the POUs are being analysed, so any attempt to
+ * change them (which would not be thread safe) is reported as an internal compiler error.
+ */
+
+/* The buffer where the messages of the POU being analysed by the current thread are stored (NULL: print to stderr) */
+static __thread std::string *stage3_output = NULL;
+
+void stage3_printf(const char *format, ...) {
+	va_list argptr;
+	if (NULL == stage3_output) {
+		va_start(argptr, format);
+		vfprintf(stderr, format, argptr);
+		va_end(argptr);
+		return;
+	}
+
+	char buf[256];
+	va_start(argptr, format);
+	int len = vsnprintf(buf, sizeof(buf), format, argptr);
+	va_end(argptr);
+	if (len < 0) return;
+	if ((size_t)len < sizeof(buf)) {stage3_output->append(buf, len); return;}
+
+	/* message did not fit in buf */
+	char *msg = (char *)malloc(len + 1);
+	if (NULL == msg) ERROR_MSG("out of memory");
+	va_start(argptr, format);
+	vsnprintf(msg, len + 1, format, argptr);
+	va_end(argptr);
+	stage3_output->append(msg, len);
+	free(msg);
+}
+
+
+/* Run one pass on a single POU */
+class stage3_pou_c: public work_item_c {
+  public:
+    symbol_c     *pou;
+    stage3_pass_t pass;
+    int           error_count;
+    std::string   output;
+
+    stage3_pou_c(void) {pou = NULL; pass = NULL; error_count = 0;}
+    void run(void) {
+      stage3_output = &output;
+      error_count = pass(pou);
+      stage3_output = NULL;
+    }
+};
+
+
+static bool is_pou(symbol_c *element) {
+	return (   (NULL != dynamic_cast<function_declaration_c       *>(element))
+	        || (NULL != dynamic_cast<function_block_declaration_c *>(element))
+	        || (NULL != dynamic_cast<program_declaration_c        *>(element)));
+}
+
+
+static void freeze_symtables(void) {
+	function_symtable           .freeze();
+	function_block_type_symtable.freeze();
+	program_type_symtable       .freeze();
+	type_symtable               .freeze();
+	fill_candidate_datatypes_c::freeze_global_enumerated_values();
+}
+
+static void unfreeze_symtables(void) {
+	function_symtable           .unfreeze();
+	function_block_type_symtable.unfreeze();
+	program_type_symtable       .unfreeze();
+	type_symtable               .unfreeze();
+	fill_candidate_datatypes_c::unfreeze_global_enumerated_values();
+}
+
+
+/* Analyse (in parallel) the POUs in the wave, and print out their messages in order. */
+static int run_wave(std::vector<work_item_c *> &wave) {
+	int error_count = 0;
+	if (wave.empty()) return 0;
+
+	freeze_symtables();
+	thread_pool_c::run(wave, runtime_options.threads);
+	unfreeze_symtables();
+
+	for (unsigned int i = 0; i < wave.size(); i++) {
+		stage3_pou_c *pou = (stage3_pou_c *)wave[i];
+		fputs(pou->output.c_str(), stderr);
+		error_count += pou->error_count;
+	}
+	wave.clear();
+	return error_count;
+}
+
+
+static int run_pass_in_parallel(symbol_c *tree_root, stage3_pass_t pass) {
+	library_c *library = dynamic_cast<library_c *>(tree_root);
+	if (NULL == library) return pass(tree_root);
+
+	int error_count = 0;
+	std::vector<stage3_pou_c>  pous(library->n);
+	std::vector<work_item_c *> wave;
+	for (int i = 0; i < library->n; i++) {
+		symbol_c *element = library->get_element(i);
+		if (is_pou(element)) {
+			pous[i].pou  = element;
+			pous[i].pass = pass;
+			wave.push_back(&pous[i]);
+		} else {
+			error_count += run_wave(wave);
+			error_count += pass(element);
+		}
+	}
+	error_count += run_wave(wave);
+	return error_count;
+}
+
+
+/* Same as report_pass(), but analysing the POUs in parallel */
+static int report_pass_in_parallel(const char *name, stage3_pass_t pass, symbol_c *tree_root) {
+	pass_report_c::begin(name);
+	int error_count = run_pass_in_parallel(tree_root, pass);
+	pass_report_c::end();
+	return error_count;
+}
+
+
+/* NOTE: the passes are reported with the same names as when run by a single thread (see stage3()) */
+static int parallel_pou_checks(symbol_c *tree_root) {
+	int error_count = 0;
+	pass_report_c::begin("type_safety");
+	/* fill_candidate_datatypes_c only populates the global enum values when visiting the whole library */
+	fill_candidate_datatypes_c::populate_global_enumerated_values(tree_root);
+	error_count += report_pass_in_parallel("fill_candidate_datatypes",          fill_candidate_datatypes,          tree_root);
+	error_count += report_pass_in_parallel("narrow_candidate_datatypes",        narrow_candidate_datatypes,        tree_root);
+	error_count += report_pass_in_parallel("print_datatypes_error",             print_datatypes_error,             tree_root);
+	error_count += report_pass_in_parallel("forced_narrow_candidate_datatypes", forced_narrow_candidate_datatypes, tree_root);
+	pass_report_c::end();
+	error_count += report_pass_in_parallel("lvalue_check",                      lvalue_check,                      tree_root);
+	error_count += report_pass_in_parallel("array_range_check",                 array_range_check,                 tree_root);
+	error_count += report_pass_in_parallel("case_elements_check",               case_elements_check,               tree_root);
+	return error_count;
+}
+
+
+
 int stage3(symbol_c *tree_root, symbol_c **ordered_tree_root) {
 	int error_count = 0;
-	error_count += enum_declaration_check(tree_root);
-	error_count += flow_control_analysis(tree_root);
-	error_count += constant_propagation(tree_root);
-	error_count += declaration_safety(tree_root);
-	error_count += type_safety(tree_root);
-	error_count += lvalue_check(tree_root);
-	error_count += array_range_check(tree_root);
-	error_count += case_elements_check(tree_root);
+	error_count += report_pass("enum_declaration_check", enum_declaration_check, tree_root);
+	error_count += report_pass("flow_control_analysis",  flow_control_analysis,  tree_root);
+	error_count += report_pass("constant_propagation",   constant_propagation,   tree_root);
+	error_count += report_pass("declaration_safety",     declaration_safety,     tree_root);
+	if (runtime_options.threads > 1) {
+		error_count += parallel_pou_checks(tree_root);
+	} else {
+		error_count += report_pass("type_safety",         type_safety,         tree_root);
+		error_count += report_pass("lvalue_check",        lvalue_check,        tree_root);
+		error_count += report_pass("array_range_check",   array_range_check,   tree_root);
+		error_count += report_pass("case_elements_check", case_elements_check, tree_root);
+	}
+	pass_report_c::begin("remove_forward_dependencies");
 	error_count += remove_forward_dependencies(tree_root, ordered_tree_root);
+	pass_report_c::end();
 	
 	if (error_count > 0) {
 		fprintf(stderr, "%d error(s) found. Bailing out!\n", error_count); 
@@ -38,4 +38,9 @@
 
 int stage3(symbol_c *tree_root, symbol_c **ordered_tree_root);
 
+/* Print an error or warning message of the semantic analysis.
+ * Same as fprintf(stderr, ...), but keeps the messages in order when several POUs are analysed in parallel.
+ */
+void stage3_printf(const char *format, ...);
+
 #endif /* _STAGE3_HH */
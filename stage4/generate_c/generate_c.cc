@@ -37,6 +37,7 @@
 #include "../../absyntax/visitor.hh"
 #include "../../absyntax_utils/absyntax_utils.hh"
 #include "../../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../../util/thread_pool.hh"
 
 #include "../stage4.hh"
 
@@ -53,8 +54,8 @@
 
 
 /* Macros to access the constant value of each expression (if it exists) from the annotation introduced to the symbol_c object by constant_folding_c in stage3! */
-#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value._##dtype.is_valid())
-#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value._##dtype.get()) 
+#define VALID_CVALUE(dtype, symbol)           ((symbol)->const_value->_##dtype.is_valid())
+#define GET_CVALUE(dtype, symbol)             ((symbol)->const_value->_##dtype.get()) 
 
 
 
@@ -116,6 +117,11 @@
 #define DECLARE_EXTERNAL_FB "__DECLARE_EXTERNAL_FB"
 #define DECLARE_LOCATED "__DECLARE_LOCATED"
 #define DECLARE_GLOBAL_PROTOTYPE "__DECLARE_GLOBAL_PROTOTYPE"
+#define DECLARE_GLOBAL_RETAIN "__DECLARE_GLOBAL_RETAIN"
+#define DECLARE_GLOBAL_FB_RETAIN "__DECLARE_GLOBAL_FB_RETAIN"
+#define DECLARE_RETAIN "__DECLARE_RETAIN"
+#define DECLARE_RETAIN_FB "__DECLARE_RETAIN_FB"
+#define DECLARE_RETAIN_SEGMENT "__DECLARE_RETAIN_SEGMENT"
 
 /* Variable declaration symbol for accessor macros */
 #define INIT_VAR "__INIT_VAR"
@@ -179,6 +185,15 @@
 static int generate_line_directives__ = 0;
 static int generate_pou_filepairs__   = 0;
 static int generate_plc_state_backup_fuctions__ = 0;
+static int generate_incremental__     = 0;
+static int generate_time_int64__      = 0;
+static int generate_production_accessors__ = 0;
+static int generate_resource_threads__ = 0;
+/* The maximum length of STRING values (STR_MAX_LEN) in the generated code. 0: the default of iec_types.h */
+static int generate_string_max_len__ = 0;
+static int generate_retain_segment__ = 0;
+static int generate_debug_index__    = 0;
+static int generate_pou_profile__    = 0;
 
 #ifdef __unix__
 /* Parse command line options passed from main.c !! */
@@ -186,12 +201,30 @@ static int generate_plc_state_backup_fuctions__ = 0;
 int  stage4_parse_options(char *options) {
   enum {LINE_OPT = 0,  
         SEPTFILE_OPT,
-        BACKUP_OPT    /* option to generate function to backup and restore internal PLC state */
+        BACKUP_OPT,   /* option to generate function to backup and restore internal PLC state */
+        WRITEV_OPT,   /* option to write out each generated file with a single writev() */
+        INCREMENTAL_OPT, /* option to not generate again the files that did not change */
+        TIMEINT64_OPT, /* option to store TIME, DATE, TOD and DT as a 64 bit count of nanoseconds */
+        PRODUCTION_OPT, /* option to not test the force flag on each access to a variable */
+        THREADS_OPT,   /* option to run each resource (or task) on its own thread */
+        STRLEN_OPT,    /* option to set the maximum length of STRING values */
+        RETAINSEG_OPT, /* option to place the RETAIN global variables in a contiguous retain segment */
+        DEBUGINDEX_OPT, /* option to generate the compiled debug symbol index */
+        PROFILE_OPT    /* option to record the execution time of each POU */
         /*, SOME_OTHER_OPT, YET_ANOTHER_OPT */};
   char *const token[] = {
         /*       LINE_OPT*/(char *)"l",
         /*   SEPTFILE_OPT*/(char *)"p",
         /*     BACKUP_OPT*/(char *)"b",
+        /*     WRITEV_OPT*/(char *)"v",
+        /*INCREMENTAL_OPT*/(char *)"i",
+        /*  TIMEINT64_OPT*/(char *)"t",
+        /* PRODUCTION_OPT*/(char *)"f",
+        /*    THREADS_OPT*/(char *)"r",
+        /*     STRLEN_OPT*/(char *)"s",
+        /*  RETAINSEG_OPT*/(char *)"k",
+        /* DEBUGINDEX_OPT*/(char *)"d",
+        /*    PROFILE_OPT*/(char *)"c",
         /* SOME_OTHER_OPT, ...             */
         NULL };
   /* unfortunately, the above commented out syntax for array initialization is valid in C, but not in C++ */
@@ -202,10 +235,23 @@ int  stage4_parse_options(char *options) {
 
   while (*subopts != '\0') {
     switch (getsubopt(&subopts, token, &value)) {
-      case     LINE_OPT: generate_line_directives__            = 1; break;
-      case SEPTFILE_OPT: generate_pou_filepairs__              = 1; break;
-      case   BACKUP_OPT: generate_plc_state_backup_fuctions__  = 1; break;
-      default          : fprintf(stderr, "Unrecognized option: -O %s\n", value); return -1; break;
+      case        LINE_OPT: generate_line_directives__            = 1; break;
+      case    SEPTFILE_OPT: generate_pou_filepairs__              = 1; break;
+      case      BACKUP_OPT: generate_plc_state_backup_fuctions__  = 1; break;
+      case      WRITEV_OPT: stage4out_c::use_writev(true);               break;
+      case INCREMENTAL_OPT: generate_incremental__                = 1;
+                            stage4out_c::keep_unchanged_files(true);     break;
+      case   TIMEINT64_OPT: generate_time_int64__                 = 1; break;
+      case  PRODUCTION_OPT: generate_production_accessors__       = 1; break;
+      case     THREADS_OPT: generate_resource_threads__           = 1; break;
+      case      STRLEN_OPT: generate_string_max_len__ = (NULL == value)? 0 : atoi(value);
+                            if ((generate_string_max_len__ < 1) || (generate_string_max_len__ > 126))
+                              {fprintf(stderr, "Invalid STRING length: -O s=%s (must be 1 to 126)\n", (NULL == value)? "" : value); return -1;}
+                            break;
+      case   RETAINSEG_OPT: generate_retain_segment__             = 1; break;
+      case  DEBUGINDEX_OPT: generate_debug_index__                = 1; break;
+      case     PROFILE_OPT: generate_pou_profile__                = 1; break;
+      default             : fprintf(stderr, "Unrecognized option: -O %s\n", value); return -1; break;
      }
   }     
   return 0;
@@ -215,8 +261,25 @@ int  stage4_parse_options(char *options) {
 void stage4_print_options(void) {
   printf("          (options must be separated by commas. Example: 'l,w,x')\n"); 
   printf("      l : insert '#line' directives in generated C code.\n"); 
-  printf("      p : place each POU in a separate pair of files (<pou_name>.c, <pou_name>.h).\n"); 
-  printf("      b : generate functions to backup and restore internal PLC state.\n"); 
+  printf("      p : place each POU in a separate pair of files (<pou_name>.c, <pou_name>.h), generated in parallel with -j.\n"); 
+  printf("      b : generate functions to backup and restore internal PLC state (in full, or incrementally, see lib/C/iec_backup.h).\n"); 
+  printf("      v : keep each generated file in memory, and write it out with a single writev() call.\n"); 
+  printf("      i : incremental: do not rewrite generated files whose contents did not change, and (with 'p')\n"); 
+  printf("          do not generate again the files of the POUs that did not change (see <builddir>/POUS.manifest).\n"); 
+  printf("      t : store TIME, DATE, TOD and DT as a 64 bit count of nanoseconds (the runtime must be\n"); 
+  printf("          compiled with IEC_TIME_INT64 defined too).\n"); 
+  printf("      f : production accessors: read and write variables without testing their force flag, and apply the\n"); 
+  printf("          forced values once at the start and end of each cycle (see __FORCE_VAR() in accessor.h).\n"); 
+  printf("      r : resource threads: each resource, or each task, may run on its own thread, with its own copy of\n"); 
+  printf("          the global variables, exchanged at the start and end of each cycle (see lib/C/iec_threads.h).\n"); 
+  printf("    s=n : maximum length of STRING values (STR_MAX_LEN, 1 to 126). Shorter strings are cheaper to copy (the\n"); 
+  printf("          runtime must be compiled with the same STR_MAX_LEN).\n"); 
+  printf("      k : place the RETAIN global variables of the configuration, and of each resource, in a single\n"); 
+  printf("          contiguous retain segment (listed in __iec_retain_segments[], see lib/C/accessor.h).\n"); 
+  printf("      d : generate a compiled debug symbol index of the variables in VARIABLES.csv, with a perfect hash\n"); 
+  printf("          table over their names (DEBUG_INDEX.c and DEBUG_INDEX.bin, see lib/C/iec_debug.h).\n"); 
+  printf("      c : cycle time instrumentation: count and time the calls to each function block and program, to each\n"); 
+  printf("          program instance, and to each resource (listed in __iec_profile_table[], see lib/C/iec_profile.h).\n"); 
 }
 #else /* not __unix__ */
 /* getsubopt isn't supported with mingw, 
@@ -225,6 +288,53 @@ void stage4_print_options(void) {}
 int  stage4_parse_options(char *options) {return 0;}
 #endif 
 
+
+/* Print the #define's that select the variant of the standard library (and accessors) the generated code
+ * was generated for. Printed at the start of each generated file that includes iec_std_lib.h.
+ */
+static void print_stdlib_variant_defines(stage4out_c &s4o) {
+  if (runtime_options.disable_implicit_en_eno) {
+    // If we are not generating the EN and ENO parameters for functions and FB,
+    //   then make sure we use the standard library version compiled without these parameters too!
+    s4o.print("#ifndef DISABLE_EN_ENO_PARAMETERS\n");
+    s4o.print("#define DISABLE_EN_ENO_PARAMETERS\n");
+    s4o.print("#endif\n");
+  }
+  if (generate_time_int64__) {
+    // TIME, DATE, TOD and DT are a 64 bit count of nanoseconds (see iec_types.h)
+    s4o.print("#ifndef IEC_TIME_INT64\n");
+    s4o.print("#define IEC_TIME_INT64\n");
+    s4o.print("#endif\n");
+  }
+  if (generate_production_accessors__) {
+    // the accessors do not test the force flag (see accessor.h)
+    s4o.print("#ifndef IEC_PRODUCTION_ACCESSORS\n");
+    s4o.print("#define IEC_PRODUCTION_ACCESSORS\n");
+    s4o.print("#endif\n");
+  }
+  if (generate_resource_threads__) {
+    // each execution unit works on its own copy of the global variables (see accessor.h)
+    s4o.print("#ifndef IEC_RESOURCE_THREADS\n");
+    s4o.print("#define IEC_RESOURCE_THREADS\n");
+    s4o.print("#endif\n");
+  }
+  if (generate_string_max_len__) {
+    // the size of the body of STRING values (see iec_types.h)
+    s4o.print("#ifndef STR_MAX_LEN\n");
+    s4o.print("#define STR_MAX_LEN ");
+    s4o.print(generate_string_max_len__);
+    s4o.print("\n#endif\n");
+  }
+}
+
+
+/* The upper case version of an identifier, as used in the names of the generated C variables and counters */
+static std::string upper(const char *str) {
+  std::string res = str;
+  for (unsigned int i = 0; i < res.size(); i++) res[i] = toupper(res[i]);
+  return res;
+}
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -237,6 +347,8 @@ int  stage4_parse_options(char *options) {return 0;}
 #include "generate_c_configbody.cc"
 #include "generate_location_list.cc"
 #include "generate_var_list.cc"
+#include "generate_debug_index.cc"
+#include "generate_c_fingerprint.cc"
 
 /***********************************************************************/
 /***********************************************************************/
@@ -413,7 +525,8 @@ class print_function_parameter_data_types_c: public generate_c_base_and_typeid_c
 /* 'complex' means that it is either a strcuture or an array!               */
 class analyse_variable_c: public search_visitor_c {
   private:
-    static analyse_variable_c *singleton_;
+    /* NOTE: the singleton keeps the state of the current search, so each thread gets its own (see generate_c_pou_filepair_c) */
+    static __thread analyse_variable_c *singleton_;
 
   public:
     analyse_variable_c(void) {};
@@ -527,7 +640,7 @@ class analyse_variable_c: public search_visitor_c {
     
 };
 
-analyse_variable_c *analyse_variable_c::singleton_ = NULL;
+__thread analyse_variable_c *analyse_variable_c::singleton_ = NULL;
 
 /***********************************************************************/
 /***********************************************************************/
@@ -684,6 +797,78 @@ class calculate_common_ticktime_c: public iterator_visitor_c {
 /***********************************************************************/
 /***********************************************************************/
 
+/* With resource threads (-O r) each task of a resource, and the programs of the resource that are
+ * not associated to any task, form an execution unit, that may run on its own thread (see accessor.h).
+ * The units of all the resources of the configuration are numbered consecutively, in the order
+ * in which the resources, and their tasks, are declared.
+ * Each resource runs with its own period (the greatest common divisor of the intervals of its tasks).
+ */
+class resource_units_c {
+  public:
+    std::vector<task_configuration_c *> tasks; /* the tasks of the resource, in declaration order */
+    bool untasked_programs;                    /* the resource has programs not associated to any task */
+    unsigned long long ticktime;               /* the period of the resource (ns) */
+
+    /* symbol is either a resource_declaration_c or a single_resource_declaration_c */
+    resource_units_c(symbol_c *symbol, unsigned long long config_ticktime) {
+      resource_declaration_c *resource = dynamic_cast<resource_declaration_c *>(symbol);
+      single_resource_declaration_c *single_resource
+        = dynamic_cast<single_resource_declaration_c *>((NULL != resource)? resource->resource_declaration : symbol);
+      if (NULL == single_resource) ERROR;
+
+      list_c *task_list = dynamic_cast<list_c *>(single_resource->task_configuration_list);
+      for (int i = 0; (NULL != task_list) && (i < task_list->n); i++) {
+        task_configuration_c *task = dynamic_cast<task_configuration_c *>(task_list->get_element(i));
+        if (NULL != task) tasks.push_back(task);
+      }
+      untasked_programs = false;
+      list_c *program_list = dynamic_cast<list_c *>(single_resource->program_configuration_list);
+      for (int i = 0; (NULL != program_list) && (i < program_list->n); i++) {
+        program_configuration_c *program = dynamic_cast<program_configuration_c *>(program_list->get_element(i));
+        if ((NULL != program) && (NULL == program->task_name)) untasked_programs = true;
+      }
+
+      calculate_common_ticktime_c calculate_common_ticktime;
+      symbol->accept(calculate_common_ticktime);
+      ticktime = calculate_common_ticktime.get_common_ticktime();
+      if (0 == ticktime) ticktime = config_ticktime; /* only event driven tasks */
+    }
+
+    int count(void) {return tasks.size() + (untasked_programs? 1 : 0);}
+
+    /* The unit (counting from the first unit of the resource) of the task, or of the programs not associated to any task (task_name == NULL) */
+    int unit_of(symbol_c *task_name) {
+      if (NULL == task_name) return tasks.size();
+      for (unsigned int i = 0; i < tasks.size(); i++)
+        if (compare_identifiers(tasks[i]->task_name, task_name) == 0) return i;
+      ERROR;
+      return 0;
+    }
+
+    /* The period of the unit (ns). Event driven tasks, and the programs not associated to any task, run on every tick of the resource. */
+    unsigned long long period_of(int unit) {
+      if (unit >= (int)tasks.size()) return ticktime;
+      task_initialization_c *task_init = dynamic_cast<task_initialization_c *>(tasks[unit]->task_initialization);
+      if ((NULL == task_init) || (NULL != task_init->single_data_source)) return ticktime;
+      unsigned long long time = calculate_time(task_init->interval_data_source);
+      return (0 == time)? ticktime : time;
+    }
+
+    /* the resources of the configuration (resource_declaration_c, or a single_resource_declaration_c) */
+    static void get_resources(symbol_c *resource_declarations, std::vector<symbol_c *> &resources) {
+      list_c *list = dynamic_cast<resource_declaration_list_c *>(resource_declarations);
+      if (NULL == list) {resources.push_back(resource_declarations); return;}
+      for (int i = 0; i < list->n; i++)
+        if (NULL != dynamic_cast<resource_declaration_c *>(list->get_element(i)))
+          resources.push_back(list->get_element(i));
+    }
+};
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
 /* A helper class that knows how to generate code for the SFC, IL and ST languages... */
 class generate_c_SFC_IL_ST_c: public null_visitor_c {
   private:
@@ -1101,6 +1286,17 @@ class generate_c_pous_c {
       }
       
       /* (C.3) Function declaration */
+      if (generate_pou_profile__) {
+        /* the counter of the calls to the body (see iec_profile.h) */
+        s4o.print(print_declaration? "__DECLARE_EXTERN_PROFILE(" : "__DECLARE_PROFILE(");
+        symbol->fblock_name->accept(print_base);
+        if (!print_declaration) {
+          s4o.print(", \"");
+          symbol->fblock_name->accept(print_base);
+          s4o.print("\"");
+        }
+        s4o.print(")\n");
+      }
       s4o.print("// Code part\n");
       /* function interface */
       s4o.print("void ");
@@ -1152,6 +1348,9 @@ class generate_c_pous_c {
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
         }
+
+        if (generate_pou_profile__)
+          s4o.print(s4o.indent_spaces + "__IEC_PROFILE_BEGIN\n");
       
         /* (C.4) Initialize TEMP variables */
         /* function body */
@@ -1167,6 +1366,11 @@ class generate_c_pous_c {
         generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->fblock_name, symbol, FB_FUNCTION_PARAM"->");
         symbol->fblock_body->accept(generate_c_code);
         print_end_of_block_label(s4o);
+        if (generate_pou_profile__) {
+          s4o.print(s4o.indent_spaces + "__IEC_PROFILE_END(");
+          symbol->fblock_name->accept(print_base);
+          s4o.print(")\n");
+        }
         s4o.print(s4o.indent_spaces + "return;\n");
         s4o.indent_left();
         s4o.print(s4o.indent_spaces + "} // ");
@@ -1312,6 +1516,17 @@ class generate_c_pous_c {
       }
       
       /* (C.3) Function declaration */
+      if (generate_pou_profile__) {
+        /* the counter of the calls to the body (see iec_profile.h) */
+        s4o.print(print_declaration? "__DECLARE_EXTERN_PROFILE(" : "__DECLARE_PROFILE(");
+        symbol->program_type_name->accept(print_base);
+        if (!print_declaration) {
+          s4o.print(", \"");
+          symbol->program_type_name->accept(print_base);
+          s4o.print("\"");
+        }
+        s4o.print(")\n");
+      }
       s4o.print("// Code part\n");
       /* function interface */
       s4o.print("void ");
@@ -1329,6 +1544,9 @@ class generate_c_pous_c {
       } else {
         s4o.print(" {\n");
         s4o.indent_right();
+
+        if (generate_pou_profile__)
+          s4o.print(s4o.indent_spaces + "__IEC_PROFILE_BEGIN\n");
           
         /* (C.4) Initialize TEMP variables */
         /* function body */
@@ -1344,6 +1562,11 @@ class generate_c_pous_c {
         generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->program_type_name, symbol, FB_FUNCTION_PARAM"->");
         symbol->function_block_body->accept(generate_c_code);
         print_end_of_block_label(s4o);
+        if (generate_pou_profile__) {
+          s4o.print(s4o.indent_spaces + "__IEC_PROFILE_END(");
+          symbol->program_type_name->accept(print_base);
+          s4o.print(")\n");
+        }
         s4o.print(s4o.indent_spaces + "return;\n");
         s4o.indent_left();
         s4o.print(s4o.indent_spaces + "} // ");
@@ -1376,13 +1599,65 @@ class generate_c_pous_c {
 /***********************************************************************/
 /***********************************************************************/
 
+/* The retain segments (-O k, see accessor.h) */
+/* Does any of the global variables go into the retain segment?
+ * global_vars is the global_var_declarations of a configuration or resource (may be NULL).
+ */
+class search_retain_globals_c: public iterator_visitor_c {
+  private:
+    bool in_retain;
+    bool found;
+
+  public:
+    search_retain_globals_c(void) {in_retain = false; found = false;}
+    static bool has_retain_segment(symbol_c *global_vars) {
+      if (!generate_retain_segment__ || (NULL == global_vars)) return false;
+      search_retain_globals_c search;
+      global_vars->accept(search);
+      return search.found;
+    }
+
+    void *visit(global_var_declarations_c *symbol) {
+      in_retain = (NULL != dynamic_cast<retain_option_c *>(symbol->option));
+      symbol->global_var_decl_list->accept(*this);
+      in_retain = false;
+      return NULL;
+    }
+    /* located variables (global_var_spec_c) are not placed in the segment */
+    void *visit(global_var_list_c *symbol) {if (in_retain) found = true; return NULL;}
+};
+
+
+/* Declare the retain segment of a configuration or resource. Must be printed before the global variables are declared. */
+void print_retain_segment(stage4out_c &s4o, symbol_c *domain, symbol_c *global_vars) {
+  if ((NULL == domain) || !search_retain_globals_c::has_retain_segment(global_vars)) return;
+  generate_c_base_and_typeid_c print_name(&s4o);
+  generate_c_vardecl_c vardecl(&s4o,
+                               generate_c_vardecl_c::retainsegment_vf,
+                               generate_c_vardecl_c::global_vt,
+                               domain);
+  s4o.print("struct {\n");
+  s4o.indent_right();
+  vardecl.print(global_vars);
+  s4o.indent_left();
+  s4o.print("} ");
+  domain->accept(print_name);
+  s4o.print("__retain;\n");
+  s4o.print(DECLARE_RETAIN_SEGMENT "(");
+  domain->accept(print_name);
+  s4o.print(")\n\n");
+}
+
+
 class generate_c_config_c: public generate_c_base_and_typeid_c {
     private:
     stage4out_c &s4o_incl;
+    unsigned long long common_ticktime;
     
     public:
-    generate_c_config_c(stage4out_c *s4o_ptr, stage4out_c *s4o_incl_ptr)
+    generate_c_config_c(stage4out_c *s4o_ptr, stage4out_c *s4o_incl_ptr, unsigned long long time)
       : generate_c_base_and_typeid_c(s4o_ptr), s4o_incl(*s4o_incl_ptr) {
+      common_ticktime = time;
     };
 
     virtual ~generate_c_config_c(void) {}
@@ -1396,6 +1671,75 @@ class generate_c_config_c: public generate_c_base_and_typeid_c {
 
     declaretype_t wanted_declaretype;
 
+    private:
+    /* the name of a resource (a single_resource_declaration_c is named RESOURCE) */
+    void print_resource_name(symbol_c *resource) {
+      resource_declaration_c *resource_decl = dynamic_cast<resource_declaration_c *>(resource);
+      if (NULL == resource_decl) s4o.print("RESOURCE");
+      else                       resource_decl->resource_name->accept(*this);
+    }
+
+    /* With resource threads (-O r), print the number of resources and of execution units (see accessor.h) */
+    void print_unit_count_defines(stage4out_c &out, std::vector<symbol_c *> &resources) {
+      int units = 0;
+      for (unsigned int i = 0; i < resources.size(); i++)
+        units += resource_units_c(resources[i], common_ticktime).count();
+      out.print("#define __IEC_RESOURCE_COUNT ");
+      out.print((int)resources.size());
+      out.print("\n#define __IEC_UNIT_COUNT ");
+      out.print((units > 0)? units : 1);  /* used to size arrays */
+      out.print("\n\n");
+    }
+
+    /* With resource threads (-O r), print the tables of the resources and of the execution units (see accessor.h) */
+    void print_unit_tables(std::vector<symbol_c *> &resources) {
+      int units = 0;
+      s4o.print("\n\nconst int __iec_resource_count = ");
+      s4o.print((int)resources.size());
+      s4o.print(";\nconst __IEC_RESOURCE_t __iec_resources[__IEC_RESOURCE_COUNT] = {\n");
+      for (unsigned int i = 0; i < resources.size(); i++) {
+        resource_units_c res_units(resources[i], common_ticktime);
+        s4o.print("  {\"");
+        print_resource_name(resources[i]);
+        s4o.print("\", ");
+        s4o.print_long_long_integer(res_units.ticktime);
+        s4o.print(", ");
+        print_resource_name(resources[i]);
+        s4o.print(FB_RUN_SUFFIX);
+        s4o.print("},\n");
+        units += res_units.count();
+      }
+      s4o.print("};\n\n");
+
+      s4o.print("const int __iec_unit_count = ");
+      s4o.print(units);
+      s4o.print(";\nconst __IEC_UNIT_t __iec_units[__IEC_UNIT_COUNT] = {\n");
+      if (0 == units)
+        s4o.print("  {0}\n");
+      for (unsigned int i = 0; i < resources.size(); i++) {
+        resource_units_c res_units(resources[i], common_ticktime);
+        for (int unit = 0; unit < res_units.count(); unit++) {
+          unsigned long long period = res_units.period_of(unit);
+          s4o.print("  {\"");
+          print_resource_name(resources[i]);
+          if (unit < (int)res_units.tasks.size()) {
+            s4o.print(".");
+            res_units.tasks[unit]->task_name->accept(*this);
+          }
+          s4o.print("\", ");
+          s4o.print((int)i);
+          s4o.print(", ");
+          s4o.print_long_long_integer(period);
+          s4o.print(", ");
+          s4o.print_long_integer(period / res_units.ticktime);
+          s4o.print(", ");
+          print_resource_name(resources[i]);
+          s4o.print("_run_unit__},\n");
+        }
+      }
+      s4o.print("};\n");
+    }
+
     
 public:
 /********************/
@@ -1430,6 +1774,8 @@ SYM_REF6(configuration_declaration_c, configuration_name, global_var_declaration
 */
 void *visit(configuration_declaration_c *symbol) {
   generate_c_vardecl_c *vardecl;
+  std::vector<symbol_c *> resources;
+  resource_units_c::get_resources(symbol->resource_declarations, resources);
   
   /* Insert the header... */
   s4o.print("/*******************************************/\n");
@@ -1437,25 +1783,35 @@ void *visit(configuration_declaration_c *symbol) {
   s4o.print("/* Editing this file is not recommended... */\n");
   s4o.print("/*******************************************/\n\n");
   
-  if (runtime_options.disable_implicit_en_eno) {
-    // If we are not generating the EN and ENO parameters for functions and FB,
-    //   then make sure we use the standard library version compiled without these parameters too!
-    s4o.print("#ifndef DISABLE_EN_ENO_PARAMETERS\n");
-    s4o.print("#define DISABLE_EN_ENO_PARAMETERS\n");
-    s4o.print("#endif\n");
-  }
+  print_stdlib_variant_defines(s4o);
   
   s4o.print("#include \"iec_std_lib.h\"\n\n");
   s4o.print("#include \"accessor.h\"\n\n"); 
   s4o.print("#include \"POUS.h\"\n\n");
+  if (generate_plc_state_backup_fuctions__)
+    s4o.print("#include \"iec_backup.h\"\n\n");
 
   /* (A) configuration declaration... */
   /* (A.1) configuration name in comment */
   s4o.print("// CONFIGURATION ");
   symbol->configuration_name->accept(*this);
   s4o.print("\n");
+
+  /* (A.1.1) the table of forced variables (see accessor.h) */
+  if (generate_production_accessors__)
+    s4o.print("__DECLARE_FORCE_TABLE\n\n");
+
+  /* (A.1.2) the number of execution units, used by the global variables (see accessor.h) */
+  if (generate_resource_threads__) {
+    print_unit_count_defines(s4o, resources);
+    print_unit_count_defines(s4o_incl, resources);
+    s4o.print("__thread int __iec_current_unit = -1;\n\n");
+  }
   
   /* (A.2) Global variables */
+  /* (A.2.1) The retain segment (-O k) */
+  print_retain_segment(s4o, symbol->configuration_name, symbol->global_var_declarations);
+  /* (A.2.2) The global variables */
   vardecl = new generate_c_vardecl_c(&s4o,
                                      generate_c_vardecl_c::local_vf,
                                      generate_c_vardecl_c::global_vt,
@@ -1518,49 +1874,73 @@ void *visit(configuration_declaration_c *symbol) {
   s4o.print(FB_RUN_SUFFIX);
   s4o.print("(unsigned long tick) {\n");
   s4o.indent_right();
+  if (generate_production_accessors__)
+    s4o.print(s4o.indent_spaces + "__APPLY_FORCE_TABLE\n");
 
   /* (C.3) Resources initializations... */
   wanted_declaretype = rundeclare_dt;
   symbol->resource_declarations->accept(*this);
 
-  /* (C.3) Close Public Function body */
+  /* (C.3) Apply the forced values again, over the values written during this cycle */
+  if (generate_production_accessors__)
+    s4o.print(s4o.indent_spaces + "__APPLY_FORCE_TABLE\n");
+
+  /* (C.4) Close Public Function body */
   s4o.indent_left();
   s4o.print(s4o.indent_spaces + "}\n");
 
+  /* (D) The resources and execution units, to be run by iec_threads.h */
+  if (generate_resource_threads__)
+    print_unit_tables(resources);
+
+  /* (E) The retain segments */
+  if (generate_retain_segment__)
+    print_retain_segment_table(symbol, resources);
+
   return NULL;
 }
 
-void *visit(resource_declaration_c *symbol) {
-  if (wanted_declaretype == initprotos_dt || wanted_declaretype == runprotos_dt) {
-    s4o.print(s4o.indent_spaces + "void ");
-    symbol->resource_name->accept(*this);
-    if (wanted_declaretype == initprotos_dt) {
-      s4o.print(FB_INIT_SUFFIX);
-      s4o.print("(void);\n");
-    }
-    else {
-      s4o.print(FB_RUN_SUFFIX);
-      s4o.print("(unsigned long tick);\n");
-    }
+/* const __IEC_RETAIN_SEGMENT_t *__iec_retain_segments[] = {&CONFIG__retain_segment, &RES1__retain_segment, NULL}; */
+void print_retain_segment_table(configuration_declaration_c *symbol, std::vector<symbol_c *> &resources) {
+  std::vector<symbol_c *> domains;
+  if (search_retain_globals_c::has_retain_segment(symbol->global_var_declarations))
+    domains.push_back(symbol->configuration_name);
+  for (unsigned int i = 0; i < resources.size(); i++) {
+    resource_declaration_c *resource = dynamic_cast<resource_declaration_c *>(resources[i]);
+    if ((NULL != resource) && search_retain_globals_c::has_retain_segment(resource->global_var_declarations))
+      domains.push_back(resource->resource_name);
   }
-  if (wanted_declaretype == initdeclare_dt || wanted_declaretype == rundeclare_dt) {
-    s4o.print(s4o.indent_spaces);
-    symbol->resource_name->accept(*this);
-    if (wanted_declaretype == initdeclare_dt) {
-      s4o.print(FB_INIT_SUFFIX);
-      s4o.print("();\n");
-    }
-    else {
-      s4o.print(FB_RUN_SUFFIX);
-      s4o.print("(tick);\n");
-    }
+
+  s4o.print("\n");
+  for (unsigned int i = 0; i < domains.size(); i++) {
+    if (domains[i] == symbol->configuration_name) continue;
+    s4o.print("extern const __IEC_RETAIN_SEGMENT_t ");
+    domains[i]->accept(*this);
+    s4o.print("__retain_segment;\n");
   }
-  return NULL;
+  s4o.print("const __IEC_RETAIN_SEGMENT_t *__iec_retain_segments[] = {");
+  for (unsigned int i = 0; i < domains.size(); i++) {
+    s4o.print("&");
+    domains[i]->accept(*this);
+    s4o.print("__retain_segment, ");
+  }
+  s4o.print("NULL};\n");
+}
+
+void *visit(resource_declaration_c *symbol) {
+  return print_resource(symbol);
 }
 
 void *visit(single_resource_declaration_c *symbol) {
+  return print_resource(symbol);
+}
+
+private:
+/* symbol is either a resource_declaration_c or a single_resource_declaration_c */
+void *print_resource(symbol_c *symbol) {
   if (wanted_declaretype == initprotos_dt || wanted_declaretype == runprotos_dt) {
-    s4o.print(s4o.indent_spaces + "void RESOURCE");
+    s4o.print(s4o.indent_spaces + "void ");
+    print_resource_name(symbol);
     if (wanted_declaretype == initprotos_dt) {
       s4o.print(FB_INIT_SUFFIX);
       s4o.print("(void);\n");
@@ -1568,14 +1948,35 @@ void *visit(single_resource_declaration_c *symbol) {
     else {
       s4o.print(FB_RUN_SUFFIX);
       s4o.print("(unsigned long tick);\n");
+      if (generate_resource_threads__) {
+        s4o.print(s4o.indent_spaces + "void ");
+        print_resource_name(symbol);
+        s4o.print("_run_unit__(int unit, unsigned long tick);\n");
+      }
     }
   }
   if (wanted_declaretype == initdeclare_dt || wanted_declaretype == rundeclare_dt) {
-    s4o.print(s4o.indent_spaces + "RESOURCE");
+    /* with resource threads each resource counts its own ticks, whose period may be longer than common_ticktime */
+    unsigned long long resource_ticks = 1;
+    if ((wanted_declaretype == rundeclare_dt) && generate_resource_threads__)
+      resource_ticks = resource_units_c(symbol, common_ticktime).ticktime / common_ticktime;
+    s4o.print(s4o.indent_spaces);
+    if (resource_ticks > 1) {
+      s4o.print("if (!(tick % ");
+      s4o.print_long_long_integer(resource_ticks, false);
+      s4o.print(")) ");
+    }
+    print_resource_name(symbol);
     if (wanted_declaretype == initdeclare_dt) {
       s4o.print(FB_INIT_SUFFIX);
       s4o.print("();\n");
     }
+    else if (resource_ticks > 1) {
+      s4o.print(FB_RUN_SUFFIX);
+      s4o.print("(tick / ");
+      s4o.print_long_long_integer(resource_ticks, false);
+      s4o.print(");\n");
+    }
     else {
       s4o.print(FB_RUN_SUFFIX);
       s4o.print("(tick);\n");
@@ -1609,6 +2010,23 @@ class generate_c_resources_c: public generate_c_base_and_typeid_c {
     symbol_c *current_task_name;
     symbol_c *current_global_vars;
     bool configuration_name;
+    /* With resource threads (-O r)... */
+    resource_units_c *units;     /* the execution units of the resource (NULL without -O r) */
+    int unit_base;               /* the number of the first unit of the resource */
+    bool generating_unit;        /* generating the code of a single unit... */
+    symbol_c *unit_task_name;    /* ...which runs the programs of this task (NULL: the programs not associated to any task) */
+    bool include_pous;           /* include POUS.c (only in the first resource of the configuration) */
+
+    /* How the periodic tasks are activated (see plan_dispatch())... */
+    typedef enum {
+      modulo_dispatch,  /* each task tests the tick counter:  TASK = !(tick % period) */
+      table_dispatch,   /* from a table over the hyperperiod: TASK = (__dispatch_table[tick % hyperperiod] >> i) & 1 */
+      wheel_dispatch    /* from a timer wheel (see iec_std_lib.h) */
+    } dispatch_t;
+    dispatch_t dispatch;
+    std::vector<symbol_c *>         periodic_tasks;  /* the tasks with a (non zero) INTERVAL, and no SINGLE */
+    std::vector<unsigned long long> periodic_ticks;  /* their periods, in ticks */
+    unsigned long long              hyperperiod;     /* in ticks */
 
   public:
     generate_c_resources_c(stage4out_c *s4o_ptr, symbol_c *config_scope, symbol_c *resource_scope, unsigned long long time)
@@ -1621,8 +2039,27 @@ class generate_c_resources_c: public generate_c_base_and_typeid_c {
       current_task_name = NULL;
       current_global_vars = NULL;
       configuration_name = false;
+      units = NULL;
+      unit_base = 0;
+      generating_unit = false;
+      unit_task_name = NULL;
+      include_pous = true;
+      dispatch = modulo_dispatch;
+      hyperperiod = 1;
     };
 
+    /* The code of the POUs (POUS.c) is included by a single resource of the configuration, so the
+     * resources may be linked into the same program. Must be called before visiting the resource.
+     */
+    void set_include_pous(bool include) {include_pous = include;}
+
+    /* Generate the code of each execution unit of the resource (-O r). Must be called before visiting the resource. */
+    void set_units(resource_units_c *resource_units, int first_unit) {
+      units = resource_units;
+      unit_base = first_unit;
+      common_ticktime = units->ticktime;
+    }
+
     virtual ~generate_c_resources_c(void) {
       delete search_config_instance;
       delete search_resource_instance;
@@ -1743,6 +2180,7 @@ END_RESOURCE
       if (single_resource)
         current_resource_name = new identifier_c("RESOURCE");
       generate_c_vardecl_c *vardecl;
+      plan_dispatch(symbol);
       
       /* Insert the header... */
       s4o.print("/*******************************************/\n");
@@ -1750,13 +2188,7 @@ END_RESOURCE
       s4o.print("/* Editing this file is not recommended... */\n");
       s4o.print("/*******************************************/\n\n");
   
-      if (runtime_options.disable_implicit_en_eno) {
-        // If we are not generating the EN and ENO parameters for functions and FB,
-        //   then make sure we use the standard library version compiled without these parameters too!
-        s4o.print("#ifndef DISABLE_EN_ENO_PARAMETERS\n");
-        s4o.print("#define DISABLE_EN_ENO_PARAMETERS\n");
-        s4o.print("#endif\n");
-      }
+      print_stdlib_variant_defines(s4o);
       
       s4o.print("#include \"iec_std_lib.h\"\n\n");
       
@@ -1776,7 +2208,8 @@ END_RESOURCE
       configuration_name = false;
       s4o.print(".h\"\n");
 
-      /* (A.2) Global variables... */
+      /* (A.2) Global variables (and the retain segment, -O k)... */
+      print_retain_segment(s4o, current_resource_name, current_global_vars);
       if (current_global_vars != NULL) {
         vardecl = new generate_c_vardecl_c(&s4o,
                                            generate_c_vardecl_c::local_vf,
@@ -1788,7 +2221,18 @@ END_RESOURCE
       }
       
       /* (A.3) POUs inclusion */
-      s4o.print("#include \"POUS.c\"\n\n");
+      if (include_pous)
+        s4o.print("#include \"POUS.c\"\n\n");
+
+      /* (A.3.1) The functions that exchange the values of the global variables with the execution units (see accessor.h) */
+      if (NULL != units) {
+        s4o.print("void ");
+        current_resource_name->accept(*this);
+        s4o.print("_load_globals__(int unit);\n");
+        s4o.print("void ");
+        current_resource_name->accept(*this);
+        s4o.print("_store_globals__(int unit);\n\n");
+      }
       
       wanted_declaretype = declare_dt;
       
@@ -1797,6 +2241,18 @@ END_RESOURCE
       
       /* (A.5) Resource programs declaration... */
       symbol->program_configuration_list->accept(*this);
+
+      /* (A.6) The table (or timer wheel) that activates the periodic tasks... */
+      print_dispatch_declaration();
+
+      /* (A.7) The counter of the calls to the run function (see iec_profile.h) */
+      if (generate_pou_profile__) {
+        s4o.print("__DECLARE_PROFILE(");
+        current_resource_name->accept(*this);
+        s4o.print(", \"");
+        current_resource_name->accept(*this);
+        s4o.print("\")\n");
+      }
       
       s4o.print("\n");
       
@@ -1828,31 +2284,41 @@ END_RESOURCE
       
       /* (B.3) Tasks initialisations... */
       symbol->task_configuration_list->accept(*this);
+      print_dispatch_initialization();
       
       /* (B.4) Resource programs initialisations... */
       symbol->program_configuration_list->accept(*this);
+      if (NULL != units)
+        s4o.print(s4o.indent_spaces + "__iec_current_unit = -1;\n");
       
       s4o.indent_left();
       s4o.print("}\n\n");
       
       /* (C) Resource run function... */
-      /* (C.1) Run function name... */
-      s4o.print("void ");
-      current_resource_name->accept(*this);
-      s4o.print(FB_RUN_SUFFIX);
-      s4o.print("(unsigned long tick) {\n");
-      s4o.indent_right();
+      if (NULL != units) {
+        print_units_run(symbol);
+      } else {
+        /* (C.1) Run function name... */
+        s4o.print("void ");
+        current_resource_name->accept(*this);
+        s4o.print(FB_RUN_SUFFIX);
+        s4o.print("(unsigned long tick) {\n");
+        s4o.indent_right();
+        print_run_profile_begin();
       
-      wanted_declaretype = run_dt;
+        wanted_declaretype = run_dt;
       
-      /* (C.2) Task management... */
-      symbol->task_configuration_list->accept(*this);
+        /* (C.2) Task management... */
+        print_dispatch_run();
+        symbol->task_configuration_list->accept(*this);
       
-      /* (C.3) Program run declaration... */
-      symbol->program_configuration_list->accept(*this);
+        /* (C.3) Program run declaration... */
+        symbol->program_configuration_list->accept(*this);
       
-      s4o.indent_left();
-      s4o.print("}\n\n");
+        print_run_profile_end();
+        s4o.indent_left();
+        s4o.print("}\n\n");
+      }
       
       if (single_resource) {
         delete current_resource_name;
@@ -1861,9 +2327,241 @@ END_RESOURCE
       return NULL;
     }
     
+  private:
+    /* Largest table of the tasks due at each tick, and largest number of tasks in each entry of the table */
+    #define DISPATCH_TABLE_MAX_SIZE  1024
+    #define DISPATCH_TABLE_MAX_TASKS 64
+
+    static unsigned long long gcd(unsigned long long a, unsigned long long b) {
+      while (b != 0) {unsigned long long c = a % b; a = b; b = c;}
+      return a;
+    }
+
+    /* Decide how the periodic tasks of the resource will be activated.
+     * With two or more periodic tasks each tick would test the tick counter once per task, so instead we
+     * generate a table of the tasks due at each tick of the hyperperiod (one bit per task), or, if the table
+     * would be too large, use a timer wheel.
+     * With resource threads (-O r) each unit activates its own task, so these keep testing the tick counter.
+     */
+    void plan_dispatch(single_resource_declaration_c *symbol) {
+      dispatch = modulo_dispatch;
+      periodic_tasks.clear();
+      periodic_ticks.clear();
+      hyperperiod = 1;
+      if (NULL != units) return;
+
+      list_c *task_list = dynamic_cast<list_c *>(symbol->task_configuration_list);
+      for (int i = 0; (NULL != task_list) && (i < task_list->n); i++) {
+        task_configuration_c  *task      = dynamic_cast<task_configuration_c *>(task_list->get_element(i));
+        task_initialization_c *task_init = (NULL == task)? NULL : dynamic_cast<task_initialization_c *>(task->task_initialization);
+        if ((NULL == task_init) || (NULL != task_init->single_data_source) || (NULL == task_init->interval_data_source)) continue;
+        unsigned long long time = calculate_time(task_init->interval_data_source);
+        if (0 == time) continue;
+        periodic_tasks.push_back(task->task_name);
+        periodic_ticks.push_back(time / common_ticktime);
+      }
+      if (periodic_tasks.size() < 2) return;
+
+      dispatch = table_dispatch;
+      for (unsigned int i = 0; (i < periodic_ticks.size()) && (table_dispatch == dispatch); i++) {
+        hyperperiod = hyperperiod / gcd(hyperperiod, periodic_ticks[i]) * periodic_ticks[i];
+        if (hyperperiod > DISPATCH_TABLE_MAX_SIZE) dispatch = wheel_dispatch;
+      }
+      if (periodic_tasks.size() > DISPATCH_TABLE_MAX_TASKS) dispatch = wheel_dispatch;
+    }
+
+    /* The position of the task in periodic_tasks, or -1 */
+    int periodic_task_index(symbol_c *task_name) {
+      for (unsigned int i = 0; i < periodic_tasks.size(); i++)
+        if (compare_identifiers(periodic_tasks[i], task_name) == 0) return i;
+      return -1;
+    }
+
+    const char *dispatch_table_type(void) {
+      if (periodic_tasks.size() <=  8) return "BYTE";
+      if (periodic_tasks.size() <= 16) return "WORD";
+      if (periodic_tasks.size() <= 32) return "DWORD";
+      return "LWORD";
+    }
+
+    void print_dispatch_declaration(void) {
+      if (table_dispatch == dispatch) {
+        s4o.print("static const ");
+        s4o.print(dispatch_table_type());
+        s4o.print(" __dispatch_table[");
+        s4o.print_long_long_integer(hyperperiod, false);
+        s4o.print("] = { /* the tasks due at each tick of the hyperperiod */");
+        for (unsigned long long tick = 0; tick < hyperperiod; tick++) {
+          unsigned long long due = 0;
+          char str[32];
+          for (unsigned int i = 0; i < periodic_ticks.size(); i++)
+            if (0 == tick % periodic_ticks[i]) due |= 1ULL << i;
+          snprintf(str, sizeof(str), "0x%llx,", due);
+          s4o.print((0 == tick % 8)? "\n  " : " ");
+          s4o.print(str);
+        }
+        s4o.print("\n};\n");
+      }
+      if (wheel_dispatch == dispatch) {
+        s4o.print("static __task_wheel_t __task_wheel;\n");
+        s4o.print("static __task_wheel_entry_t __task_wheel_entries[");
+        s4o.print((int)periodic_tasks.size());
+        s4o.print("];\n");
+      }
+    }
+
+    void print_dispatch_initialization(void) {
+      if (wheel_dispatch == dispatch) {
+        for (unsigned int i = 0; i < periodic_ticks.size(); i++) {
+          s4o.print(s4o.indent_spaces + "__task_wheel_entries[");
+          s4o.print((int)i);
+          s4o.print("].period = ");
+          s4o.print_long_long_integer(periodic_ticks[i]);
+          s4o.print(";\n");
+        }
+        s4o.print(s4o.indent_spaces + "__task_wheel_init(&__task_wheel, __task_wheel_entries, ");
+        s4o.print((int)periodic_tasks.size());
+        s4o.print(");\n");
+      }
+    }
+
+    void print_dispatch_run(void) {
+      if (table_dispatch == dispatch) {
+        s4o.print(s4o.indent_spaces + dispatch_table_type());
+        s4o.print(" __due_tasks = __dispatch_table[tick % ");
+        s4o.print_long_long_integer(hyperperiod, false);
+        s4o.print("];\n");
+      }
+      if (wheel_dispatch == dispatch)
+        s4o.print(s4o.indent_spaces + "__task_wheel_tick(&__task_wheel, __task_wheel_entries);\n");
+    }
+
+    void print_unit_number(int unit) {
+      s4o.print(unit_base + unit);
+    }
+
+    /* With resource threads (-O r) the run function of the resource is split into the run functions of its
+     * execution units (a switch on the unit number), each of which runs the programs of a single task
+     * (or the programs not associated to any task), on its own copy of the global variables.
+     *   void <resource>_run_unit__(int unit, unsigned long tick);
+     * The run function of the resource runs all the units, in the order in which the tasks were declared
+     * (the programs not associated to any task run last).
+     */
+    /* Time the run function of the resource (see iec_profile.h) */
+    void print_run_profile_begin(void) {
+      if (generate_pou_profile__)
+        s4o.print(s4o.indent_spaces + "__IEC_PROFILE_BEGIN\n");
+    }
+
+    void print_run_profile_end(void) {
+      if (!generate_pou_profile__) return;
+      s4o.print(s4o.indent_spaces + "__IEC_PROFILE_END(");
+      current_resource_name->accept(*this);
+      s4o.print(")\n");
+    }
+
+    void print_units_run(single_resource_declaration_c *symbol) {
+      wanted_declaretype = run_dt;
+
+      /* (C.1) The run function of each unit */
+      s4o.print("void ");
+      current_resource_name->accept(*this);
+      s4o.print("_run_unit__(int unit, unsigned long tick) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "switch (unit) {\n");
+      s4o.indent_right();
+      generating_unit = true;
+      for (int unit = 0; unit < units->count(); unit++) {
+        bool has_task = unit < (int)units->tasks.size();
+        task_configuration_c *task = has_task? units->tasks[unit] : NULL;
+        task_initialization_c *task_init = has_task? dynamic_cast<task_initialization_c *>(task->task_initialization) : NULL;
+        bool single = (NULL != task_init) && (NULL != task_init->single_data_source);
+        unit_task_name = has_task? task->task_name : NULL;
+
+        s4o.print(s4o.indent_spaces + "case ");
+        print_unit_number(unit);
+        s4o.print(": {\n");
+        s4o.indent_right();
+        /* the trigger of a SINGLE task reads a global variable, so it must run inside the unit */
+        if (single || !has_task) {
+          s4o.print(s4o.indent_spaces + "__IEC_UNIT_BEGIN(");
+          print_unit_number(unit);
+          s4o.print(", ");
+          current_resource_name->accept(*this);
+          s4o.print(")\n");
+        }
+        if (has_task) {
+          task->accept(*this);
+          s4o.print(s4o.indent_spaces + "if (");
+          task->task_name->accept(*this);
+          s4o.print(") {\n");
+          s4o.indent_right();
+        }
+        if (has_task && !single) {
+          s4o.print(s4o.indent_spaces + "__IEC_UNIT_BEGIN(");
+          print_unit_number(unit);
+          s4o.print(", ");
+          current_resource_name->accept(*this);
+          s4o.print(")\n");
+        }
+        symbol->program_configuration_list->accept(*this);
+        if (has_task && !single) {
+          s4o.print(s4o.indent_spaces + "__IEC_UNIT_END(");
+          print_unit_number(unit);
+          s4o.print(", ");
+          current_resource_name->accept(*this);
+          s4o.print(")\n");
+        }
+        if (has_task) {
+          s4o.indent_left();
+          s4o.print(s4o.indent_spaces + "}\n");
+        }
+        if (single || !has_task) {
+          s4o.print(s4o.indent_spaces + "__IEC_UNIT_END(");
+          print_unit_number(unit);
+          s4o.print(", ");
+          current_resource_name->accept(*this);
+          s4o.print(")\n");
+        }
+        s4o.print(s4o.indent_spaces + "break;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
+      generating_unit = false;
+      unit_task_name = NULL;
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.indent_left();
+      s4o.print("}\n\n");
+
+      /* (C.2) The run function of the resource */
+      s4o.print("void ");
+      current_resource_name->accept(*this);
+      s4o.print(FB_RUN_SUFFIX);
+      s4o.print("(unsigned long tick) {\n");
+      s4o.indent_right();
+      print_run_profile_begin();
+      for (int unit = 0; unit < units->count(); unit++) {
+        s4o.print(s4o.indent_spaces);
+        current_resource_name->accept(*this);
+        s4o.print("_run_unit__(");
+        print_unit_number(unit);
+        s4o.print(", tick);\n");
+      }
+      print_run_profile_end();
+      s4o.indent_left();
+      s4o.print("}\n\n");
+    }
+
+  public:
 /*  PROGRAM [RETAIN | NON_RETAIN] program_name [WITH task_name] ':' program_type_name ['(' prog_conf_elements ')'] */
 //SYM_REF6(program_configuration_c, retain_option, program_name, task_name, program_type_name, prog_conf_elements, unused)
     void *visit(program_configuration_c *symbol) {
+      /* only the programs of the unit being generated (-O r) */
+      if (generating_unit) {
+        if ((NULL == unit_task_name) != (NULL == symbol->task_name)) return NULL;
+        if ((NULL != unit_task_name) && (compare_identifiers(unit_task_name, symbol->task_name) != 0)) return NULL;
+      }
       switch (wanted_declaretype) {
         case declare_dt:
           s4o.print(s4o.indent_spaces);
@@ -1879,10 +2577,28 @@ END_RESOURCE
           s4o.print("__");
           symbol->program_name->accept(*this);
           s4o.print("\n");
+          if (generate_pou_profile__) {
+            /* the counter of the calls to this instance (see iec_profile.h) */
+            s4o.print("__DECLARE_PROFILE(");
+            current_resource_name->accept(*this);
+            s4o.print("__");
+            symbol->program_name->accept(*this);
+            s4o.print(", \"");
+            current_resource_name->accept(*this);
+            s4o.print(".");
+            symbol->program_name->accept(*this);
+            s4o.print("\")\n");
+          }
           break;
         case init_dt:
           if (symbol->retain_option != NULL)
             symbol->retain_option->accept(*this);
+          /* bind the externals of the program to the copies of the global variables of its unit (see accessor.h) */
+          if (NULL != units) {
+            s4o.print(s4o.indent_spaces + "__iec_current_unit = ");
+            print_unit_number(units->unit_of(symbol->task_name));
+            s4o.print(";\n");
+          }
           s4o.print(s4o.indent_spaces);
           symbol->program_type_name->accept(*this);
           s4o.print(FB_INIT_SUFFIX);
@@ -1896,7 +2612,7 @@ END_RESOURCE
             if (NULL == tmp_id) ERROR;
             current_program_name = tmp_id->value;
 	  }
-          if (symbol->task_name != NULL) {
+          if ((symbol->task_name != NULL) && !generating_unit) {
             s4o.print(s4o.indent_spaces);
             s4o.print("if (");
             symbol->task_name->accept(*this);
@@ -1909,17 +2625,24 @@ END_RESOURCE
             symbol->prog_conf_elements->accept(*this);
           
           s4o.print(s4o.indent_spaces);
+          if (generate_pou_profile__) {
+            s4o.print("__IEC_PROFILE_CALL(");
+            current_resource_name->accept(*this);
+            s4o.print("__");
+            symbol->program_name->accept(*this);
+            s4o.print(", ");
+          }
           symbol->program_type_name->accept(*this);
           s4o.print(FB_FUNCTION_SUFFIX);
           s4o.print("(&");
           symbol->program_name->accept(*this);
-          s4o.print(");\n");
+          s4o.print(generate_pou_profile__? "))\n" : ");\n");
           
           wanted_assigntype = send_at;
           if (symbol->prog_conf_elements != NULL)
             symbol->prog_conf_elements->accept(*this);
           
-          if (symbol->task_name != NULL) {
+          if ((symbol->task_name != NULL) && !generating_unit) {
             s4o.indent_left();
             s4o.print(s4o.indent_spaces + "}\n");
           }
@@ -2023,7 +2746,18 @@ END_RESOURCE
             s4o.print(" = ");
             if (symbol->interval_data_source != NULL) {
               unsigned long long int time = calculate_time(symbol->interval_data_source);
-              if (time != 0) {
+              int task_index = periodic_task_index(current_task_name);
+              if ((time != 0) && (table_dispatch == dispatch)) {
+                s4o.print("(__due_tasks >> ");
+                s4o.print(task_index);
+                s4o.print(") & 1");
+              }
+              else if ((time != 0) && (wheel_dispatch == dispatch)) {
+                s4o.print("(__task_wheel_entries[");
+                s4o.print(task_index);
+                s4o.print("].fired == __task_wheel.tick)");
+              }
+              else if (time != 0) {
                 s4o.print("!(tick % ");
                 s4o.print(time / common_ticktime);
                 s4o.print(")");
@@ -2130,6 +2864,12 @@ END_RESOURCE
 #define RESTORE_  "_restore__"
 #define BACKUP_   "_backup__"
 
+/* The operations done by the generated backup/restore functions, each calling the
+ * function of the same name on each variable. The _xxx_blocks__ operations implement
+ * the incremental backup (see lib/C/iec_backup.h).
+ */
+static const char *backup_operations[] = {"_backup__", "_restore__", "_backup_blocks__", "_restore_blocks__", NULL};
+
 /* class to generate the forward declaration of the XXXX_backup() and XXXX_restore()
  * functions that will later (in the generated C source code) be defined 
  * to backup/restore the global state of each RESOURCE in the source code being compiled.
@@ -2141,14 +2881,13 @@ class generate_c_backup_resource_decl_c: public generate_c_base_and_typeid_c {
       : generate_c_base_and_typeid_c(s4o_ptr) {};
       
     void *visit(resource_declaration_c *symbol) {
-      s4o.print(s4o.indent_spaces);
-      s4o.print("void ");
-      symbol->resource_name->accept(*this);
-      s4o.print("_backup__" "(void **buffer, int *maxsize);\n");      
-      s4o.print(s4o.indent_spaces);
-      s4o.print("void ");
-      symbol->resource_name->accept(*this);
-      s4o.print("_restore__" "(void **buffer, int *maxsize);\n");      
+      for (int i = 0; backup_operations[i] != NULL; i++) {
+        s4o.print(s4o.indent_spaces);
+        s4o.print("void ");
+        symbol->resource_name->accept(*this);
+        s4o.print(backup_operations[i]);
+        s4o.print("(void **buffer, int *maxsize);\n");
+      }
       return NULL;
     }
     
@@ -2163,6 +2902,22 @@ class generate_c_backup_resource_decl_c: public generate_c_base_and_typeid_c {
 };
 
 
+/* Undefine the __DECLARE_GLOBAL_xxx macros, before re-expanding the declarations of the global
+ * variables with locally redefined macros (as in the generated backup/restore functions).
+ * The variables placed in the retain segments (-O k) are declared with the same macros as the others.
+ */
+void print_undef_global_declarations(stage4out_c &s4o) {
+  s4o.print("#undef " DECLARE_GLOBAL          "\n");
+  s4o.print("#undef " DECLARE_GLOBAL_FB       "\n");
+  s4o.print("#undef " DECLARE_GLOBAL_LOCATION "\n");
+  s4o.print("#undef " DECLARE_GLOBAL_LOCATED  "\n");
+  s4o.print("#undef " DECLARE_GLOBAL_RETAIN    "\n");
+  s4o.print("#undef " DECLARE_GLOBAL_FB_RETAIN "\n");
+  s4o.print("#define " DECLARE_GLOBAL_RETAIN    "(vartype, domain, varname) " DECLARE_GLOBAL    "(vartype, domain, varname)\n");
+  s4o.print("#define " DECLARE_GLOBAL_FB_RETAIN "(vartype, domain, varname) " DECLARE_GLOBAL_FB "(vartype, domain, varname)\n");
+}
+
+
 /* print out the begining of the generic backup/restore function */
 void print_backup_restore_function_beg(stage4out_c &s4o, const char *func_name, const char *operation) {
   /* operation will be either "_backup__" or "_restore__" */
@@ -2230,18 +2985,14 @@ private:
     void print_forward_declarations(void) {
       s4o.print("\n\n\n");
   
-      s4o.print("void ");
-      s4o.print("_backup__");
-      s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize);\n");
-      s4o.print("void ");
-      s4o.print("_restore__");
-      s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize);\n");
+      for (int i = 0; backup_operations[i] != NULL; i++) {
+        s4o.print("void ");
+        s4o.print(backup_operations[i]);
+        s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize);\n");
+      }
   
       s4o.print("\n\n\n");
-      s4o.print("#undef " DECLARE_GLOBAL          "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_FB       "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_LOCATION "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_LOCATED  "\n");
+      print_undef_global_declarations(s4o);
     }
 
   public:
@@ -2267,25 +3018,17 @@ private:
       
       print_forward_declarations();
       
-      print_backup_restore_function_beg(s4o, resource_name, "_backup__");
-      if (symbol->global_var_declarations != NULL)   
-        vardecl.print(symbol->global_var_declarations);
-      if (symbol->resource_declaration != NULL) {
-        operation = "_backup__";
-        symbol->resource_declaration->accept(*this);  // will call visit(single_resource_declaration_c *)
-        operation = NULL;
-      }
-      print_backup_restore_function_end(s4o);      
-      
-      print_backup_restore_function_beg(s4o, resource_name, "_restore__");
-      if (symbol->global_var_declarations != NULL)
-        vardecl.print(symbol->global_var_declarations);
-      if (symbol->resource_declaration != NULL) {
-        operation = "_restore__";
-        symbol->resource_declaration->accept(*this);  // will call visit(single_resource_declaration_c *)
-        operation = NULL;
+      for (int i = 0; backup_operations[i] != NULL; i++) {
+        print_backup_restore_function_beg(s4o, resource_name, backup_operations[i]);
+        if (symbol->global_var_declarations != NULL)   
+          vardecl.print(symbol->global_var_declarations);
+        if (symbol->resource_declaration != NULL) {
+          operation = backup_operations[i];
+          symbol->resource_declaration->accept(*this);  // will call visit(single_resource_declaration_c *)
+          operation = NULL;
+        }
+        print_backup_restore_function_end(s4o);      
       }
-      print_backup_restore_function_end(s4o);      
 
       return NULL;
     }
@@ -2341,6 +3084,12 @@ private:
  *          void *buffer = malloc(-1 * maxsize);
  *          // and now to really back the internal state...
  *          config_backup__(&buffer, &maxsize);
+ *
+ *   The incremental backup functions (see lib/C/iec_backup.h)
+ *       int config_backup_delta__(void **buffer, int *maxsize)
+ *       int config_restore_delta__(void **buffer, int *maxsize)
+ *   walk over the same variables, in the same order, through the config_backup_blocks__()
+ *   and config_restore_blocks__() functions.
  */
 class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
   private:
@@ -2388,6 +3137,18 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
       s4o.print("  *maxsize -= varsize;\n");
       s4o.print("}\n");
       
+      s4o.print("void ");
+      s4o.print("_backup_blocks__");
+      s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize) {\n");
+      s4o.print("  __iec_backup_delta_var(varptr, varsize, buffer, maxsize);\n");
+      s4o.print("}\n");
+      
+      s4o.print("void ");
+      s4o.print("_restore_blocks__");
+      s4o.print("(void *varptr, int varsize, void **buffer, int *maxsize) {\n");
+      s4o.print("  __iec_restore_delta_var(varptr, varsize, buffer, maxsize);\n");
+      s4o.print("}\n");
+      
       
       generate_c_vardecl_c vardecl = generate_c_vardecl_c(&s4o,
                                          generate_c_vardecl_c::local_vf,
@@ -2395,29 +3156,33 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
                                          symbol->configuration_name);
 
       s4o.print("\n\n\n");
-      s4o.print("#undef " DECLARE_GLOBAL          "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_FB       "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_LOCATION "\n");
-      s4o.print("#undef " DECLARE_GLOBAL_LOCATED  "\n");
+      print_undef_global_declarations(s4o);
       
       generate_c_backup_resource_decl_c declare_functions = generate_c_backup_resource_decl_c(&s4o);
       symbol->resource_declarations->accept(declare_functions);
       
-      print_backup_restore_function_beg(s4o, "config", "_backup__");
-      vardecl.print(symbol);
-      s4o.print("\n");
-      func_to_call = "_backup__";
-      symbol->resource_declarations->accept(*this);  // will call resource_declaration_list_c or single_resource_declaration_c
-      func_to_call = NULL;
-      print_backup_restore_function_end(s4o);      
-    
-      print_backup_restore_function_beg(s4o, "config", "_restore__");
-      vardecl.print(symbol);
+      for (int i = 0; backup_operations[i] != NULL; i++) {
+        print_backup_restore_function_beg(s4o, "config", backup_operations[i]);
+        vardecl.print(symbol);
+        s4o.print("\n");
+        func_to_call = backup_operations[i];
+        symbol->resource_declarations->accept(*this);  // will call resource_declaration_list_c or single_resource_declaration_c
+        func_to_call = NULL;
+        print_backup_restore_function_end(s4o);      
+      }
+      
+      /* the incremental backup/restore functions */
       s4o.print("\n");
-      func_to_call = "_restore__";
-      symbol->resource_declarations->accept(*this);  // will call resource_declaration_list_c or single_resource_declaration_c
-      func_to_call = NULL;
-      print_backup_restore_function_end(s4o);      
+      s4o.print("int config_backup_delta__(void **buffer, int *maxsize) {\n");
+      s4o.print("  __iec_backup_delta_beg(buffer, maxsize);\n");
+      s4o.print("  config_backup_blocks__(buffer, maxsize);\n");
+      s4o.print("  return __iec_backup_delta_end(buffer, maxsize);\n");
+      s4o.print("}\n");
+      s4o.print("int config_restore_delta__(void **buffer, int *maxsize) {\n");
+      s4o.print("  __iec_restore_delta_beg(buffer, maxsize);\n");
+      s4o.print("  config_restore_blocks__(buffer, maxsize);\n");
+      s4o.print("  return __iec_restore_delta_end(buffer, maxsize);\n");
+      s4o.print("}\n");
       
       return NULL;
     }
@@ -2453,6 +3218,121 @@ class generate_c_backup_config_c: public generate_c_base_and_typeid_c {
 /***********************************************************************/
 /***********************************************************************/
 
+/* Generate the <pou_name>.c and <pou_name>.h files of a single POU (used with the -O p option).
+ *
+ * Each POU only depends on the declarations of the other library elements, so
+ * the file pairs of several POUs may be generated at the same time, each by a distinct
+ * thread (see generate_c_c::run_pou_filepairs()).
+ * The files are created (and their names printed out) by the constructor, so the
+ * files are always listed in the order in which the POUs appear in the library.
+ */
+template<class declaration_c> class generate_c_pou_filepair_c: public work_item_c {
+  public:
+    typedef void (*handle_pou_t)(declaration_c *symbol, stage4out_c &s4o, bool print_declaration);
+
+  private:
+    declaration_c *symbol;
+    handle_pou_t   handle_pou;
+    const char    *pou_name;
+    stage4out_c    s4o_c;
+    stage4out_c    s4o_h;
+
+  public:
+    generate_c_pou_filepair_c(const char *builddir, const char *pou_name_, declaration_c *symbol_, handle_pou_t handle_pou_)
+      : s4o_c(builddir, pou_name_, "c"), s4o_h(builddir, pou_name_, "h") {
+      symbol     = symbol_;
+      handle_pou = handle_pou_;
+      pou_name   = pou_name_;
+    }
+
+    void run(void) {
+      s4o_c.print("#include \""); s4o_c.print(pou_name); s4o_c.print(".h\"\n");
+      s4o_h.print("#ifndef __");  s4o_h.print(pou_name); s4o_h.print("_H\n");
+      s4o_h.print("#define __");  s4o_h.print(pou_name); s4o_h.print("_H\n");
+      generate_c_implicit_typedecl_c generate_c_implicit_typedecl(&s4o_h);
+      symbol->accept(generate_c_implicit_typedecl); /* generate implicitly delcared datatypes (arrays and ref_to) */
+      handle_pou(symbol, s4o_h, true);  /* generate the <pou_name>.h file */
+      handle_pou(symbol, s4o_c, false); /* generate the <pou_name>.c file */
+      s4o_h.print("#endif /* __");  s4o_h.print(pou_name); s4o_h.print("_H */\n");
+    }
+};
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+/* With resource threads (-O r), generate the functions that load the copies of the global variables
+ * of an execution unit from the shared global variables, and store them back (see accessor.h):
+ *   void <domain>_load_globals__(int unit);
+ *   void <domain>_store_globals__(int unit);
+ * The global variables are listed, as in the backup/restore functions, by re-expanding
+ * their declarations with locally redefined __DECLARE_GLOBAL_xxx macros.
+ * global_vars is either a configuration_declaration_c, or the global_var_declarations of a resource (may be NULL).
+ * NOTE: Since the __DECLARE_GLOBAL_xxx macros are left undefined, these functions must be generated
+ *       at the end of the file.
+ */
+void print_exchange_globals_functions(stage4out_c &s4o, const char *domain_name, symbol_c *domain, symbol_c *global_vars) {
+  const char *operations[] = {"load", "store"};
+  const char *macros[]     = {"__LOAD_GLOBAL_", "__STORE_GLOBAL_"};
+
+  s4o.print("\n\n");
+  print_undef_global_declarations(s4o);
+  for (int i = 0; i < 2; i++) {
+    s4o.print("\nvoid ");
+    s4o.print(domain_name);
+    s4o.print("_");
+    s4o.print(operations[i]);
+    s4o.print("_globals__(int unit) {\n");
+    s4o.indent_right();
+    s4o.print(s4o.indent_spaces);
+    s4o.print("#define " DECLARE_GLOBAL          "(vartype, domain, varname) ");
+    s4o.print(macros[i]);
+    s4o.print("##varname(unit);\n");
+    s4o.print(s4o.indent_spaces);
+    s4o.print("#define " DECLARE_GLOBAL_FB       "(vartype, domain, varname)\n");
+    s4o.print(s4o.indent_spaces);
+    s4o.print("#define " DECLARE_GLOBAL_LOCATION "(vartype, location)\n");
+    s4o.print(s4o.indent_spaces);
+    s4o.print("#define " DECLARE_GLOBAL_LOCATED  "(vartype, domain, varname)\n");
+    if (NULL != global_vars) {
+      generate_c_vardecl_c vardecl = generate_c_vardecl_c(&s4o,
+                                         generate_c_vardecl_c::local_vf,
+                                         generate_c_vardecl_c::global_vt,
+                                         domain);
+      vardecl.print(global_vars);
+      s4o.print("\n");
+    }
+    print_backup_restore_function_end(s4o);
+  }
+}
+
+
+/* Find the last enable/disable code generation pragma inside a POU (if any). */
+class search_code_generation_pragma_c: public iterator_visitor_c {
+  private:
+    symbol_c *last_pragma;
+
+  public:
+    search_code_generation_pragma_c(void) {last_pragma = NULL;}
+    static symbol_c *last_pragma_in(symbol_c *symbol) {
+      search_code_generation_pragma_c search;
+      symbol->accept(search);
+      return search.last_pragma;
+    }
+
+    void *visit(enable_code_generation_pragma_c  *symbol) {last_pragma = symbol; return NULL;}
+    void *visit(disable_code_generation_pragma_c *symbol) {last_pragma = symbol; return NULL;}
+};
+
+
+/* Maximum number of POU file pairs that are open (and being generated in parallel) at any time.
+ * Each file pair uses two file descriptors!
+ */
+#define MAX_PENDING_POU_FILEPAIRS 256
+
+
 class generate_c_c: public iterator_visitor_c {
   protected:
     stage4out_c                      &s4o;
@@ -2473,6 +3353,20 @@ class generate_c_c: public iterator_visitor_c {
     bool        allow_output;
     
     unsigned long long common_ticktime;
+    int first_unit;  /* the number of the first execution unit of the next resource (-O r) */
+    bool first_resource;  /* the next resource is the first of the configuration (and includes POUS.c) */
+
+    /* POUs whose file pairs (-O p) have been created, but not yet generated */
+    std::vector<work_item_c *> pending_pou_filepairs;
+
+    /* fingerprints of the POUs whose file pairs were generated (-O i, with -O p) */
+    generate_c_manifest_c *manifest;
+
+    /* the compiled debug symbol index (-O d) */
+    generate_debug_index_c *debug_index;
+
+    /* the function blocks and programs generated so far, each with its cycle time counter (-O c) */
+    std::vector<std::string> profiled_pous;
 
   public:
     generate_c_c(stage4out_c *s4o_ptr, const char *builddir): 
@@ -2487,9 +3381,55 @@ class generate_c_c: public iterator_visitor_c {
       current_builddir = builddir;
       current_configuration = NULL;
       allow_output = true;
+      first_unit = 0;
+      first_resource = true;
+      manifest = NULL;
+      debug_index = NULL;
+      if (generate_incremental__ && generate_pou_filepairs__)
+        manifest = new generate_c_manifest_c(builddir, generate_c_manifest_c::options_fingerprint());
     }
             
-    ~generate_c_c(void) {}
+    ~generate_c_c(void) {delete manifest;}
+
+  private:
+    /* __IEC_PROFILE_t *const __iec_profile_table[] = {&POU__profile, ..., &RES1__profile, &RES1__INST0__profile, ..., NULL}; */
+    void print_profile_table(stage4out_c &s4o, configuration_declaration_c *symbol) {
+      std::vector<symbol_c *> resources;
+      std::vector<std::string> counters;
+      resource_units_c::get_resources(symbol->resource_declarations, resources);
+      for (unsigned int i = 0; i < resources.size(); i++) {
+        resource_declaration_c        *resource = dynamic_cast<resource_declaration_c *>(resources[i]);
+        single_resource_declaration_c *single   = dynamic_cast<single_resource_declaration_c *>(resources[i]);
+        std::string resource_name = "RESOURCE";
+        if (NULL != resource) {
+          token_c *name = dynamic_cast<token_c *>(resource->resource_name);
+          if (NULL == name) ERROR;
+          resource_name = upper(name->value);
+          single = dynamic_cast<single_resource_declaration_c *>(resource->resource_declaration);
+        }
+        list_c *programs = (NULL == single)? NULL : dynamic_cast<list_c *>(single->program_configuration_list);
+        if (NULL == programs) ERROR;
+        counters.push_back(resource_name);
+        for (int j = 0; j < programs->n; j++) {
+          program_configuration_c *program = dynamic_cast<program_configuration_c *>(programs->get_element(j));
+          token_c *program_name = (NULL == program)? NULL : dynamic_cast<token_c *>(program->program_name);
+          if (NULL == program_name) ERROR;
+          counters.push_back(resource_name + "__" + upper(program_name->value));
+        }
+      }
+
+      s4o.print("\n/* the cycle time counters (see iec_profile.h) */\n");
+      for (unsigned int i = 0; i < counters.size(); i++)
+        s4o.print("__DECLARE_EXTERN_PROFILE(" + counters[i] + ")\n");
+      s4o.print("__IEC_PROFILE_t *const __iec_profile_table[] = {\n");
+      for (unsigned int i = 0; i < profiled_pous.size(); i++)
+        s4o.print("  &" + profiled_pous[i] + "__profile,\n");
+      for (unsigned int i = 0; i < counters.size(); i++)
+        s4o.print("  &" + counters[i] + "__profile,\n");
+      s4o.print("  NULL};\n");
+    }
+
+  public:
 
 
 
@@ -2523,19 +3463,27 @@ class generate_c_c: public iterator_visitor_c {
     void *visit(library_c *symbol) {
       pous_incl_s4o.print("#ifndef __POUS_H\n#define __POUS_H\n\n");
       
-      if (runtime_options.disable_implicit_en_eno) {
-        // If we are not generating the EN and ENO parameters for functions and FB,
-        //   then make sure we use the standard library version compiled without these parameters too!
-        pous_incl_s4o.print("#ifndef DISABLE_EN_ENO_PARAMETERS\n");
-        pous_incl_s4o.print("#define DISABLE_EN_ENO_PARAMETERS\n");
-        pous_incl_s4o.print("#endif\n");
-      }
+      print_stdlib_variant_defines(pous_incl_s4o);
       
       pous_incl_s4o.print("#include \"accessor.h\"\n#include \"iec_std_lib.h\"\n\n");
+      if (generate_pou_profile__)
+        pous_incl_s4o.print("#include \"iec_profile.h\"\n\n");
+
+      /* the entries of the index are printed along with the configuration and resources */
+      if (generate_debug_index__)
+        debug_index = new generate_debug_index_c(symbol);
 
       for(int i = 0; i < symbol->n; i++) {
-        symbol->get_element(i)->accept(*this);
+        symbol_c *element = symbol->get_element(i);
+        /* The POU file pairs are generated in parallel, but only until the next library element that is not
+         * a POU (or a pragma), so all library elements are handled in the same order as the serial code generation.
+         */
+        if (!is_pou(element) && !is_code_generation_pragma(element))
+          run_pou_filepairs();
+        element->accept(*this);
       }
+      run_pou_filepairs();
+      if (NULL != manifest) manifest->save();
 
       pous_incl_s4o.print("#endif //__POUS_H\n");
       
@@ -2546,6 +3494,12 @@ class generate_c_c: public iterator_visitor_c {
       variables_s4o.print_long_long_integer(common_ticktime, false);
       variables_s4o.print("\n");
 
+      if (NULL != debug_index) {
+        debug_index->print_index(current_builddir);
+        delete debug_index;
+        debug_index = NULL;
+      }
+
       generate_location_list_c generate_location_list(&located_variables_s4o);
       symbol->accept(generate_location_list);
       return NULL;
@@ -2581,35 +3535,77 @@ class generate_c_c: public iterator_visitor_c {
 /**************************************/
 /* B.1.5 - Program organization units */
 /**************************************/
-/* WARNING: The following code is buggy when generating an independent pair of files for each POU, as the
- *          specially created stage4out_c (s4o_c and s4o_h) will not comply with the enable/disable_code_generation_pragma_c
- */
+  private:
+    static bool is_pou(symbol_c *element) {
+      return (   (NULL != dynamic_cast<function_declaration_c       *>(element))
+              || (NULL != dynamic_cast<function_block_declaration_c *>(element))
+              || (NULL != dynamic_cast<program_declaration_c        *>(element)));
+    }
+
+    static bool is_code_generation_pragma(symbol_c *element) {
+      return (   (NULL != dynamic_cast< enable_code_generation_pragma_c *>(element))
+              || (NULL != dynamic_cast<disable_code_generation_pragma_c *>(element)));
+    }
+
+    /* Generate (using several threads, if so requested with -j) all the pending POU file pairs */
+    void run_pou_filepairs(void) {
+      thread_pool_c::run(pending_pou_filepairs, runtime_options.threads);
+      for (unsigned int i = 0; i < pending_pou_filepairs.size(); i++)
+        delete pending_pou_filepairs[i]; /* closes the files */
+      pending_pou_filepairs.clear();
+    }
+
+    template<class declaration_c>
+    void add_pou_filepair(declaration_c *symbol, const char *pou_name, void (*handle_pou)(declaration_c *, stage4out_c &, bool)) {
+      if (pending_pou_filepairs.size() >= MAX_PENDING_POU_FILEPAIRS)
+        run_pou_filepairs();
+      uint64_t fingerprint = 0;
+      if (NULL != manifest) {
+        fingerprint = manifest->fingerprint(symbol);
+        manifest->set(pou_name, fingerprint);
+      }
+      if ((NULL != manifest) && manifest->is_unchanged(pou_name, fingerprint)) {
+        /* The files generated by a previous run are kept. They are still listed, as they are part of the generated code. */
+        printf("%s.c\n%s.h\n", pou_name, pou_name);
+        /* generate_c_implicit_typedecl_c also annotates the AST, so it is run anyway (without any output) */
+        stage4out_c null_s4o;
+        null_s4o.disable_output();
+        generate_c_implicit_typedecl_c generate_c_implicit_typedecl(&null_s4o);
+        symbol->accept(generate_c_implicit_typedecl);
+      } else {
+        pending_pou_filepairs.push_back(new generate_c_pou_filepair_c<declaration_c>(current_builddir, pou_name, symbol, handle_pou));
+      }
+      /* add #include directives to the POUS.h and POUS.c files... */
+      pous_incl_s4o.print("#include \"");
+      pous_s4o.     print("#include \"");
+      pous_incl_s4o.print(pou_name);
+      pous_s4o.     print(pou_name);
+      pous_incl_s4o.print(".h\"\n");
+      pous_s4o.     print(".c\"\n");
+    }
+
+    /* The enable/disable code generation pragmas take effect in the order in which they appear in the source code,
+     * even when they are inside a POU: a POU is only generated if code generation is enabled at its start,
+     * and any such pragma inside the POU remains in effect for the library elements that follow it.
+     * Since the code of each POU is generated to its own stage4out_c when using file pairs (-O p), the
+     * last of these pragmas inside the POU is applied here to all the other outputs.
+     */
+    void apply_code_generation_pragmas_in(symbol_c *symbol) {
+      symbol_c *last_pragma = search_code_generation_pragma_c::last_pragma_in(symbol);
+      if (NULL != last_pragma) last_pragma->accept(*this);
+    }
+
+  public:
 #define handle_pou(fname,pname) \
-      if (!allow_output) return NULL;\
+      if (!allow_output) {apply_code_generation_pragmas_in(symbol); return NULL;}\
       if (generate_pou_filepairs__) {\
-        const char *pou_name = get_datatype_info_c::get_id_str(pname);\
-        stage4out_c s4o_c(current_builddir, pou_name, "c");\
-        stage4out_c s4o_h(current_builddir, pou_name, "h");\
-        s4o_c.print("#include \""); s4o_c.print(pou_name); s4o_c.print(".h\"\n");\
-        s4o_h.print("#ifndef __");  s4o_h.print(pou_name); s4o_h.print("_H\n");\
-        s4o_h.print("#define __");  s4o_h.print(pou_name); s4o_h.print("_H\n");\
-        generate_c_implicit_typedecl_c generate_c_implicit_typedecl__(&s4o_h);\
-        symbol->accept(generate_c_implicit_typedecl__); /* generate implicitly delcared datatypes (arrays and ref_to) */\
-        generate_c_pous_c::fname(symbol, s4o_h, true); /* generate the <pou_name>.h file */\
-        generate_c_pous_c::fname(symbol, s4o_c, false);/* generate the <pou_name>.c file */\
-        s4o_h.print("#endif /* __");  s4o_h.print(pou_name); s4o_h.print("_H */\n");\
-        /* add #include directives to the POUS.h and POUS.c files... */\
-        pous_incl_s4o.print("#include \"");\
-        pous_s4o.     print("#include \"");\
-        pous_incl_s4o.print(pou_name);\
-        pous_s4o.     print(pou_name);\
-        pous_incl_s4o.print(".h\"\n");\
-        pous_s4o.     print(".c\"\n");\
+        add_pou_filepair(symbol, get_datatype_info_c::get_id_str(pname), generate_c_pous_c::fname);\
       } else {\
         symbol->accept(generate_c_implicit_typedecl);\
         generate_c_pous_c::fname(symbol, pous_incl_s4o, true);\
         generate_c_pous_c::fname(symbol, pous_s4o,      false);\
-      }
+      }\
+      apply_code_generation_pragmas_in(symbol);
 
 /***********************/
 /* B 1.5.1 - Functions */
@@ -2624,6 +3620,7 @@ class generate_c_c: public iterator_visitor_c {
 /*****************************/
     void *visit(function_block_declaration_c *symbol) {
       handle_pou(handle_function_block,symbol->fblock_name)
+      profiled_pous.push_back(upper(get_datatype_info_c::get_id_str(symbol->fblock_name)));
       return NULL;
     }
     
@@ -2632,6 +3629,7 @@ class generate_c_c: public iterator_visitor_c {
 /**********************/    
     void *visit(program_declaration_c *symbol) {
       handle_pou(handle_program,symbol->program_type_name)
+      profiled_pous.push_back(upper(get_datatype_info_c::get_id_str(symbol->program_type_name)));
       return NULL;
     }
     
@@ -2665,7 +3663,7 @@ class generate_c_c: public iterator_visitor_c {
         
         stage4out_c config_s4o(current_builddir, current_name, "c");
         stage4out_c config_incl_s4o(current_builddir, current_name, "h");
-        generate_c_config_c generate_c_config(&config_s4o, &config_incl_s4o);
+        generate_c_config_c generate_c_config(&config_s4o, &config_incl_s4o, common_ticktime);
         symbol->accept(generate_c_config);
 
         config_s4o.print("unsigned long long common_ticktime__ = ");
@@ -2679,8 +3677,19 @@ class generate_c_c: public iterator_visitor_c {
           generate_c_backup_config_c generate_backup = generate_c_backup_config_c(&config_s4o);
           symbol->accept(generate_backup);
         }
+
+        if (generate_resource_threads__)
+          print_exchange_globals_functions(config_s4o, "config", symbol->configuration_name, symbol);
+
+        if (NULL != debug_index)
+          debug_index->print_entries(config_s4o, upper(current_name));
+
+        if (generate_pou_profile__)
+          print_profile_table(config_s4o, symbol);
       }
 
+      first_unit = 0;
+      first_resource = true;
       symbol->resource_declarations->accept(*this);
 
       current_configuration = NULL;
@@ -2693,18 +3702,39 @@ class generate_c_c: public iterator_visitor_c {
       symbol->resource_name->accept(*this);
       stage4out_c resources_s4o(current_builddir, current_name, "c");
       generate_c_resources_c generate_c_resources(&resources_s4o, current_configuration, symbol, common_ticktime);
+      resource_units_c units(symbol, common_ticktime);
+      if (generate_resource_threads__)
+        generate_c_resources.set_units(&units, first_unit);
+      generate_c_resources.set_include_pous(first_resource);
+      first_resource = false;
       symbol->accept(generate_c_resources);
       if (generate_plc_state_backup_fuctions__ > 0) {
         generate_c_backup_resource_c generate_backup = generate_c_backup_resource_c(&resources_s4o);
         symbol->accept(generate_backup);
       }
+      if (generate_resource_threads__)
+        print_exchange_globals_functions(resources_s4o, upper(current_name).c_str(), symbol->resource_name, symbol->global_var_declarations);
+      if (NULL != debug_index)
+        debug_index->print_entries(resources_s4o, upper(current_name));
+      first_unit += units.count();
       return NULL;
     }
 
     void *visit(single_resource_declaration_c *symbol) {
       stage4out_c resources_s4o(current_builddir, "RESOURCE", "c");
       generate_c_resources_c generate_c_resources(&resources_s4o, current_configuration, symbol, common_ticktime);
+      resource_units_c units(symbol, common_ticktime);
+      if (generate_resource_threads__)
+        generate_c_resources.set_units(&units, first_unit);
+      generate_c_resources.set_include_pous(first_resource);
+      first_resource = false;
       symbol->accept(generate_c_resources);
+      /* a single resource has no global variables of its own */
+      if (generate_resource_threads__)
+        print_exchange_globals_functions(resources_s4o, "RESOURCE", NULL, NULL);
+      if (NULL != debug_index)
+        debug_index->print_entries(resources_s4o, "RESOURCE");
+      first_unit += units.count();
       return NULL;
     }
     
@@ -481,6 +481,8 @@ class generate_c_base_c: public iterator_visitor_c {
       } /* for() */
 
       str += '"';
+      if (generate_string_max_len__ && (count > (unsigned int)generate_string_max_len__))
+        STAGE4_ERROR(symbol, symbol, "STRING literal longer than the maximum STRING length (-O s=%d).", generate_string_max_len__);
       s4o.print("__STRING_LITERAL(");
       s4o.print(count); 
       s4o.print(",");
@@ -710,8 +712,8 @@ void *visit(symbolic_variable_c *symbol) {
 // a non-standard extension!!
 void *visit(symbolic_constant_c *symbol) {
   TRACE("symbolic_variable_c");
-  if      (symbol->const_value. _int64.is_valid()) s4o.print(symbol->const_value. _int64.get());
-  else if (symbol->const_value._uint64.is_valid()) s4o.print(symbol->const_value._uint64.get());
+  if      (symbol->const_value-> _int64.is_valid()) s4o.print(symbol->const_value-> _int64.get());
+  else if (symbol->const_value->_uint64.is_valid()) s4o.print(symbol->const_value->_uint64.get());
   else ERROR;
   return NULL;
 }
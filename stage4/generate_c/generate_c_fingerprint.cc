@@ -0,0 +1,310 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Incremental code generation (-O i).
+ *
+ * The fingerprint of a POU is a hash of its (normalized) abstract syntax tree, i.e. of the
+ * class and token values of every node, but not of the comments, spacing or location in the
+ * source code (unless '#line' directives are being generated). It also includes the signature of
+ * every data type and POU the POU depends on: these are found by looking up each identifier in
+ * the global symbol tables, and by following the data type annotations set in stage 3. The signature
+ * of a data type is the fingerprint of its whole declaration, while the signature of a POU
+ * only covers its name and variable declarations (i.e. not its body).
+ *
+ * When generating a pair of files for each POU (-O p), the fingerprints of all the POUs are stored in
+ * a manifest file (POUS.manifest) in the build directory. On the next run, the files of a POU whose
+ * fingerprint did not change are not generated again. The manifest also stores a fingerprint of the
+ * compiler build and of the command line options, which must match for the manifest to be used.
+ */
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <inttypes.h>  /* required for PRIx64 and SCNx64 */
+#include <unistd.h>    /* required for access() */
+#include "../../config/config.h"
+
+
+#define POU_MANIFEST_FILENAME "POUS.manifest"
+
+
+
+class generate_c_manifest_c {
+  private:
+    std::string builddir;
+    uint64_t    options;       /* fingerprint of the compiler build and of the options */
+    bool        old_is_valid;  /* the manifest left by the previous run used the same build and options */
+    std::map<std::string, uint64_t> old_fingerprints, new_fingerprints;
+    /* signatures of the declarations already hashed (0 while still being hashed) */
+    std::map<symbol_c *, uint64_t> signatures;
+
+  public:
+    /* 64 bit FNV-1a */
+    static uint64_t hash_bytes(uint64_t hash, const void *data, size_t len) {
+      const unsigned char *p = (const unsigned char *)data;
+      for (size_t i = 0; i < len; i++) {hash ^= p[i]; hash *= 0x100000001b3ULL;}
+      return hash;
+    }
+    static uint64_t hash_str (uint64_t hash, const char *str) {return hash_bytes(hash, str, strlen(str) + 1);}
+    static uint64_t hash_int (uint64_t hash, int64_t value)   {return hash_bytes(hash, &value, sizeof(value));}
+    static const uint64_t hash_init = 0xcbf29ce484222325ULL;
+
+  public:
+    generate_c_manifest_c(const char *builddir_, uint64_t options_) {
+      builddir = (NULL == builddir_)? "" : std::string(builddir_) + "/";
+      options  = options_;
+      old_is_valid = false;
+
+      FILE *f = fopen((builddir + POU_MANIFEST_FILENAME).c_str(), "r");
+      if (NULL == f) return;
+      uint64_t old_options, fingerprint;
+      char     name[1024];
+      if ((fscanf(f, "options %" SCNx64 "\n", &old_options) == 1) && (old_options == options)) {
+        old_is_valid = true;
+        while (fscanf(f, "%1023s %" SCNx64 "\n", name, &fingerprint) == 2)
+          old_fingerprints[name] = fingerprint;
+      }
+      fclose(f);
+      /* A run that does not complete (e.g. a compilation error) must not leave a manifest that
+       * no longer matches the generated files.
+       */
+      unlink((builddir + POU_MANIFEST_FILENAME).c_str());
+    }
+
+    /* The compiler build, and all the options that change the generated code */
+    static uint64_t options_fingerprint(void) {
+      uint64_t hash = hash_init;
+      hash = hash_str(hash, PACKAGE_VERSION);
+      hash = hash_str(hash, __DATE__ " " __TIME__);   /* the build of this compiler */
+      hash = hash_int(hash, runtime_options.allow_void_datatype);
+      hash = hash_int(hash, runtime_options.allow_missing_var_in);
+      hash = hash_int(hash, runtime_options.disable_implicit_en_eno);
+      hash = hash_int(hash, runtime_options.safe_extensions);
+      hash = hash_int(hash, runtime_options.conversion_functions);
+      hash = hash_int(hash, runtime_options.ref_standard_extensions);
+      hash = hash_int(hash, runtime_options.ref_nonstand_extensions);
+      hash = hash_int(hash, runtime_options.nonliteral_in_array_size);
+      hash = hash_int(hash, runtime_options.relaxed_datatype_model);
+      hash = hash_int(hash, generate_line_directives__);
+      hash = hash_int(hash, generate_plc_state_backup_fuctions__);
+      hash = hash_int(hash, generate_time_int64__);
+      hash = hash_int(hash, generate_production_accessors__);
+      hash = hash_int(hash, generate_resource_threads__);
+      hash = hash_int(hash, generate_string_max_len__);
+      hash = hash_int(hash, generate_retain_segment__);
+      hash = hash_int(hash, generate_debug_index__);
+      hash = hash_int(hash, generate_pou_profile__);
+      return hash;
+    }
+
+    /* The files of the POU (pou_name.c and pou_name.h) were generated by a previous run, from the same source code */
+    bool is_unchanged(const char *pou_name, uint64_t fingerprint) {
+      if (!old_is_valid) return false;
+      std::map<std::string, uint64_t>::iterator iter = old_fingerprints.find(pou_name);
+      if ((iter == old_fingerprints.end()) || (iter->second != fingerprint)) return false;
+      return    (access((builddir + pou_name + ".c").c_str(), F_OK) == 0)
+             && (access((builddir + pou_name + ".h").c_str(), F_OK) == 0);
+    }
+
+    void set(const char *pou_name, uint64_t fingerprint) {new_fingerprints[pou_name] = fingerprint;}
+
+    void save(void) {
+      FILE *f = fopen((builddir + POU_MANIFEST_FILENAME).c_str(), "w");
+      if (NULL == f) {
+        fprintf(stderr, "Cannot open %s for write access \n", POU_MANIFEST_FILENAME);
+        exit(EXIT_FAILURE);
+      }
+      fprintf(f, "options %016" PRIx64 "\n", options);
+      std::map<std::string, uint64_t>::iterator iter;
+      for (iter = new_fingerprints.begin(); iter != new_fingerprints.end(); iter++)
+        fprintf(f, "%s %016" PRIx64 "\n", iter->first.c_str(), iter->second);
+      fclose(f);
+    }
+
+    uint64_t fingerprint(symbol_c *pou);
+    uint64_t signature  (symbol_c *declaration);
+};
+
+
+
+/* Hash every node in the AST, along with the signatures of all the declarations it references */
+class generate_c_fingerprint_c: public iterator_visitor_c {
+  private:
+    generate_c_manifest_c *manifest;
+    uint64_t               hash;
+
+  public:
+    generate_c_fingerprint_c(generate_c_manifest_c *manifest_) {manifest = manifest_; hash = generate_c_manifest_c::hash_init;}
+    uint64_t get_hash(void) {return hash;}
+
+    void add(symbol_c *symbol) {
+      if (NULL == symbol) {hash = generate_c_manifest_c::hash_int(hash, 0); return;}
+      symbol->accept(*this);
+    }
+
+  private:
+    void add_dependency(symbol_c *declaration) {
+      if (NULL != declaration) hash = generate_c_manifest_c::hash_int(hash, manifest->signature(declaration));
+    }
+
+    void handle_symbol(symbol_c *symbol) {
+      hash = generate_c_manifest_c::hash_str(hash, symbol->absyntax_cname());
+      if (generate_line_directives__) {
+        hash = generate_c_manifest_c::hash_str(hash, (NULL == symbol->first_file)? "" : symbol->first_file);
+        hash = generate_c_manifest_c::hash_int(hash, symbol->first_line);
+      }
+      add_dependency(symbol->datatype);
+      /* The values found by the constant folding in stage 3, which may come from outside the POU
+       * (e.g. the value of a VAR_GLOBAL CONSTANT of the configuration, copied to the VAR_EXTERNAL),
+       * and which stage 4 prints instead of the symbol (e.g. symbolic_constant_c).
+       */
+      if (symbol->const_value.is_allocated()) {
+        const_value_c &cvalue = symbol->const_value;
+        if (cvalue._int64.is_valid()) {
+          int64_t  value = cvalue._int64.get();
+          hash = generate_c_manifest_c::hash_int  (hash, 'i');
+          hash = generate_c_manifest_c::hash_bytes(hash, &value, sizeof(value));
+        }
+        if (cvalue._uint64.is_valid()) {
+          uint64_t value = cvalue._uint64.get();
+          hash = generate_c_manifest_c::hash_int  (hash, 'u');
+          hash = generate_c_manifest_c::hash_bytes(hash, &value, sizeof(value));
+        }
+        if (cvalue._real64.is_valid()) {
+          real64_t value = cvalue._real64.get();
+          hash = generate_c_manifest_c::hash_int  (hash, 'r');
+          hash = generate_c_manifest_c::hash_bytes(hash, &value, sizeof(value));
+        }
+        if (cvalue._bool.is_valid()) {
+          hash = generate_c_manifest_c::hash_int  (hash, 'b');
+          hash = generate_c_manifest_c::hash_int  (hash, cvalue._bool.get());
+        }
+      }
+    }
+
+    void handle_token(token_c *symbol) {
+      handle_symbol(symbol);
+      hash = generate_c_manifest_c::hash_str(hash, symbol->value);
+      /* any global declaration with the same name */
+      function_symtable_t::iterator lower = function_symtable.lower_bound(symbol->value);
+      function_symtable_t::iterator upper = function_symtable.upper_bound(symbol->value);
+      for (; lower != upper; lower++)
+        add_dependency(function_symtable.get_value(lower));
+      function_block_type_symtable_t::iterator fb_iter = function_block_type_symtable.find(symbol->value);
+      if (fb_iter != function_block_type_symtable.end()) add_dependency(fb_iter->second);
+      program_type_symtable_t::iterator prg_iter = program_type_symtable.find(symbol->value);
+      if (prg_iter != program_type_symtable.end()) add_dependency(prg_iter->second);
+      type_symtable_t::iterator type_iter = type_symtable.find(symbol->value);
+      if (type_iter != type_symtable.end()) add_dependency(type_iter->second);
+    }
+
+    /* mark the end of the children of a node, so distinct trees with the same nodes do not get the same hash */
+    void end_symbol(void) {hash = generate_c_manifest_c::hash_int(hash, -1);}
+
+  public:
+#define SYM_LIST(class_name_c, ...)                                             \
+    void *visit(class_name_c *symbol) {                                         \
+      handle_symbol(symbol);                                                    \
+      hash = generate_c_manifest_c::hash_int(hash, symbol->n);                  \
+      iterator_visitor_c::visit(symbol);                                        \
+      end_symbol();                                                             \
+      return NULL;                                                              \
+    }
+#define SYM_TOKEN(class_name_c, ...)                                            \
+    void *visit(class_name_c *symbol) {handle_token(symbol); return NULL;}
+#define SYM_REF_(class_name_c)                                                  \
+    void *visit(class_name_c *symbol) {                                         \
+      handle_symbol(symbol);                                                    \
+      iterator_visitor_c::visit(symbol);                                        \
+      end_symbol();                                                             \
+      return NULL;                                                              \
+    }
+#define SYM_REF0(class_name_c, ...)                                             SYM_REF_(class_name_c)
+#define SYM_REF1(class_name_c, ref1, ...)                                       SYM_REF_(class_name_c)
+#define SYM_REF2(class_name_c, ref1, ref2, ...)                                 SYM_REF_(class_name_c)
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                           SYM_REF_(class_name_c)
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)                     SYM_REF_(class_name_c)
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)               SYM_REF_(class_name_c)
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)         SYM_REF_(class_name_c)
+
+#include "../../absyntax/absyntax.def"
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF_
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+};
+
+
+
+uint64_t generate_c_manifest_c::fingerprint(symbol_c *pou) {
+  generate_c_fingerprint_c fingerprint(this);
+  fingerprint.add(pou);
+  return fingerprint.get_hash();
+}
+
+
+uint64_t generate_c_manifest_c::signature(symbol_c *declaration) {
+  std::map<symbol_c *, uint64_t>::iterator iter = signatures.find(declaration);
+  if (iter != signatures.end()) return iter->second;  /* NOTE: 0 for a (recursive) declaration still being hashed */
+  signatures[declaration] = 0;
+
+  generate_c_fingerprint_c fingerprint(this);
+  function_declaration_c       *f_decl   = dynamic_cast<function_declaration_c       *>(declaration);
+  function_block_declaration_c *fb_decl  = dynamic_cast<function_block_declaration_c *>(declaration);
+  program_declaration_c        *prg_decl = dynamic_cast<program_declaration_c        *>(declaration);
+  if        (NULL != f_decl) {
+    fingerprint.add(f_decl->derived_function_name);
+    fingerprint.add(f_decl->type_name);
+    fingerprint.add(f_decl->var_declarations_list);
+  } else if (NULL != fb_decl) {
+    fingerprint.add(fb_decl->fblock_name);
+    fingerprint.add(fb_decl->var_declarations);
+  } else if (NULL != prg_decl) {
+    fingerprint.add(prg_decl->program_type_name);
+    fingerprint.add(prg_decl->var_declarations);
+  } else {
+    fingerprint.add(declaration);
+  }
+
+  uint64_t res = fingerprint.get_hash();
+  if (0 == res) res = 1;
+  signatures[declaration] = res;
+  return res;
+}
@@ -651,11 +651,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
            * parameter name so we can go looking for the value passed to the correct
            * extended parameter (e.g. IN1, IN2, IN3, IN4, ...)
            */
-          char *tmp = (char *)malloc(32); /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
+          char tmp[32]; /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
           int res = snprintf(tmp, 32, "%d", fp_iterator.extensible_param_index());
           if ((res >= 32) || (res < 0)) ERROR;
-          param_name = new identifier_c(strdup2(param_name->value, tmp));
-          if (param_name->value == NULL) ERROR;
+          char *name = strdup2(param_name->value, tmp);
+          if (name == NULL) ERROR;
+          param_name = new identifier_c(name); /* identifier_c keeps its own (interned) copy of name */
+          free(name);
         }
     
         symbol_c *param_type = fp_iterator.param_type();
@@ -825,11 +827,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
            * parameter name so we can go looking for the value passed to the correct
            * extended parameter (e.g. IN1, IN2, IN3, IN4, ...)
            */
-          char *tmp = (char *)malloc(32); /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
+          char tmp[32]; /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
           int res = snprintf(tmp, 32, "%d", fp_iterator.extensible_param_index());
           if ((res >= 32) || (res < 0)) ERROR;
-          param_name = new identifier_c(strdup2(param_name->value, tmp));
-          if (param_name->value == NULL) ERROR;
+          char *name = strdup2(param_name->value, tmp);
+          if (name == NULL) ERROR;
+          param_name = new identifier_c(name); /* identifier_c keeps its own (interned) copy of name */
+          free(name);
         }
         
         symbol_c *param_type = fp_iterator.param_type();
@@ -41,6 +41,7 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       transitionlist_sg,
       transitiontest_sg,
       transitiontestdebug_sg,
+      transitionenable_sg,
       stepset_sg,
       stepreset_sg,
       actionassociation_sg,
@@ -89,15 +90,32 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
 
     void reset_transition_number(void) {transition_number = 0;}
 
+    int transition_count(void) {return transition_list.size();}
+
     void generate(symbol_c *symbol, sfcgeneration_t generation_type) {
       wanted_sfcgeneration = generation_type;
       switch (wanted_sfcgeneration) {
         case transitiontest_sg:
+        case stepreset_sg:
+        case stepset_sg:
           {
+            /* The transitions are tested, and fired, from within a switch on their position
+             * in the (priority sorted) transition list, see generate_c_sfc_c.
+             */
             std::list<TRANSITION>::iterator pt;
-            for(pt = transition_list.begin(); pt != transition_list.end(); pt++) {
+            int position = 0;
+            for(pt = transition_list.begin(); pt != transition_list.end(); pt++, position++) {
+              if ((wanted_sfcgeneration == stepreset_sg) && (pt->symbol->integer != NULL))
+                continue;
+              s4o.print(s4o.indent_spaces + "case ");
+              s4o.print(position);
+              s4o.print(": {\n");
+              s4o.indent_right();
               transition_number = pt->index;
               pt->symbol->accept(*this);
+              s4o.print(s4o.indent_spaces + "break;\n");
+              s4o.indent_left();
+              s4o.print(s4o.indent_spaces + "}\n");
             }
           }
           break;
@@ -144,7 +162,89 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       print_step_argument(step_name, "X", true);
       s4o.print(",,1);\n" + s4o.indent_spaces);
       print_step_argument(step_name, "T.value");
-      s4o.print(" = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      s4o.print(" = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
+      s4o.print("__sfc_list_insert(");
+      print_variable_prefix();
+      s4o.print("__active_step_list, &");
+      print_variable_prefix();
+      s4o.print("__nb_active_steps, ");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      step_name->accept(*this);
+      s4o.print(");\n");
+    }
+
+    /* Any action with a non zero state, set, reset or remaining time must be in the list of active actions */
+    void print_active_action_insert(symbol_c *action_name) {
+      s4o.print("__sfc_list_insert(");
+      print_variable_prefix();
+      s4o.print("__active_action_list, &");
+      print_variable_prefix();
+      s4o.print("__nb_active_actions, ");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      action_name->accept(*this);
+      s4o.print(");");
+    }
+
+    /* The action associations of a step, executed only while the step is in the list of active steps */
+    void print_step_associations(symbol_c *step_name, symbol_c *action_association_list) {
+      if (((list_c*)action_association_list)->n == 0)
+        return;
+      s4o.print(s4o.indent_spaces + "// ");
+      step_name->accept(*this);
+      s4o.print(" action associations\n");
+      current_step = step_name;
+      s4o.print(s4o.indent_spaces + "case ");
+      s4o.print(SFC_STEP_ACTION_PREFIX);
+      step_name->accept(*this);
+      s4o.print(": {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "char active = ");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_step_argument(current_step, "X");
+      s4o.print(");\n");
+      s4o.print(s4o.indent_spaces + "char activated = active && !");
+      print_step_argument(current_step, "prev_state");
+      s4o.print(";\n");
+      s4o.print(s4o.indent_spaces + "char desactivated = !active && ");
+      print_step_argument(current_step, "prev_state");
+      s4o.print(";\n\n");
+      action_association_list->accept(*this);
+      s4o.print(s4o.indent_spaces + "break;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n\n");
+    }
+
+    /* The transitions that may fire when the step is active, i.e. those leaving the step (or, when leaving
+     * several simultaneous steps, whose first preceding step is this one).
+     */
+    void print_step_transitions(symbol_c *step_name) {
+      std::list<TRANSITION>::iterator pt;
+      int position = 0;
+      bool first = true;
+      for(pt = transition_list.begin(); pt != transition_list.end(); pt++, position++) {
+        steps_c *from_steps = (steps_c *)pt->symbol->from_steps;
+        symbol_c *from_step = from_steps->step_name;
+        if (from_step == NULL)
+          from_step = ((list_c *)from_steps->step_name_list)->get_element(0);
+        if (compare_identifiers(from_step, step_name) != 0)
+          continue;
+        if (first) {
+          s4o.print(s4o.indent_spaces + "case ");
+          s4o.print(SFC_STEP_ACTION_PREFIX);
+          step_name->accept(*this);
+          s4o.print(":\n");
+          s4o.indent_right();
+          first = false;
+        }
+        s4o.print(s4o.indent_spaces + "__sfc_list_insert(enabled_transitions, &nb, ");
+        s4o.print(position);
+        s4o.print(");\n");
+      }
+      if (!first) {
+        s4o.print(s4o.indent_spaces + "break;\n");
+        s4o.indent_left();
+      }
     }
     
 /*********************************************/
@@ -154,28 +254,10 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
     void *visit(initial_step_c *symbol) {
       switch (wanted_sfcgeneration) {
         case actionassociation_sg:
-          if (((list_c*)symbol->action_association_list)->n > 0) {
-            s4o.print(s4o.indent_spaces + "// ");
-            symbol->step_name->accept(*this);
-            s4o.print(" action associations\n");
-            current_step = symbol->step_name;
-            s4o.print(s4o.indent_spaces + "{\n");
-            s4o.indent_right();
-            s4o.print(s4o.indent_spaces + "char active = ");
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_step_argument(current_step, "X");
-            s4o.print(");\n");
-            s4o.print(s4o.indent_spaces + "char activated = active && !");
-            print_step_argument(current_step, "prev_state");
-            s4o.print(";\n");
-            s4o.print(s4o.indent_spaces + "char desactivated = !active && ");
-            print_step_argument(current_step, "prev_state");
-            s4o.print(";\n\n");
-            symbol->action_association_list->accept(*this);
-            s4o.indent_left();
-            s4o.print(s4o.indent_spaces + "}\n\n");
-          }
+          print_step_associations(symbol->step_name, symbol->action_association_list);
+          break;
+        case transitionenable_sg:
+          print_step_transitions(symbol->step_name);
           break;
         default:
           break;
@@ -186,28 +268,10 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
     void *visit(step_c *symbol) {
       switch (wanted_sfcgeneration) {
         case actionassociation_sg:
-          if (((list_c*)symbol->action_association_list)->n > 0) {
-            s4o.print(s4o.indent_spaces + "// ");
-            symbol->step_name->accept(*this);
-            s4o.print(" action associations\n");
-            current_step = symbol->step_name;
-            s4o.print(s4o.indent_spaces + "{\n");
-            s4o.indent_right();
-            s4o.print(s4o.indent_spaces + "char active = ");
-            s4o.print(GET_VAR);
-            s4o.print("(");
-            print_step_argument(current_step, "X");
-            s4o.print(");\n");
-            s4o.print(s4o.indent_spaces + "char activated = active && !");
-            print_step_argument(current_step, "prev_state");
-            s4o.print(";\n");
-            s4o.print(s4o.indent_spaces + "char desactivated = !active && ");
-            print_step_argument(current_step, "prev_state");
-            s4o.print(";\n\n");
-            symbol->action_association_list->accept(*this);
-            s4o.indent_left();
-            s4o.print(s4o.indent_spaces + "}\n\n");
-          }
+          print_step_associations(symbol->step_name, symbol->action_association_list);
+          break;
+        case transitionenable_sg:
+          print_step_transitions(symbol->step_name);
           break;
         default:
           break;
@@ -390,6 +454,11 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
     void *visit(action_c *symbol) {
       switch (wanted_sfcgeneration) {
         case actionbody_sg:
+          s4o.print(s4o.indent_spaces + "case ");
+          s4o.print(SFC_STEP_ACTION_PREFIX);
+          symbol->action_name->accept(*this);
+          s4o.print(":\n");
+          s4o.indent_right();
           s4o.print(s4o.indent_spaces + "if(");
           s4o.print(GET_VAR);
           s4o.print("(");
@@ -404,7 +473,9 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
           symbol->function_block_body->accept(*generate_c_code);
           
           s4o.indent_left();
-          s4o.print(s4o.indent_spaces + "}\n\n");
+          s4o.print(s4o.indent_spaces + "}\n");
+          s4o.print(s4o.indent_spaces + "break;\n\n");
+          s4o.indent_left();
           break;
         default:
           break;
@@ -495,7 +566,9 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
             s4o.print(SET_VAR);
             s4o.print("(");
             print_action_argument(symbol->action_name, "state", true);
-            s4o.print(",,1);\n");
+            s4o.print(",,1);\n" + s4o.indent_spaces);
+            print_active_action_insert(symbol->action_name);
+            s4o.print("\n");
             s4o.indent_left();
             s4o.print(s4o.indent_spaces + "}");
           }
@@ -532,7 +605,10 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
       print_action_argument(action, "state", true);
       s4o.print(",,");
       s4o.print(value);
-      s4o.print(");}");
+      s4o.print(");");
+      if (strcmp(value, "0") != 0)
+        print_active_action_insert(action);
+      s4o.print("}");
     }
     
     void print_set_var_or_action_state(symbol_c *action, const char *value) {  
@@ -561,14 +637,18 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
             if (strcmp(qualifier, "S") == 0) {
               s4o.print(s4o.indent_spaces + "if (active)       {");
               print_action_argument(current_action, "set");
-              s4o.print(" = 1;}\n");
+              s4o.print(" = 1; ");
+              print_active_action_insert(current_action);
+              s4o.print("}\n");
               return NULL;
             }
             /* R qualifier */
             if (strcmp(qualifier, "R") == 0) {
               s4o.print(s4o.indent_spaces + "if (active)       {");
               print_action_argument(current_action, "reset");
-              s4o.print(" = 1;}\n");
+              s4o.print(" = 1; ");
+              print_active_action_insert(current_action);
+              s4o.print("}\n");
               return NULL;
             }
             /* L or D qualifiers */
@@ -619,7 +699,9 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
               print_action_argument(current_action, "reset_remaining_time");
               s4o.print(" = ");
               symbol->action_time->accept(*generate_c_st);
-              s4o.print(";\n");
+              s4o.print(";\n" + s4o.indent_spaces);
+              print_active_action_insert(current_action);
+              s4o.print("\n");
               s4o.indent_left();
               s4o.print(s4o.indent_spaces + "}\n");
               return NULL;
@@ -633,7 +715,9 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
               print_action_argument(current_action, "set_remaining_time");
               s4o.print(" = ");
               symbol->action_time->accept(*generate_c_st);
-              s4o.print(";\n");
+              s4o.print(";\n" + s4o.indent_spaces);
+              print_active_action_insert(current_action);
+              s4o.print("\n");
               s4o.indent_left();
               s4o.print(s4o.indent_spaces + "}\n");
               if (strcmp(qualifier, "DS") == 0) {
@@ -676,6 +760,7 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
   
   private:
     std::list<VARIABLE> variable_list;
+    std::list<symbol_c *> sticky_step_list;
 
     generate_c_sfc_elements_c *generate_c_sfc_elements;
     search_var_instance_decl_c *search_var_instance_decl;
@@ -690,6 +775,7 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
   
     virtual ~generate_c_sfc_c(void) {
       variable_list.clear();
+      sticky_step_list.clear();
       delete generate_c_sfc_elements;
       delete search_var_instance_decl;
     }
@@ -701,10 +787,51 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
       return var_decl != NULL;
     }
 
+    /* Prints the start of a loop over the indexes in one of the lists of active steps or actions
+     * (e.g. "__active_step_list"), with a switch on the index.
+     */
+    void print_active_list_switch_begin(const char *list, const char *count) {
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      print_variable_prefix();
+      s4o.print(count);
+      s4o.print("; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "switch (");
+      print_variable_prefix();
+      s4o.print(list);
+      s4o.print("[i]) {\n");
+      s4o.indent_right();
+    }
+
+    void print_switch_end(void) {
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+    }
+
+    /* Prints a loop over the transitions enabled in the current cycle, with a switch on their position */
+    void print_enabled_transitions_switch(sequential_function_chart_c *symbol, generate_c_sfc_elements_c::sfcgeneration_t generation_type) {
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < nb; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "switch (enabled_transitions[i]) {\n");
+      s4o.indent_right();
+      generate_c_sfc_elements->generate((symbol_c *)symbol, generation_type);
+      print_switch_end();
+    }
+
 /*********************************************/
 /* B.1.6  Sequential function chart elements */
 /*********************************************/
     
+    /* NOTE: The generated code keeps the (sorted) list of the active steps, i.e. the steps that are active,
+     *       were deactivated in the current cycle, or have P, P1 or P0 action associations, and the list of
+     *       the actions that have something to do (a non zero state, set, reset, or remaining time).
+     *       Only the steps and actions in these lists are visited on each cycle, and only the transitions
+     *       leaving an active step are tested.
+     *       In debug mode all the steps, actions and transitions are visited (and the lists are rebuilt),
+     *       as the debugger may force any transition or change the state of any step.
+     */
     void *visit(sequential_function_chart_c *symbol) {
       int i;
       
@@ -714,7 +841,10 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
         generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::transitionlist_sg);
       }
       
-      s4o.print(s4o.indent_spaces +"INT i;\n");
+      s4o.print(s4o.indent_spaces +"UINT i, j, nb, nb_active;\n");
+      s4o.print(s4o.indent_spaces +"UINT enabled_transitions[");
+      s4o.print((generate_c_sfc_elements->transition_count() > 0)? generate_c_sfc_elements->transition_count() : 1);
+      s4o.print("];\n");
       s4o.print(s4o.indent_spaces +"TIME elapsed_time, current_time;\n\n");
       
       /* generate elapsed_time initializations */
@@ -747,71 +877,114 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
 
       /* generate step initializations */
       s4o.print(s4o.indent_spaces + "// Steps initialization\n");
-      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      s4o.print(s4o.indent_spaces + "nb = __DEBUG ? ");
+      print_variable_prefix();
+      s4o.print("__nb_steps : ");
       print_variable_prefix();
-      s4o.print("__nb_steps; i++) {\n");
+      s4o.print("__nb_active_steps;\n");
+      s4o.print(s4o.indent_spaces + "nb_active = 0;\n");
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < nb; i++) {\n");
       s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "j = __DEBUG ? i : ");
+      print_variable_prefix();
+      s4o.print("__active_step_list[i];\n");
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__step_list[i].prev_state = ");
+      s4o.print("__step_list[j].prev_state = ");
       s4o.print(GET_VAR);
       s4o.print("(");
       print_variable_prefix();
-      s4o.print("__step_list[i].X);\n");
+      s4o.print("__step_list[j].X);\n");
       s4o.print(s4o.indent_spaces + "if (");
       s4o.print(GET_VAR);
       s4o.print("(");
       print_variable_prefix();
-      s4o.print("__step_list[i].X)) {\n");
+      s4o.print("__step_list[j].X)) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__step_list[i].T.value = __time_add(");
+      s4o.print("__step_list[j].T.value = __time_add(");
       print_variable_prefix();
-      s4o.print("__step_list[i].T.value, elapsed_time);\n");
+      s4o.print("__step_list[j].T.value, elapsed_time);\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces + "else {\n");
+      s4o.indent_right();
+      if (sticky_step_list.empty())
+        s4o.print(s4o.indent_spaces + "continue;\n");
+      else {
+        /* inactive steps with P, P1 or P0 action associations stay in the list */
+        s4o.print(s4o.indent_spaces + "switch (j) {\n");
+        s4o.indent_right();
+        std::list<symbol_c *>::iterator pt;
+        for(pt = sticky_step_list.begin(); pt != sticky_step_list.end(); pt++) {
+          s4o.print(s4o.indent_spaces + "case ");
+          s4o.print(SFC_STEP_ACTION_PREFIX);
+          (*pt)->accept(*this);
+          s4o.print(":\n");
+        }
+        s4o.print(s4o.indent_spaces + "  break;\n");
+        s4o.print(s4o.indent_spaces + "default:\n");
+        s4o.print(s4o.indent_spaces + "  continue;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+      }
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__active_step_list[nb_active++] = j;\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__nb_active_steps = nb_active;\n");
 
       /* generate action initializations */
       s4o.print(s4o.indent_spaces + "// Actions initialization\n");
-      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      s4o.print(s4o.indent_spaces + "nb = __DEBUG ? ");
+      print_variable_prefix();
+      s4o.print("__nb_actions : ");
       print_variable_prefix();
-      s4o.print("__nb_actions; i++) {\n");
+      s4o.print("__nb_active_actions;\n");
+      s4o.print(s4o.indent_spaces + "nb_active = 0;\n");
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < nb; i++) {\n");
       s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "j = __DEBUG ? i : ");
+      print_variable_prefix();
+      s4o.print("__active_action_list[i];\n");
       s4o.print(s4o.indent_spaces);
       s4o.print(SET_VAR);
       s4o.print("(");
       print_variable_prefix();
-      s4o.print(",__action_list[i].state,,0);\n");
+      s4o.print(",__action_list[j].state,,0);\n");
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set = 0;\n");
+      s4o.print("__action_list[j].set = 0;\n");
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset = 0;\n");
+      s4o.print("__action_list[j].reset = 0;\n");
       s4o.print(s4o.indent_spaces + "if (");
       s4o.print("__time_cmp(");
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
+      s4o.print("__action_list[j].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time = __time_sub(");
+      s4o.print("__action_list[j].set_remaining_time = __time_sub(");
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, elapsed_time);\n");
+      s4o.print("__action_list[j].set_remaining_time, elapsed_time);\n");
       s4o.print(s4o.indent_spaces + "if (");
       s4o.print("__time_cmp(");
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
+      s4o.print("__action_list[j].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      s4o.print("__action_list[j].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set = 1;\n");
+      s4o.print("__action_list[j].set = 1;\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
       s4o.indent_left();
@@ -819,101 +992,164 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
       s4o.print(s4o.indent_spaces + "if (");
       s4o.print("__time_cmp(");
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
+      s4o.print("__action_list[j].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time = __time_sub(");
+      s4o.print("__action_list[j].reset_remaining_time = __time_sub(");
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, elapsed_time);\n");
+      s4o.print("__action_list[j].reset_remaining_time, elapsed_time);\n");
       s4o.print(s4o.indent_spaces + "if (");
       s4o.print("__time_cmp(");
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
+      s4o.print("__action_list[j].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) <= 0) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
+      s4o.print("__action_list[j].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n");
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset = 1;\n");
+      s4o.print("__action_list[j].reset = 1;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
+      /* keep the action in the list while it still has something to do (the state may be forced) */
+      s4o.print(s4o.indent_spaces + "if (");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print("__action_list[j].state) || ");
+      print_variable_prefix();
+      s4o.print("__action_list[j].stored || ");
+      print_variable_prefix();
+      s4o.print("__action_list[j].set || ");
+      print_variable_prefix();
+      s4o.print("__action_list[j].reset ||\n" + s4o.indent_spaces + "    __time_cmp(");
+      print_variable_prefix();
+      s4o.print("__action_list[j].set_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0 ||\n" + s4o.indent_spaces + "    __time_cmp(");
+      print_variable_prefix();
+      s4o.print("__action_list[j].reset_remaining_time, __time_to_timespec(1, 0, 0, 0, 0, 0)) > 0) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__active_action_list[nb_active++] = j;\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n");
       s4o.indent_left();
-      s4o.print(s4o.indent_spaces + "}\n\n");
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces);
+      print_variable_prefix();
+      s4o.print("__nb_active_actions = nb_active;\n\n");
       
+      /* generate the list of transitions that may fire, i.e. those leaving an active step, in priority order */
+      s4o.print(s4o.indent_spaces + "// Transitions enabled by the active steps\n");
+      s4o.print(s4o.indent_spaces + "nb = 0;\n");
+      s4o.print(s4o.indent_spaces + "if (__DEBUG) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      print_variable_prefix();
+      s4o.print("__nb_transitions; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "enabled_transitions[nb++] = i;\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces + "else {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
+      print_variable_prefix();
+      s4o.print("__nb_active_steps; i++) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "if (!");
+      s4o.print(GET_VAR);
+      s4o.print("(");
+      print_variable_prefix();
+      s4o.print("__step_list[");
+      print_variable_prefix();
+      s4o.print("__active_step_list[i]].X)) continue;\n");
+      s4o.print(s4o.indent_spaces + "switch (");
+      print_variable_prefix();
+      s4o.print("__active_step_list[i]) {\n");
+      s4o.indent_right();
+      for(i = 0; i < symbol->n; i++) {
+        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::transitionenable_sg);
+      }
+      print_switch_end();
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n\n");
+
       /* generate transition tests */
       s4o.print(s4o.indent_spaces + "// Transitions fire test\n");
-      generate_c_sfc_elements->generate((symbol_c *)symbol, generate_c_sfc_elements_c::transitiontest_sg);
+      print_enabled_transitions_switch(symbol, generate_c_sfc_elements_c::transitiontest_sg);
       s4o.print("\n");
       
       /* generate transition reset steps */
       s4o.print(s4o.indent_spaces + "// Transitions reset steps\n");
-      generate_c_sfc_elements->reset_transition_number();
-      for(i = 0; i < symbol->n; i++) {
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepreset_sg);
-      }
+      print_enabled_transitions_switch(symbol, generate_c_sfc_elements_c::stepreset_sg);
       s4o.print("\n");
       
       /* generate transition set steps */
       s4o.print(s4o.indent_spaces + "// Transitions set steps\n");
-      generate_c_sfc_elements->reset_transition_number();
-      for(i = 0; i < symbol->n; i++) {
-        generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::stepset_sg);
-      }
+      print_enabled_transitions_switch(symbol, generate_c_sfc_elements_c::stepset_sg);
       s4o.print("\n");
       
       /* generate step association */
       s4o.print(s4o.indent_spaces + "// Steps association\n");
+      print_active_list_switch_begin("__active_step_list", "__nb_active_steps");
       for(i = 0; i < symbol->n; i++) {
         generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionassociation_sg);
       }
+      print_switch_end();
       s4o.print("\n");
       
       /* generate action state evaluation */
       s4o.print(s4o.indent_spaces + "// Actions state evaluation\n");
       s4o.print(s4o.indent_spaces + "for (i = 0; i < ");
       print_variable_prefix();
-      s4o.print("__nb_actions; i++) {\n");
+      s4o.print("__nb_active_actions; i++) {\n");
       s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "j = ");
+      print_variable_prefix();
+      s4o.print("__active_action_list[i];\n");
       s4o.print(s4o.indent_spaces + "if (");
       print_variable_prefix();
-      s4o.print("__action_list[i].set) {\n");
+      s4o.print("__action_list[j].set) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
+      s4o.print("__action_list[j].set_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].stored = 1;\n");
+      s4o.print("__action_list[j].stored = 1;\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n" + s4o.indent_spaces + "if (");
       print_variable_prefix();
-      s4o.print("__action_list[i].reset) {\n");
+      s4o.print("__action_list[j].reset) {\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
+      s4o.print("__action_list[j].reset_remaining_time = __time_to_timespec(1, 0, 0, 0, 0, 0);\n" + s4o.indent_spaces);
       print_variable_prefix();
-      s4o.print("__action_list[i].stored = 0;\n");
+      s4o.print("__action_list[j].stored = 0;\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n" + s4o.indent_spaces);
       s4o.print(SET_VAR);
       s4o.print("(");
       print_variable_prefix();
-      s4o.print(",__action_list[i].state,,");
+      s4o.print(",__action_list[j].state,,");
       s4o.print(GET_VAR);
       s4o.print("(");
       print_variable_prefix();
-      s4o.print("__action_list[i].state) | ");
+      s4o.print("__action_list[j].state) | ");
       print_variable_prefix();
-      s4o.print("__action_list[i].stored);\n");
+      s4o.print("__action_list[j].stored);\n");
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}\n\n");
       
-      /* generate action execution */
+      /* generate action execution (first the actions that reference a variable, then the action blocks) */
       s4o.print(s4o.indent_spaces + "// Actions execution\n");
+      print_active_list_switch_begin("__active_action_list", "__nb_active_actions");
       {
         std::list<VARIABLE>::iterator pt;
         for(pt = variable_list.begin(); pt != variable_list.end(); pt++) {
@@ -921,6 +1157,11 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
           if (is_variable(pt->symbol)) {
             unsigned int vartype = search_var_instance_decl->get_vartype(pt->symbol);
 
+            s4o.print(s4o.indent_spaces + "case ");
+            s4o.print(SFC_STEP_ACTION_PREFIX);
+            pt->symbol->accept(*this);
+            s4o.print(":\n");
+            s4o.indent_right();
             s4o.print(s4o.indent_spaces + "if (");
             print_variable_prefix();
             s4o.print("__action_list[");
@@ -963,23 +1204,32 @@ class generate_c_sfc_c: public generate_c_base_and_typeid_c {
             s4o.print(",,1);\n");
             s4o.indent_left();
             s4o.print(s4o.indent_spaces + "}\n");
+            s4o.print(s4o.indent_spaces + "break;\n");
+            s4o.indent_left();
           }
         }
       }
+      print_switch_end();
+      print_active_list_switch_begin("__active_action_list", "__nb_active_actions");
       for(i = 0; i < symbol->n; i++) {
         generate_c_sfc_elements->generate(symbol->get_element(i), generate_c_sfc_elements_c::actionbody_sg);
       }
+      print_switch_end();
       s4o.print("\n");
       
       return NULL;
     }
     
     void *visit(initial_step_c *symbol) {
+      if (sfc_step_is_sticky(symbol->action_association_list))
+        sticky_step_list.push_back(symbol->step_name);
       symbol->action_association_list->accept(*this);
       return NULL;
     }
 
     void *visit(step_c *symbol) {
+      if (sfc_step_is_sticky(symbol->action_association_list))
+        sticky_step_list.push_back(symbol->step_name);
       symbol->action_association_list->accept(*this);
       return NULL;
     }
@@ -27,6 +27,20 @@ typedef struct
   identifier_c *symbol;
 } VARIABLE;
 
+/* A step with a P, P1 or P0 action association sets the action (or variable) on every cycle,
+ * even while the step is inactive, so it is never removed from the list of active steps.
+ */
+static bool sfc_step_is_sticky(symbol_c *action_association_list) {
+  list_c *list = (list_c *)action_association_list;
+  for(int i = 0; i < list->n; i++) {
+    action_association_c *association = dynamic_cast<action_association_c *>(list->get_element(i));
+    if ((NULL == association) || (NULL == association->action_qualifier)) continue;
+    qualifier_c *qualifier = dynamic_cast<qualifier_c *>(((action_qualifier_c *)association->action_qualifier)->action_qualifier);
+    if ((NULL != qualifier) && (toupper(qualifier->value[0]) == 'P')) return true;
+  }
+  return false;
+}
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -68,6 +82,16 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
       delete search_var_instance_decl;
     }
     
+    void print_active_step_insert(void) {
+      s4o.print(s4o.indent_spaces + "__sfc_list_insert(");
+      print_variable_prefix();
+      s4o.print("__active_step_list, &");
+      print_variable_prefix();
+      s4o.print("__nb_active_steps, ");
+      s4o.print(step_number);
+      s4o.print(");\n");
+    }
+
     void generate(symbol_c *symbol, sfcdeclaration_t declaration_type) {
       wanted_sfcdeclaration = declaration_type;
 
@@ -92,12 +116,20 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print(step_number);
           s4o.print("];\n");
           s4o.print(s4o.indent_spaces + "UINT __nb_steps;\n");
+          s4o.print(s4o.indent_spaces + "UINT __active_step_list[");
+          s4o.print(step_number);
+          s4o.print("];\n");
+          s4o.print(s4o.indent_spaces + "UINT __nb_active_steps;\n");
           
           /* actions table declaration */
           s4o.print(s4o.indent_spaces + "ACTION __action_list[");
           s4o.print(action_number);
           s4o.print("];\n");
           s4o.print(s4o.indent_spaces + "UINT __nb_actions;\n");
+          s4o.print(s4o.indent_spaces + "UINT __active_action_list[");
+          s4o.print(action_number);
+          s4o.print("];\n");
+          s4o.print(s4o.indent_spaces + "UINT __nb_active_actions;\n");
           
           /* transitions table declaration */
           s4o.print(s4o.indent_spaces + "__IEC_BOOL_t __transition_list[");
@@ -130,7 +162,7 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           wanted_sfcdeclaration = sfcinit_sd;
           
           /* steps table initialisation */
-          s4o.print(s4o.indent_spaces + "static const STEP temp_step = {{0, 0}, 0, {{0, 0}, 0}};\n");
+          s4o.print(s4o.indent_spaces + "static const STEP temp_step = {{0}};\n");
           s4o.print(s4o.indent_spaces + "for(i = 0; i < ");
           print_variable_prefix();
           s4o.print("__nb_steps; i++) {\n");
@@ -140,6 +172,9 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print("__step_list[i] = temp_step;\n");
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
+          s4o.print(s4o.indent_spaces);
+          print_variable_prefix();
+          s4o.print("__nb_active_steps = 0;\n");
           for(int i = 0; i < symbol->n; i++)
             symbol->get_element(i)->accept(*this);
           
@@ -156,7 +191,7 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           wanted_sfcdeclaration = sfcinit_sd;
           
           /* actions table initialisation */
-          s4o.print(s4o.indent_spaces + "static const ACTION temp_action = {0, {0, 0}, 0, 0, {0, 0}, {0, 0}};\n");
+          s4o.print(s4o.indent_spaces + "static const ACTION temp_action = {0};\n");
           s4o.print(s4o.indent_spaces + "for(i = 0; i < ");
           print_variable_prefix();
           s4o.print("__nb_actions; i++) {\n");
@@ -166,6 +201,9 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print("__action_list[i] = temp_action;\n");
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
+          s4o.print(s4o.indent_spaces);
+          print_variable_prefix();
+          s4o.print("__nb_active_actions = 0;\n");
           
           /* transitions table count */
           wanted_sfcdeclaration = transitioncount_sd;
@@ -266,6 +304,7 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
           s4o.print(",__step_list[");
           s4o.print(step_number);
           s4o.print("].X,,1);\n");
+          print_active_step_insert();
           step_number++;
           break;
         case stepdef_sd:
@@ -307,7 +346,11 @@ class generate_c_sfcdecl_c: protected generate_c_base_and_typeid_c {
         case sfcdecl_sd:
           symbol->action_association_list->accept(*this);
         case stepcount_sd:
+          step_number++;
+          break;
         case sfcinit_sd:
+          if (sfc_step_is_sticky(symbol->action_association_list))
+            print_active_step_insert();
           step_number++;
           break;
         case stepdef_sd:
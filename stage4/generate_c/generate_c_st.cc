@@ -774,11 +774,13 @@ void *visit(function_invocation_c *symbol) {
        * parameter name so we can go looking for the value passed to the correct
        * extended parameter (e.g. IN1, IN2, IN3, IN4, ...)
        */
-      char *tmp = (char *)malloc(32); /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
+      char tmp[32]; /* enough space for a call with 10^31 (larger than 2^64) input parameters! */
       int res = snprintf(tmp, 32, "%d", fp_iterator.extensible_param_index());
       if ((res >= 32) || (res < 0)) ERROR;
-      param_name = new identifier_c(strdup2(param_name->value, tmp));
-      if (param_name->value == NULL) ERROR;
+      char *name = strdup2(param_name->value, tmp);
+      if (name == NULL) ERROR;
+      param_name = new identifier_c(name); /* identifier_c keeps its own (interned) copy of name */
+      free(name);
     }
     
     symbol_c *param_type = fp_iterator.param_type();
@@ -1290,8 +1292,8 @@ void *visit(for_statement_c *symbol) {
     integer_c              integer_oneval("1");
     add_expression_c       add_expression(symbol->control_variable, &integer_oneval);
     assignment_statement_c inc_assignment(symbol->control_variable, &add_expression);
-    integer_oneval.const_value._int64 .set(1);                    // set the stage3 anottation we need 
-    integer_oneval.const_value._uint64.set(1);                    // set the stage3 anottation we need
+    integer_oneval.const_value->_int64 .set(1);                    // set the stage3 anottation we need 
+    integer_oneval.const_value->_uint64.set(1);                    // set the stage3 anottation we need
     integer_oneval.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
     add_expression.datatype = symbol->control_variable->datatype; // set the stage3 anottation we need
     inc_assignment.accept(*this);
@@ -90,7 +90,8 @@ class generate_datatypes_aliasid_c: fcall_visitor_c {
   private:
     //std::map<std::string, int> inline_array_defined;
     std::string current_array_name;
-    static generate_datatypes_aliasid_c *singleton_;
+    /* NOTE: the singleton keeps the name being built, so each thread gets its own (see generate_c_pou_filepair_c) */
+    static __thread generate_datatypes_aliasid_c *singleton_;
 
   public:
     generate_datatypes_aliasid_c(void) {};
@@ -196,7 +197,7 @@ class generate_datatypes_aliasid_c: fcall_visitor_c {
 };
 
 
-generate_datatypes_aliasid_c *generate_datatypes_aliasid_c::singleton_ = NULL;
+__thread generate_datatypes_aliasid_c *generate_datatypes_aliasid_c::singleton_ = NULL;
 
 
 
@@ -853,6 +853,11 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
      *
      *                e.g.
      *                __plc_pt_c<INT, 8*sizeof(INT)> START_P::loc = __plc_pt_c<INT, 8*sizeof(INT)>("I2");
+     *
+     * retainsegment_vf: the members of the retain segment (-O k option), i.e. the
+     *                RETAIN global variables that are not located variables.
+     *                e.g.
+     *                __DECLARE_RETAIN(INT,VAR1)
      */
     typedef enum {finterface_vf,
                   foutputassign_vf,
@@ -861,7 +866,8 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
                   init_vf,
                   constructorinit_vf,
                   globalinit_vf,
-                  globalprototype_vf
+                  globalprototype_vf,
+                  retainsegment_vf
                  } varformat_t;
 
 
@@ -2119,6 +2125,9 @@ void *visit(global_var_spec_c *symbol) {
       s4o.print(")\n");
       break;
     
+    case retainsegment_vf:
+      break;
+
     default:
       ERROR;
   } /* switch() */
@@ -2146,13 +2155,31 @@ void *visit(global_var_list_c *symbol) {
   /* should NEVER EVER occur!! */
   if (list == NULL) ERROR;
 
+  /* the variable is placed in the retain segment of the configuration/resource (-O k)? */
+  bool in_retain_segment = generate_retain_segment__ && (current_varqualifier == retain_vq) && (this->resource_name != NULL);
+
   /* now to produce the c equivalent... */
   switch (wanted_varformat) {
     case local_vf:
     case localinit_vf:
       for(int i = 0; i < list->n; i++) {
+        if (in_retain_segment) {
+          /* #define RES1__VAR1 (RES1__retain.VAR1) */
+          s4o.print(s4o.indent_spaces);
+          s4o.print("#define ");
+          this->resource_name->accept(*this);
+          s4o.print("__");
+          list->get_element(i)->accept(*this);
+          s4o.print(" (");
+          this->resource_name->accept(*this);
+          s4o.print("__retain.");
+          list->get_element(i)->accept(*this);
+          s4o.print(")\n");
+        }
         s4o.print(s4o.indent_spaces);
-        if (is_fb)
+        if (in_retain_segment)
+          s4o.print(is_fb? DECLARE_GLOBAL_FB_RETAIN : DECLARE_GLOBAL_RETAIN);
+        else if (is_fb)
           s4o.print(DECLARE_GLOBAL_FB);
         else
           s4o.print(DECLARE_GLOBAL);
@@ -2229,6 +2256,19 @@ void *visit(global_var_list_c *symbol) {
       }
       break;
 
+    case retainsegment_vf:
+      if (!in_retain_segment) break;
+      for(int i = 0; i < list->n; i++) {
+        s4o.print(s4o.indent_spaces);
+        s4o.print(is_fb? DECLARE_RETAIN_FB : DECLARE_RETAIN);
+        s4o.print("(");
+        this->current_var_type_symbol->accept(*this);
+        s4o.print(",");
+        list->get_element(i)->accept(*this);
+        s4o.print(")\n");
+      }
+      break;
+
     default:
       ERROR; /* not supported, and not needed either... */
   }
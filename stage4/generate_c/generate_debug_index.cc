@@ -0,0 +1,333 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2011  Mario de Sousa (msousa@fe.up.pt)
+ *  Copyright (C) 2007-2011  Laurent Bessard and Edouard Tisserant
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ * The compiled debug symbol index (-O d, see lib/C/iec_debug.h).
+ *
+ * The variables are the ones listed in VARIABLES.csv, with the same numbers. We have
+ * generate_var_list_c list them again (into memory), and work out from the C path of each
+ * variable the file in which it is declared (the configuration, or one of its resources),
+ * and its name in that file. Then:
+ *   - print_entries() prints the entries of the variables declared in each configuration and resource file,
+ *   - print_index() prints DEBUG_INDEX.c (the entry of each variable by number, their names
+ *     and the perfect hash table over those names), and writes the same index to DEBUG_INDEX.bin.
+ */
+
+#include <set>
+#include <map>
+#include <algorithm>
+
+
+class generate_debug_index_c {
+
+  private:
+    typedef struct {
+      std::string  name;    /* dotted name, as in VARIABLES.csv */
+      std::string  domain;  /* the configuration or resource in whose file the variable is declared */
+      std::string  cvar;    /* the variable, in that file. "": not available */
+      unsigned int index;   /* of its entry in <domain>__debug_entries[] */
+      int          vclass;  /* __IEC_DEBUG_CLASS_t */
+      int          type;    /* __IEC_types_enum */
+      std::string  type_name;
+      uint64_t     hash;
+    } var_t;
+
+    std::vector<var_t>       vars;
+    std::vector<std::string> domains;  /* in the order they are generated */
+
+    /* the perfect hash table */
+    std::vector<uint32_t> disp;
+    std::vector<uint32_t> slots;
+
+    /* The elementary types, in the order of __ANY() in iec_types_all.h, which sets their __IEC_types_enum
+     * (the <type>_ENUM of all of them, followed by the <type>_P_ENUM, the <type>_O_ENUM, and UNKNOWN_ENUM).
+     */
+    static void set_type(var_t &var, const std::string &type, bool pointer) {
+      static const char *elementary[] = {"REAL", "LREAL", "SINT", "INT", "DINT", "LINT", "USINT", "UINT", "UDINT", "ULINT",
+                                         "TIME", "BYTE", "WORD", "DWORD", "LWORD", "BOOL", "STRING", "DATE", "TOD", "DT", NULL};
+      int i;
+      for (i = 0; elementary[i] != NULL; i++)
+        if (type == elementary[i]) {
+          var.type      = pointer? 20 + i : i;
+          var.type_name = type + (pointer? "_P_ENUM" : "_ENUM");
+          return;
+        }
+      var.type      = 3*i;
+      var.type_name = "UNKNOWN_ENUM";
+    }
+
+    /* same order as __IEC_DEBUG_CLASS_t */
+    static int class_enum(const std::string &vclass) {
+      static const char *classes[] = {"VAR", "EXT", "IN", "OUT", "MEM", "FB", "EXT_FB", NULL};
+      for (int i = 0; classes[i] != NULL; i++)
+        if (vclass == classes[i]) return i;
+      ERROR;
+      return 0;
+    }
+    static const char *class_enum_name(int vclass) {
+      static const char *names[] = {"__IEC_DEBUG_VAR_CLASS", "__IEC_DEBUG_EXT_CLASS", "__IEC_DEBUG_IN_CLASS", "__IEC_DEBUG_OUT_CLASS",
+                                    "__IEC_DEBUG_MEM_CLASS", "__IEC_DEBUG_FB_CLASS", "__IEC_DEBUG_EXT_FB_CLASS"};
+      return names[vclass];
+    }
+
+    /* Must produce the same values as __iec_debug_hash() and __iec_debug_mix() in iec_debug.h */
+    static uint64_t hash(const std::string &name) {
+      uint64_t h = 14695981039346656037ULL;
+      for (unsigned int i = 0; i < name.size(); i++) {h ^= (unsigned char)toupper(name[i]); h *= 1099511628211ULL;}
+      return h;
+    }
+    static uint32_t mix(uint32_t x, uint32_t d) {
+      x ^= d * 0x9E3779B9U;
+      x ^= x >> 16; x *= 0x85EBCA6BU;
+      x ^= x >> 13; x *= 0xC2B2AE35U;
+      x ^= x >> 16;
+      return x;
+    }
+
+    static std::vector<std::string> split(const std::string &str, char sep) {
+      std::vector<std::string> res;
+      size_t beg = 0, end;
+      while ((end = str.find(sep, beg)) != std::string::npos) {res.push_back(str.substr(beg, end - beg)); beg = end + 1;}
+      res.push_back(str.substr(beg));
+      return res;
+    }
+
+    /* C path (as in VARIABLES.csv) of a variable => the file it is declared in, and its name in that file */
+    void locate(var_t &var, const std::string &cpath, const std::string &configuration, bool single_resource) {
+      std::vector<std::string> parts = split(cpath, '.');
+      unsigned int first;  /* the first part of the C path inside the domain */
+      if ((parts.size() < 2) || (parts[0] != configuration)) ERROR;
+      if (parts.size() == 2) {
+        var.domain = configuration; first = 1;                 /* CONFIG.GLOBAL */
+      } else if (single_resource) {
+        var.domain = "RESOURCE";    first = 1;                 /* CONFIG.PROGRAM.VAR */
+      } else {
+        var.domain = parts[1];      first = 2;                 /* CONFIG.RES.GLOBAL, CONFIG.RES.PROGRAM.VAR */
+      }
+      /* a located global variable without a name (e.g. __IX0_0) is not declared under that name */
+      if ((first == parts.size() - 1) && (parts[first].compare(0, 2, "__") == 0)) {var.cvar = ""; return;}
+      var.cvar = var.domain + "__" + parts[first];
+      for (unsigned int i = first + 1; i < parts.size(); i++) var.cvar += "." + parts[i];
+    }
+
+    /* Find the displacement of each bucket so that every name lands in a different slot.
+     * Buckets are placed largest first, while most of the slots are still free.
+     */
+    bool build_hash_table(const std::vector<unsigned int> &keys, uint32_t bucket_count, uint32_t slot_count) {
+      std::vector<std::vector<unsigned int> > buckets(bucket_count);
+      std::vector<std::pair<size_t, uint32_t> > order;
+      std::vector<uint32_t> taken;
+
+      disp.assign(bucket_count, 0);
+      slots.assign(slot_count, 0xFFFFFFFFU);
+      for (unsigned int i = 0; i < keys.size(); i++)
+        buckets[(uint32_t)(vars[keys[i]].hash >> 32) % bucket_count].push_back(keys[i]);
+      for (uint32_t b = 0; b < bucket_count; b++)
+        if (buckets[b].size() > 0) order.push_back(std::make_pair(buckets[b].size(), b));
+      std::stable_sort(order.begin(), order.end(), std::greater<std::pair<size_t, uint32_t> >());
+
+      for (unsigned int i = 0; i < order.size(); i++) {
+        std::vector<unsigned int> &bucket = buckets[order[i].second];
+        uint32_t d;
+        for (d = 0; d < (1U << 20); d++) {
+          taken.clear();
+          unsigned int k;
+          for (k = 0; k < bucket.size(); k++) {
+            uint32_t slot = mix((uint32_t)vars[bucket[k]].hash, d) % slot_count;
+            if ((slots[slot] != 0xFFFFFFFFU) || (std::find(taken.begin(), taken.end(), slot) != taken.end())) break;
+            taken.push_back(slot);
+          }
+          if (k == bucket.size()) break;
+        }
+        if (d == (1U << 20)) return false;
+        disp[order[i].second] = d;
+        for (unsigned int k = 0; k < bucket.size(); k++) slots[taken[k]] = bucket[k];
+      }
+      return true;
+    }
+
+    void print_uint32_table(stage4out_c &s4o, const char *name, std::vector<uint32_t> &table) {
+      s4o.print("const uint32_t ");
+      s4o.print(name);
+      s4o.print("[");
+      s4o.print((unsigned int)table.size());
+      s4o.print("] = {");
+      for (unsigned int i = 0; i < table.size(); i++) {
+        if (i > 0) s4o.print(",");
+        s4o.print((i % 16 == 0)? "\n  " : " ");
+        if (table[i] == 0xFFFFFFFFU) s4o.print("0xFFFFFFFF");
+        else                         s4o.print(table[i]);
+      }
+      s4o.print("};\n\n");
+    }
+
+    static void put_uint32(std::string &out, uint32_t value) {out.append((const char *)&value, sizeof(value));}
+    static void put_uint16(std::string &out, uint16_t value) {out.append((const char *)&value, sizeof(value));}
+
+
+  public:
+    generate_debug_index_c(symbol_c *library) {
+      configuration_declaration_c *configuration = NULL;
+      library_c *list = dynamic_cast<library_c *>(library);
+      if (NULL == list) ERROR;
+      for (int i = 0; (i < list->n) && (NULL == configuration); i++)
+        configuration = dynamic_cast<configuration_declaration_c *>(list->get_element(i));
+      if (NULL == configuration) return;  /* nothing to debug */
+
+      token_c *configuration_name = dynamic_cast<token_c *>(configuration->configuration_name);
+      if (NULL == configuration_name) ERROR;
+      std::string config = upper(configuration_name->value);
+      bool single_resource = (NULL != dynamic_cast<single_resource_declaration_c *>(configuration->resource_declarations));
+
+      /* list the variables, as in VARIABLES.csv */
+      stage4out_c variables_s4o;
+      variables_s4o.keep_in_memory();
+      {
+        generate_var_list_c generate_var_list(&variables_s4o, library);
+        generate_var_list.mark_external_fbs = true;
+        generate_var_list.generate_variables(library);
+      }
+
+      /* N;CLASS;PATH;C_PATH;TYPE; */
+      std::vector<std::string> lines = split(variables_s4o.contents(), '\n');
+      std::map<std::string, unsigned int> domain_size;
+      for (unsigned int i = 0; i < lines.size(); i++) {
+        if ((lines[i].size() == 0) || (lines[i].compare(0, 2, "//") == 0)) continue;
+        std::vector<std::string> fields = split(lines[i], ';');
+        if (fields.size() < 5) ERROR;
+        if (atoi(fields[0].c_str()) != (int)vars.size()) ERROR;
+        var_t var;
+        var.name   = fields[2];
+        var.vclass = class_enum(fields[1]);
+        set_type(var, fields[4], (var.vclass != 0 /* VAR */) && (var.vclass != 5 /* FB */));
+        var.hash   = hash(var.name);
+        locate(var, fields[3], config, single_resource);
+        if (domain_size.find(var.domain) == domain_size.end()) {domains.push_back(var.domain); domain_size[var.domain] = 0;}
+        var.index  = domain_size[var.domain]++;
+        vars.push_back(var);
+      }
+
+      /* the perfect hash table, over the (distinct) names */
+      std::vector<unsigned int> keys;
+      std::set<std::string> names;
+      for (unsigned int i = 0; i < vars.size(); i++)
+        if (names.insert(upper(vars[i].name.c_str())).second) keys.push_back(i);
+      uint32_t bucket_count = keys.size() / 4 + 1;
+      uint32_t slot_count   = keys.size() + keys.size() / 16 + 1;
+      for (int retry = 0; !build_hash_table(keys, bucket_count, slot_count); retry++) {
+        if (retry == 8) ERROR_MSG("could not build the hash table of the debug symbol index");
+        slot_count += slot_count / 8 + 1;
+      }
+    }
+
+
+    /* const __IEC_DEBUG_ENTRY_t RES1__debug_entries[] = {__IEC_DEBUG_VAR(RES1__INSTANCE0.X, INT_ENUM), ...}; */
+    void print_entries(stage4out_c &s4o, std::string domain) {
+      unsigned int count = 0;
+      for (unsigned int i = 0; i < vars.size(); i++)
+        if (vars[i].domain == domain) count++;
+      if (count == 0) return;
+
+      s4o.print("\n#include \"iec_debug.h\"\n\n");
+      s4o.print("const __IEC_DEBUG_ENTRY_t " + domain + "__debug_entries[] = {\n");
+      s4o.indent_right();
+      for (unsigned int i = 0; i < vars.size(); i++) {
+        var_t &var = vars[i];
+        if (var.domain != domain) continue;
+        s4o.print(s4o.indent_spaces);
+        if (var.cvar.empty())
+          s4o.print(std::string("__IEC_DEBUG_NONE(") + class_enum_name(var.vclass) + ")");
+        else switch (var.vclass) {
+          case 0 /* VAR    */: s4o.print("__IEC_DEBUG_VAR(" + var.cvar + ", " + var.type_name + ")"); break;
+          case 5 /* FB     */: s4o.print("__IEC_DEBUG_FB(" + var.cvar + ")");                        break;
+          case 6 /* EXT_FB */: s4o.print("__IEC_DEBUG_EXT_FB(" + var.cvar + ")");                    break;
+          default            : s4o.print("__IEC_DEBUG_REF(" + var.cvar + ", " + var.type_name + ", " + class_enum_name(var.vclass) + ")"); break;
+        }
+        s4o.print(--count? ",\n" : "\n");
+      }
+      s4o.indent_left();
+      s4o.print("};\n");
+    }
+
+
+    void print_index(const char *builddir) {
+      /* DEBUG_INDEX.c */
+      stage4out_c s4o(builddir, "DEBUG_INDEX", "c");
+      s4o.print("/*******************************************/\n");
+      s4o.print("/*     FILE GENERATED BY iec2c             */\n");
+      s4o.print("/* Editing this file is not recommended... */\n");
+      s4o.print("/*******************************************/\n\n");
+      s4o.print("#include \"iec_debug.h\"\n\n");
+
+      for (unsigned int i = 0; i < domains.size(); i++)
+        s4o.print("extern const __IEC_DEBUG_ENTRY_t " + domains[i] + "__debug_entries[];\n");
+      s4o.print("\n");
+
+      s4o.print("const unsigned int __iec_debug_count      = ");
+      s4o.print((unsigned int)vars.size());
+      s4o.print(";\nconst unsigned int __iec_debug_buckets    = ");
+      s4o.print((unsigned int)disp.size());
+      s4o.print(";\nconst unsigned int __iec_debug_slot_count = ");
+      s4o.print((unsigned int)slots.size());
+      s4o.print(";\n\n");
+      print_uint32_table(s4o, "__iec_debug_disp",  disp);
+      print_uint32_table(s4o, "__iec_debug_slots", slots);
+
+      /* an array may not be empty */
+      s4o.print("const char *const __iec_debug_names[] = {\n");
+      for (unsigned int i = 0; i < vars.size(); i++)
+        s4o.print("  \"" + vars[i].name + "\",\n");
+      s4o.print("  NULL};\n\n");
+
+      s4o.print("const __IEC_DEBUG_ENTRY_t *const __iec_debug_entries[] = {\n");
+      for (unsigned int i = 0; i < vars.size(); i++) {
+        s4o.print("  &" + vars[i].domain + "__debug_entries[");
+        s4o.print(vars[i].index);
+        s4o.print("],\n");
+      }
+      s4o.print("  NULL};\n");
+
+      /* DEBUG_INDEX.bin */
+      std::string names, out;
+      out.append("IECDBGI1", 8);
+      for (unsigned int i = 0; i < vars.size(); i++) names.append(vars[i].name.c_str(), vars[i].name.size() + 1);
+      put_uint32(out, vars.size());
+      put_uint32(out, disp.size());
+      put_uint32(out, slots.size());
+      put_uint32(out, names.size());
+      for (unsigned int i = 0; i < disp.size();  i++) put_uint32(out, disp[i]);
+      for (unsigned int i = 0; i < slots.size(); i++) put_uint32(out, slots[i]);
+      for (unsigned int i = 0, offset = 0; i < vars.size(); i++) {
+        put_uint32(out, offset);
+        put_uint16(out, vars[i].type);
+        out.push_back((char)vars[i].vclass);
+        out.push_back('\0');
+        offset += vars[i].name.size() + 1;
+      }
+      out.append(names);
+      stage4out_c bin_s4o(builddir, "DEBUG_INDEX", "bin");
+      bin_s4o.print(out);
+    }
+};
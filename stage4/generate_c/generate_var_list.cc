@@ -227,6 +227,9 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
     } varclasscategory_t;
 
     varclasscategory_t current_var_class_category;
+
+    /* List the external function block instances (in C, a pointer to the instance) as EXT_FB instead of FB */
+    bool mark_external_fbs;
     
   private:
     symbol_c *current_var_type_symbol;
@@ -248,6 +251,7 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       current_var_type_name = NULL;
       current_declarationtype = none_dt;
       current_var_class_category = none_vcc;
+      mark_external_fbs = false;
     }
     
     ~generate_var_list_c(void) {
@@ -312,7 +316,10 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
           s4o.print("STRUCT");
           break;
         case search_type_symbol_c::function_block_vtc:
-          s4o.print("FB");
+          if (mark_external_fbs && (this->current_var_class_category == external_vcc))
+            s4o.print("EXT_FB");
+          else
+            s4o.print("FB");
           break;
         default:
           switch (this->current_var_class_category) {
@@ -39,11 +39,18 @@
 
 
 
-// #include <stdio.h>  /* required for NULL */
+#include <stdio.h>
 #include <string>
-#include <iostream>
-#include <fstream>
 #include <stdlib.h>
+#include <string.h>    /* required for strlen() and strerror() */
+#include <ctype.h>     /* required for toupper() */
+#include <errno.h>
+#include <limits.h>    /* required for IOV_MAX */
+#include <fcntl.h>     /* required for open() */
+#include <unistd.h>    /* required for write() and close() */
+#ifdef __unix__
+#include <sys/uio.h>   /* required for writev() */
+#endif
 
 #include "stage4.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
@@ -73,54 +80,223 @@ void stage4err(const char *stage4_generator_id, symbol_c *symbol1, symbol_c *sym
 
 
 
-stage4out_c::stage4out_c(std::string indent_level):
-	m_file(NULL) {
-  out = &std::cout;
+/* size of the output buffer of each file */
+#define STAGE4OUT_BUFFER_SIZE (256 * 1024)
+
+#ifndef IOV_MAX
+#define IOV_MAX 16
+#endif
+
+bool stage4out_c::writev_default         = false;
+bool stage4out_c::keep_unchanged_default = false;
+
+void stage4out_c::use_writev          (bool enable) {writev_default         = enable;}
+void stage4out_c::keep_unchanged_files(bool enable) {keep_unchanged_default = enable;}
+
+
+stage4out_c::stage4out_c(std::string indent_level) {
+  fd = -1;
+  buffer = NULL;
+  buffer_used = buffer_size = 0;
+  writev_mode = false;
+  in_memory = false;
+  keep_unchanged = false;
   this->indent_level = indent_level;
   this->indent_spaces = "";
   allow_output = true;
 }
 
 stage4out_c::stage4out_c(const char *dir, const char *radix, const char *extension, std::string indent_level) {	
-  std::string filename(radix);
+  filename  = radix;
   filename += ".";
   filename += extension;
-  std::string filepath("");
+  filepath = "";
   if (dir != NULL) {
     filepath += dir;
     filepath += "/";
   }
   filepath += filename;
-  std::fstream *file = new std::fstream(filepath.c_str(), std::fstream::out);
-  if(file->fail()){
-    std::cerr << "Cannot open " << filename << " for write access \n";
-    exit(EXIT_FAILURE);
-  }else{
-    std::cout << filename << "\n";
-  }
-  out = file;
-  m_file = file;
+  fd = -1;
+  in_memory = false;
+  keep_unchanged = keep_unchanged_default;
+  /* the whole file must be kept in memory to compare it with the existing file */
+  writev_mode = writev_default || keep_unchanged;
+  if (!keep_unchanged)
+    open_file();
+  printf("%s\n", filename.c_str());
+  buffer = (char *)malloc(STAGE4OUT_BUFFER_SIZE);
+  if (NULL == buffer) ERROR_MSG("out of memory");
+  buffer_used = 0;
+  buffer_size = STAGE4OUT_BUFFER_SIZE;
   this->indent_level = indent_level;
   this->indent_spaces = "";
   allow_output = true;
 }
 
+void stage4out_c::keep_in_memory(void) {
+  if ((NULL != buffer) || (fd >= 0)) ERROR;
+  buffer = (char *)malloc(STAGE4OUT_BUFFER_SIZE);
+  if (NULL == buffer) ERROR_MSG("out of memory");
+  buffer_used = 0;
+  buffer_size = STAGE4OUT_BUFFER_SIZE;
+  writev_mode = true;
+  in_memory = true;
+}
+
+std::string stage4out_c::contents(void) {
+  std::string res;
+  if (!in_memory) ERROR;
+  res.reserve(full_buffers.size() * buffer_size + buffer_used);
+  for (size_t i = 0; i < full_buffers.size(); i++) res.append(full_buffers[i], buffer_size);
+  res.append(buffer, buffer_used);
+  return res;
+}
+
 stage4out_c::~stage4out_c(void) {
-  if(m_file)
-  {
-    m_file->close();
-    delete m_file;
+  if (NULL == buffer) return;  /* stdout */
+  if (in_memory) {
+    for (size_t i = 0; i < full_buffers.size(); i++) free(full_buffers[i]);
+    free(buffer);
+    return;
+  }
+  if (keep_unchanged) {
+    if (is_unchanged()) {
+      for (size_t i = 0; i < full_buffers.size(); i++) free(full_buffers[i]);
+      free(buffer);
+      return;
+    }
+    open_file();
+  }
+  flush();
+  close(fd);
+  free(buffer);
+}
+
+
+void stage4out_c::open_file(void) {
+  fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0) {
+    fprintf(stderr, "Cannot open %s for write access \n", filename.c_str());
+    exit(EXIT_FAILURE);
+  }
+}
+
+
+/* The file already exists, with exactly the contents kept in memory */
+bool stage4out_c::is_unchanged(void) {
+  int old_fd = open(filepath.c_str(), O_RDONLY);
+  if (old_fd < 0) return false;
+
+  bool res = (lseek(old_fd, 0, SEEK_END) == (off_t)(full_buffers.size() * buffer_size + buffer_used))
+          && (lseek(old_fd, 0, SEEK_SET) == 0);
+  char  *old_contents = (char *)malloc(buffer_size);
+  if (NULL == old_contents) ERROR_MSG("out of memory");
+  for (size_t i = 0; res && (i <= full_buffers.size()); i++) {
+    const char *contents = (i < full_buffers.size())? full_buffers[i] : buffer;
+    size_t      len      = (i < full_buffers.size())? buffer_size     : buffer_used;
+    size_t      done     = 0;
+    while (done < len) {
+      ssize_t n = read(old_fd, old_contents + done, len - done);
+      if ((n < 0) && (errno == EINTR)) continue;
+      if  (n <= 0) break;
+      done += n;
+    }
+    res = (done == len) && (memcmp(old_contents, contents, len) == 0);
+  }
+  free(old_contents);
+  close(old_fd);
+  return res;
+}
+
+
+/* write out len chars, directly to the file (or to stdout) */
+void stage4out_c::write_out(const char *str, size_t len) {
+  if (NULL == buffer) {fwrite(str, 1, len, stdout); return;}
+  while (len > 0) {
+    ssize_t res = write(fd, str, len);
+    if ((res < 0) && (errno == EINTR)) continue;
+    if (res <= 0) {
+      fprintf(stderr, "Error writing to %s: %s\n", filename.c_str(), strerror(errno));
+      exit(EXIT_FAILURE);
+    }
+    str += res;
+    len -= res;
+  }
+}
+
+
+/* the chars do not fit in what is left of the buffer */
+void stage4out_c::append_slow(const char *str, size_t len) {
+  if (NULL == buffer) {write_out(str, len); return;}  /* stdout */
+
+  if (!writev_mode) {
+    write_out(buffer, buffer_used);
+    buffer_used = 0;
+    if (len >= buffer_size) {write_out(str, len); return;}
+    memcpy(buffer, str, len);
+    buffer_used = len;
+    return;
+  }
+
+  /* writev_mode: fill up the current buffer, and continue on a new buffer */
+  while (len > 0) {
+    size_t n = buffer_size - buffer_used;
+    if (n > len) n = len;
+    memcpy(buffer + buffer_used, str, n);
+    buffer_used += n; str += n; len -= n;
+    if (buffer_used == buffer_size) {
+      full_buffers.push_back(buffer);
+      buffer = (char *)malloc(STAGE4OUT_BUFFER_SIZE);
+      if (NULL == buffer) ERROR_MSG("out of memory");
+      buffer_used = 0;
+    }
   }
 }
 
+
 void stage4out_c::flush(void) {
-  out->flush();
+  if (NULL == buffer) {fflush(stdout); return;}
+  if (in_memory) return;
+  if (fd < 0) return;  /* keep_unchanged: the file is only written out when closed */
+
+  /* writev_mode: the buffers previously filled up */
+  size_t i = 0;
+#ifdef __unix__
+  while (i < full_buffers.size()) {
+    struct iovec iov[IOV_MAX];
+    int n = 0;
+    for (; (n < IOV_MAX - 1) && (i < full_buffers.size()); n++, i++) {
+      iov[n].iov_base = full_buffers[i];
+      iov[n].iov_len  = buffer_size;
+    }
+    bool last = (i == full_buffers.size());
+    if (last) {iov[n].iov_base = buffer; iov[n].iov_len = buffer_used; n++;}
+    /* writev() may write less than requested, in which case we write out the remainder with write_out() */
+    ssize_t res = writev(fd, iov, n);
+    if (res < 0) res = 0;
+    for (int k = 0; k < n; k++) {
+      size_t done = ((size_t)res < iov[k].iov_len)? res : iov[k].iov_len;
+      res -= done;
+      if (done < iov[k].iov_len) write_out((char *)iov[k].iov_base + done, iov[k].iov_len - done);
+    }
+    if (last) buffer_used = 0;
+  }
+#else
+  for (; i < full_buffers.size(); i++)
+    write_out(full_buffers[i], buffer_size);
+#endif
+  for (i = 0; i < full_buffers.size(); i++) free(full_buffers[i]);
+  full_buffers.clear();
+
+  write_out(buffer, buffer_used);
+  buffer_used = 0;
 }
 
+
 void stage4out_c::enable_output(void) {
   allow_output = true;
 }
-    
+
 void stage4out_c::disable_output(void) {
   allow_output = false;
 }
@@ -136,82 +312,117 @@ void stage4out_c::indent_left(void) {
     indent_spaces.erase();
 }
 
-void *stage4out_c::print(           std::string value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(           const char *value) {if (!allow_output) return NULL; *out << value; return NULL;}
+
+/* Integers are formatted here (instead of using printf()), as the generated code contains lots of them! */
+void stage4out_c::print_unsigned(unsigned long long value, const char *suffix) {
+  char  str[32];          /* 20 digits, followed by the suffix (at most 3 chars) */
+  char *end = str + 20;
+  char *p   = end;
+  do {*--p = '0' + (value % 10); value /= 10;} while (value != 0);
+  for (; *suffix != '\0'; suffix++) *end++ = *suffix;
+  append(p, end - p);
+}
+
+void stage4out_c::print_signed(long long value) {
+  if (value >= 0) {print_unsigned(value, ""); return;}
+  append("-", 1);
+  print_unsigned(-(unsigned long long)value, "");
+}
+
+
+void *stage4out_c::print(           std::string value) {if (!allow_output) return NULL; append(value.data(), value.size()); return NULL;}
+void *stage4out_c::print(           const char *value) {if (!allow_output) return NULL; append(value, strlen(value));       return NULL;}
 //void *stage4out_c::print(               int64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
 //void *stage4out_c::print(              uint64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(              real64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(                   int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(              long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(         long long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned           int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned      long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned long long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
+void *stage4out_c::print(                   int value) {if (!allow_output) return NULL; print_signed(value);       return NULL;}
+void *stage4out_c::print(              long int value) {if (!allow_output) return NULL; print_signed(value);       return NULL;}
+void *stage4out_c::print(         long long int value) {if (!allow_output) return NULL; print_signed(value);       return NULL;}
+void *stage4out_c::print(unsigned           int value) {if (!allow_output) return NULL; print_unsigned(value, ""); return NULL;}
+void *stage4out_c::print(unsigned      long int value) {if (!allow_output) return NULL; print_unsigned(value, ""); return NULL;}
+void *stage4out_c::print(unsigned long long int value) {if (!allow_output) return NULL; print_unsigned(value, ""); return NULL;}
+
+/* Same format as the default used by std::ostream (i.e. %g, with 6 significant digits) */
+void *stage4out_c::print(              real64_t value) {
+  if (!allow_output) return NULL;
+  char str[64];
+  int len = (sizeof(real64_t) == sizeof(double))? snprintf(str, sizeof(str), "%g",  (double)value)
+                                                : snprintf(str, sizeof(str), "%Lg", (long double)value);
+  append(str, len);
+  return NULL;
+}
 
 
 void *stage4out_c::print_long_integer(unsigned long l_integer, bool suffix) {
   if (!allow_output) return NULL;
-  *out << l_integer;
-  if (suffix) *out << "UL";
+  print_unsigned(l_integer, suffix? "UL" : "");
   return NULL;
 }
 
+
 void *stage4out_c::print_long_long_integer(unsigned long long ll_integer, bool suffix) {
   if (!allow_output) return NULL;
-  *out << ll_integer;
-  if (suffix) *out << "ULL";
+  print_unsigned(ll_integer, suffix? "ULL" : "");
   return NULL;
 }
 
 
+/* The following functions convert the string a chunk at a time, and then add the whole chunk to the output */
+#define CHUNK_SIZE 256
+
 void *stage4out_c::printupper(const char *str) {
   if (!allow_output) return NULL;
-  for (int i = 0; str[i] != '\0'; i++)
-    *out << (unsigned char)toupper(str[i]);
+  char chunk[CHUNK_SIZE];
+  while (*str != '\0') {
+    int i;
+    for (i = 0; (i < CHUNK_SIZE) && (str[i] != '\0'); i++)
+      chunk[i] = toupper((unsigned char)str[i]);
+    append(chunk, i);
+    str += i;
+  }
   return NULL;
 }
 
+
 void *stage4out_c::printlocation(const char *str) {
   if (!allow_output) return NULL;
-  *out << "__";
-  for (int i = 0; str[i] != '\0'; i++)
-    if(str[i] == '.')
-      *out << '_';
-    else
-      *out << (unsigned char)toupper(str[i]);
+  append("__", 2);
+  char chunk[CHUNK_SIZE];
+  while (*str != '\0') {
+    int i;
+    for (i = 0; (i < CHUNK_SIZE) && (str[i] != '\0'); i++)
+      chunk[i] = (str[i] == '.')? '_' : toupper((unsigned char)str[i]);
+    append(chunk, i);
+    str += i;
+  }
   return NULL;
 }
 
+
 void *stage4out_c::printlocation_comasep(const char *str) {
   if (!allow_output) return NULL;
-  *out << (unsigned char)toupper(str[0]);
-  *out << ',';
-  *out << (unsigned char)toupper(str[1]);
-  *out << ',';
-  for (int i = 2; str[i] != '\0'; i++)
-    if(str[i] == '.')
-      *out << ',';
-    else
-      *out << (unsigned char)toupper(str[i]);
+  char chunk[CHUNK_SIZE + 4];
+  chunk[0] = toupper((unsigned char)str[0]);
+  chunk[1] = ',';
+  chunk[2] = toupper((unsigned char)str[1]);
+  chunk[3] = ',';
+  append(chunk, 4);
+  str += 2;
+  while (*str != '\0') {
+    int i;
+    for (i = 0; (i < CHUNK_SIZE) && (str[i] != '\0'); i++)
+      chunk[i] = (str[i] == '.')? ',' : toupper((unsigned char)str[i]);
+    append(chunk, i);
+    str += i;
+  }
   return NULL;
 }
 
+#undef CHUNK_SIZE
 
 
 void *stage4out_c::printupper(std::string str) {
   if (!allow_output) return NULL;
-  /* The string standard class does not have a converter member function to upper case.
-   * We have to do it ourselves, a character at a time...
-   */
-#if 0
-  /* The C++ way of doint things... */
-  for (string::const_iterator p = str.begin(); p != str.end(); ++p)
-    *out << (unsigned char)toupper(*p);
-#else
-  /* Or more simply... */
-    printupper(str.c_str());
-#endif
-  return NULL;
+  return printupper(str.c_str());
 }
 
 
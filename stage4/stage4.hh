@@ -39,12 +39,28 @@
 #ifndef _STAGE4_HH
 #define _STAGE4_HH
 
+#include <string.h>  /* required for memcpy() */
+#include <vector>
 #include "../absyntax/absyntax.hh"
 
 
 void stage4err(const char *stage4_generator_id, symbol_c *symbol1, symbol_c *symbol2, const char *errmsg, ...);
 
 
+/* The output of stage 4 is stored in a (large) buffer, and only written out to the file
+ * when the buffer is full (or the file is flushed or closed), using a single write() system call.
+ *
+ * The output to stdout (i.e. when no file is given to the constructor) is not buffered here, as it
+ * must remain correctly ordered with all the other messages written to stdout.
+ *
+ * Optionally (see use_writev()), the whole contents of each file are kept in memory until the file
+ * is closed (or flushed), and then written out with a (single, unless the file is very large) writev()
+ * system call.
+ *
+ * Optionally (see keep_unchanged_files()), a file that already exists with the same contents
+ * is not written again (so its modification time does not change, and make does not rebuild what depends on it).
+ * The whole contents of the file are then kept in memory, and only compared and written out when the file is closed.
+ */
 class stage4out_c {
   public:
     std::string indent_level;
@@ -56,6 +72,16 @@ class stage4out_c {
     ~stage4out_c(void);
     
     void flush(void);
+
+    /* Keep the whole file in memory, and write it out with writev() when closed. Applies to files opened afterwards. */
+    static void use_writev(bool enable);
+    /* Do not rewrite a file that already exists with the same contents. Applies to files opened afterwards. */
+    static void keep_unchanged_files(bool enable);
+    /* Keep everything printed in memory (and never write it out), to be retrieved with contents(). Applies only to
+     * a stage4out_c constructed without a file, and must be called before anything is printed.
+     */
+    void keep_in_memory(void);
+    std::string contents(void);
     
     void enable_output(void);
     void disable_output(void);
@@ -88,9 +114,37 @@ class stage4out_c {
     void *printlocation_comasep(const char *str);
 
   protected:
-    std::ostream *out;
-    std::fstream *m_file;
-    
+    std::string filename;
+    std::string filepath;
+    int         fd;          /* the output file, or -1 when printing to stdout (or the file has not yet been opened) */
+    char       *buffer;      /* NULL when printing to stdout */
+    size_t      buffer_used;
+    size_t      buffer_size;
+    bool        writev_mode;
+    bool        in_memory;            /* see keep_in_memory() */
+    bool        keep_unchanged;       /* the file is only opened (and written out) when closed, and only if its contents changed */
+    std::vector<char *> full_buffers; /* in writev_mode, the buffers already filled up, and not yet written out */
+    static bool writev_default;
+    static bool keep_unchanged_default;
+
+    /* add len chars to the output */
+    void append(const char *str, size_t len) {
+      if (len <= buffer_size - buffer_used) {memcpy(buffer + buffer_used, str, len); buffer_used += len; return;}
+      append_slow(str, len);
+    }
+    void append_slow(const char *str, size_t len);
+    void write_out(const char *str, size_t len);
+    void open_file(void);
+    bool is_unchanged(void);
+    void print_unsigned(unsigned long long value, const char *suffix);
+    void print_signed  (         long long value);
+
+  private:
+    /* a stage4out_c owns its buffers, so it must never be copied */
+    stage4out_c(const stage4out_c &);
+    stage4out_c &operator=(const stage4out_c &);
+
+  protected:
     /* A flag to tell whether to really print to the file, or to ignore any request to print to the file */
     /* This is used to implement the no_code_generation pragmas, that lets the user tell the compiler
      * when to switch on and off the code generation, without stoping the lexical, syntatical, and
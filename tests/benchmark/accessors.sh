@@ -0,0 +1,103 @@
+#!/bin/bash
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Compare the cycle time of the code generated with the default accessors (that test the
+# force flag on each access to a variable), and with the production accessors (-O f option),
+# and the cost of the cycle time instrumentation (-O c option).
+#
+# The program controls a simulated plant with the function blocks of the examples of
+# Annex F of the standard (RAMP, PID, INTEGRAL, DERIVATIVE, LAG1 and HYSTERESIS). All but
+# LAG1 are also in the standard library (lib/*.txt), and are taken from there.
+#
+# usage: ./accessors.sh [<cycles>] [<program_instances>]
+
+IEC2C=../../iec2c
+LIBDIR=../../lib
+ANNEXF=../../AnnexF
+CYCLES=${1:-1000000}
+INSTANCES=${2:-8}
+CC=${CC:-gcc}
+INPUT=accessors_input.st
+OUTDIR=accessors.out
+
+if ! test -x $IEC2C; then echo "$IEC2C not found. Build the compiler first!"; exit 1; fi
+
+rm -rf $OUTDIR; mkdir -p $OUTDIR
+
+( cat $ANNEXF/lag1_st.txt; echo
+  cat <<END_OF_PROGRAM
+PROGRAM annexf_prg
+  VAR_EXTERNAL
+    SP : REAL;
+    PV : REAL;
+    OUT : BOOL;
+  END_VAR
+  VAR
+    N : INT;
+    RMP : RAMP;
+    CTRL : PID;
+    PLANT : LAG1;
+    HYST : HYSTERESIS;
+  END_VAR
+  N := N + 1;
+  IF N > 1000 THEN N := 0; END_IF;
+  RMP(RUN := N > 10, X0 := 0.0, X1 := 100.0, TR := T#500ms, CYCLE := T#1ms);
+  SP := RMP.XOUT;
+  CTRL(AUTO := TRUE, PV := PV, SP := SP, X0 := 0.0, KP := 0.8, TR := 2.0, TD := 0.1, CYCLE := T#1ms);
+  PLANT(RUN := N > 1, XIN := CTRL.XOUT, TAU := T#100ms, CYCLE := T#1ms);
+  PV := PLANT.XOUT;
+  HYST(XIN1 := PV, XIN2 := SP, EPS := 0.5);
+  OUT := HYST.Q;
+END_PROGRAM
+
+CONFIGURATION annexf_cfg
+  VAR_GLOBAL
+    SP, PV : REAL;
+    OUT AT %QX0.0 : BOOL;
+  END_VAR
+  RESOURCE annexf_res ON PLC
+    TASK annexf_task(INTERVAL := T#1ms, PRIORITY := 0);
+END_OF_PROGRAM
+  for i in `seq $INSTANCES`; do echo "    PROGRAM inst$i WITH annexf_task : annexf_prg;"; done
+  echo "  END_RESOURCE"
+  echo "END_CONFIGURATION"
+) > $INPUT
+
+# build the benchmark for the code generated with the extra iec2c options passed as arguments.
+build() {
+  local dir=$OUTDIR/$1; shift
+  mkdir -p $dir
+  $IEC2C -I $LIBDIR -T $dir "$@" $INPUT > /dev/null || exit 1
+  local objs=""
+  for f in $dir/*.c; do
+    # POUS.c is included by the resource file
+    if test `basename $f` = POUS.c; then continue; fi
+    $CC -O2 -I $LIBDIR/C -c $f -o $f.o || exit 1
+    objs="$objs $f.o"
+  done
+  $CC -O2 -I $LIBDIR/C -I $dir accessors_bench.c $objs -lm -o $dir/bench || exit 1
+}
+
+build default
+build production -O f
+build profiled -O c
+
+echo "$INSTANCES instances of a program using the Annex F function blocks, $CYCLES cycles:"
+echo -n "  default accessors          : "; $OUTDIR/default/bench $CYCLES
+echo -n "  production accessors (-O f): "; $OUTDIR/production/bench $CYCLES
+echo -n "  instrumented (-O c)        : "; $OUTDIR/profiled/bench $CYCLES
@@ -0,0 +1,83 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * Minimal runtime that runs the configuration generated by iec2c for a given
+ * number of (simulated) 1 ms cycles, and prints the time per cycle.
+ * Used by accessors.sh to compare the default and the production (-O f) accessors.
+ *
+ * usage: accessors_bench <cycles>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "iec_std_lib.h"
+
+
+/* Functions provided by the generated code */
+void config_run__(unsigned long tick);
+void config_init__(void);
+
+/* Variables used by the generated code */
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+#define __LOCATED_VAR(type, name, ...) type __##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+#define __LOCATED_VAR(type, name, ...) type* name = &__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+int main(int argc, char **argv) {
+  long cycles, i, checksum = 0;
+  double start;
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <cycles>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  cycles = atol(argv[1]);
+
+  config_init__();
+  start = now();
+  for (i = 0; i < cycles; i++) {
+    __CURRENT_TIME = __time_from_sec_nsec(TIME, i / 1000, (i % 1000) * 1000000);
+    config_run__(i);
+#define __LOCATED_VAR(type, name, ...) checksum += (long)__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+  }
+  printf("%7.2f ns/cycle  (checksum %ld)\n", (now() - start) * 1e9 / cycles, checksum);
+  return EXIT_SUCCESS;
+}
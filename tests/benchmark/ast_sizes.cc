@@ -0,0 +1,67 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * Print the size (in bytes) of each class of the abstract syntax tree.
+ *
+ * Compile with and without -DINLINE_ANNOTATIONS to compare the
+ * size of the nodes with the annotations stored inline and lazily allocated
+ * (see absyntax/lazy_annotation.hh). 'make astsizes' does just that.
+ *
+ * usage: ast_sizes
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../absyntax/absyntax.hh"
+
+
+int main(int argc, char **argv) {
+  printf("%s %lu\n", "symbol_c", (unsigned long)sizeof(symbol_c));
+  printf("%s %lu\n", "token_c",  (unsigned long)sizeof(token_c));
+  printf("%s %lu\n", "list_c",   (unsigned long)sizeof(list_c));
+
+  #define SYM_LIST(class_name_c, ...)                                     printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+  #define SYM_TOKEN(class_name_c, ...)                                    printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+  #define SYM_REF0(class_name_c, ...)                                     printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+  #define SYM_REF1(class_name_c, ref1, ...)                               printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+  #define SYM_REF2(class_name_c, ref1, ref2, ...)                         printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+  #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                   printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+  #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)             printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+  #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)       printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+  #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...) printf("%s %lu\n", #class_name_c, (unsigned long)sizeof(class_name_c));
+
+  #include "../../absyntax/absyntax.def"
+
+  #undef SYM_LIST
+  #undef SYM_TOKEN
+  #undef SYM_REF0
+  #undef SYM_REF1
+  #undef SYM_REF2
+  #undef SYM_REF3
+  #undef SYM_REF4
+  #undef SYM_REF5
+  #undef SYM_REF6
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,85 @@
+#!/bin/bash
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Compare the peak memory used by two builds of iec2c when compiling the
+# AnnexF examples and a large synthetic project.
+# The AST memory is most of the memory used by iec2c, so this is mostly
+# a comparison of the layout of the AST nodes, e.g. of a build with
+#    make CXXFLAGS="-DINLINE_ANNOTATIONS -DNO_AST_ARENA"
+# (the previous layout) against the default build.
+#
+# usage: ./astmem.sh <other_iec2c> [<synthetic_pou_count>]
+#   (defaults to 2000 function blocks in the synthetic project)
+
+IEC2C=../../iec2c
+OTHER=$1
+POUS=${2:-2000}
+LIBDIR=../../lib
+ANNEXF=../../AnnexF
+INPUT=astmem_input.st
+OUTDIR=astmem.out
+TIME=/usr/bin/time
+
+if ! test -x $IEC2C;  then echo "$IEC2C not found. Build the compiler first!"; exit 1; fi
+if ! test -x "$OTHER"; then echo "usage: $0 <other_iec2c> [<synthetic_pou_count>]"; exit 1; fi
+if ! test -x $TIME;   then echo "$TIME (GNU time) not found."; exit 1; fi
+
+# The synthetic project: POUS function blocks with some declarations and ST code,
+# each instantiated by a single program.
+( for i in `seq $POUS`; do
+    echo "FUNCTION_BLOCK fb_$i"
+    echo "  VAR_INPUT  in1, in2 : INT; en1 : BOOL; END_VAR"
+    echo "  VAR_OUTPUT out1 : INT; out2 : REAL; END_VAR"
+    echo "  VAR t : TON; acc : REAL := 1.5; k : INT := $i; END_VAR"
+    echo "  t(IN := en1, PT := T#100ms);"
+    echo "  IF t.Q AND (in1 > in2) THEN out1 := in1 - in2 + k * 2; ELSE out1 := MAX(in1, in2) / 2; END_IF;"
+    echo "  acc := acc + INT_TO_REAL(out1) * 0.5;"
+    echo "  FOR k := 1 TO 10 BY 1 DO acc := acc * 0.9 + 1.0; END_FOR;"
+    echo "  out2 := acc;"
+    echo "END_FUNCTION_BLOCK"
+    echo
+  done
+  echo "PROGRAM main_prg"
+  echo "  VAR x : INT; y : REAL; END_VAR"
+  for i in `seq $POUS`; do echo "  VAR i_$i : fb_$i; END_VAR"; done
+  for i in `seq $POUS`; do echo "  i_$i(in1 := x, in2 := $i, en1 := TRUE, out1 => x, out2 => y);"; done
+  echo "END_PROGRAM"
+  echo
+  echo "CONFIGURATION main_cfg"
+  echo "  RESOURCE main_res ON PLC"
+  echo "    TASK main_task(INTERVAL := T#10ms, PRIORITY := 0);"
+  echo "    PROGRAM main_inst WITH main_task : main_prg;"
+  echo "  END_RESOURCE"
+  echo "END_CONFIGURATION"
+) > $INPUT
+
+rm -rf $OUTDIR; mkdir -p $OUTDIR
+
+# peak resident memory (in KB) used to compile a file, with the given compiler
+peak() {
+  $TIME -f %M -o $OUTDIR/time.tmp $1 -I $LIBDIR -T $OUTDIR $2 > /dev/null 2>&1 || { echo "compilation of $2 failed!" >&2; }
+  cat $OUTDIR/time.tmp | tail -1
+}
+
+echo "peak resident memory (KB)"
+printf "  %-30s %12s %12s\n" "input file" "$OTHER" "$IEC2C"
+for f in $ANNEXF/*_st.txt $ANNEXF/*_il.txt $INPUT; do
+  printf "  %-30s %12s %12s\n" `basename $f` `peak $OTHER $f` `peak $IEC2C $f`
+done
+
+rm -rf $OUTDIR $INPUT
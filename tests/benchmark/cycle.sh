@@ -0,0 +1,206 @@
+#!/bin/bash
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Cycle time benchmark of the code generated by iec2c (and of the runtime library), run on a simulated
+# clock by cycle_bench.c: throughput (cycles/s), latency percentiles, and the cost of each program.
+#
+# The corpus is a configuration with a single resource, with three tasks, each running <program_instances>
+# instances of:
+#   control : a simulated control loop with the Annex F function blocks (RAMP, PID, LAG1, AVERAGE,
+#             DELAY, TRANSFER, INTEGRAL, DERIVATIVE and HYSTERESIS);
+#   logic   : discrete logic with the Annex F function blocks (FWD_REV_MON, CMD_MONITOR, STACK_INT)
+#             and the WEIGH function;
+#   stdfb   : the other function blocks of the standard library (timers, counters, edge detection,
+#             bistables, SEMA and RTC).
+# The Annex F function blocks that are also in the standard library (lib/*.txt) are taken from there.
+#
+# The code is generated and built with the extra iec2c options given after the number of instances
+# (e.g. -O f), and once more with the cycle time instrumentation (-O c), to print the cost of each
+# program instance and POU (the cost of each task is that of its program, control_prg, logic_prg or stdfb_prg).
+#
+# usage: ./cycle.sh [<cycles> [<program_instances> [<iec2c options> ...]]]
+#   (defaults to 1000000 cycles and 4 instances of each program)
+
+IEC2C=../../iec2c
+LIBDIR=../../lib
+ANNEXF=../../AnnexF
+CYCLES=${1:-1000000}
+INSTANCES=${2:-4}
+shift $(( $# < 2 ? $# : 2 ))
+CC=${CC:-gcc}
+INPUT=cycle_input.st
+OUTDIR=cycle.out
+
+if ! test -x $IEC2C; then echo "$IEC2C not found. Build the compiler first!"; exit 1; fi
+
+rm -rf $OUTDIR; mkdir -p $OUTDIR
+
+# The Annex F sources need a few fixes before they compile with iec2c:
+#   delay_st     : the ';' missing after the declaration of N;
+#   average_st   : the INT N is mixed with REALs, without a conversion;
+#   stack_int_st : R_EDGE inputs are not supported (so PUSH and POP act on their level, not on their rising edge);
+#   weigh_st     : there is no signed INT_TO_BCD (nor BCD_TO_INT), so use the UINT ones.
+annexf() {
+  case $1 in
+    delay_st)     sed 's/^\( *N *: INT\) \( *(\*\)/\1;\2/' $ANNEXF/$1.txt;;
+    average_st)   sed 's/SUM\/N ;/SUM\/INT_TO_REAL(N) ;/; s/SUM := N\*XIN/SUM := INT_TO_REAL(N)*XIN/' $ANNEXF/$1.txt;;
+    stack_int_st) sed 's/BOOL R_EDGE/BOOL/' $ANNEXF/$1.txt;;
+    weigh_st)     sed 's/INT_TO_BCD (BCD_TO_INT(gross_weight) - tare_weight)/UINT_TO_BCD_WORD(BCD_TO_UINT(gross_weight) - INT_TO_UINT(tare_weight))/' $ANNEXF/$1.txt;;
+    *)            cat $ANNEXF/$1.txt;;
+  esac
+}
+
+( for f in lag1_st delay_st average_st transfer_st cmd_monitor_st fwd_rev_mon_st stack_int_st weigh_st; do annexf $f; echo; done
+  cat <<END_OF_PROGRAM
+PROGRAM control_prg
+  VAR_EXTERNAL
+    PV : REAL;
+    ALARM : BOOL;
+  END_VAR
+  VAR
+    N : INT;
+    SP, FILTERED : REAL;
+    RMP : RAMP;
+    CTRL : PID;
+    PLANT : LAG1;
+    FILTER : AVERAGE;
+    XFER : TRANSFER;
+    TOTAL : INTEGRAL;
+    RATE : DERIVATIVE;
+    LIMIT_HI : HYSTERESIS;
+  END_VAR
+  N := N + 1;
+  IF N > 2000 THEN N := 0; END_IF;
+  RMP(RUN := N > 10, X0 := 0.0, X1 := 100.0, TR := T#500ms, CYCLE := T#1ms);
+  XFER(AUTO := N < 1000, XIN := RMP.XOUT, FAST_RATE := 10.0, SLOW_RATE := 1.0,
+       FAST_UP := N > 1500, SLOW_UP := N > 1200, FAST_DOWN := FALSE, SLOW_DOWN := N > 1800, CYCLE := T#1ms);
+  SP := XFER.XOUT;
+  CTRL(AUTO := TRUE, PV := FILTERED, SP := SP, X0 := 0.0, KP := 0.8, TR := 2.0, TD := 0.1, CYCLE := T#1ms);
+  PLANT(RUN := N > 1, XIN := CTRL.XOUT, TAU := T#100ms, CYCLE := T#1ms);
+  FILTER(RUN := N > 1, XIN := PLANT.XOUT, N := 16);
+  FILTERED := FILTER.XOUT;
+  TOTAL(RUN := TRUE, R1 := N = 0, XIN := FILTERED, X0 := 0.0, CYCLE := T#1ms);
+  RATE(RUN := N > 1, XIN := FILTERED, CYCLE := T#1ms);
+  LIMIT_HI(XIN1 := FILTERED, XIN2 := SP, EPS := 0.5);
+  PV := FILTERED;
+  ALARM := LIMIT_HI.Q OR (ABS(RATE.XOUT) > 1000.0);
+END_PROGRAM
+
+PROGRAM logic_prg
+  VAR_EXTERNAL
+    MOTOR : BOOL;
+    WEIGHT : INT;
+  END_VAR
+  VAR
+    N : INT;
+    MON : FWD_REV_MON;
+    VALVE : CMD_MONITOR;
+    STK : STACK_INT;
+  END_VAR
+  N := N + 1;
+  IF N > 1000 THEN N := 0; END_IF;
+  MON(AUTO := N > 100, ACK := N = 999, AUTO_FWD := (N MOD 200) < 90, MAN_FWD := FALSE, MAN_FWD_CHK := TRUE,
+      T_FWD_MAX := T#50ms, FWD_FDBK := (N MOD 200) > 20, AUTO_REV := (N MOD 200) > 110, MAN_REV := FALSE,
+      MAN_REV_CHK := TRUE, T_REV_MAX := T#50ms, REV_FDBK := (N MOD 200) > 130);
+  VALVE(AUTO_CMD := (N MOD 50) < 25, AUTO_MODE := TRUE, MAN_CMD := FALSE, MAN_CMD_CHK := TRUE,
+        T_CMD_MAX := T#20ms, FDBK := (N MOD 50) > 5, ACK := N = 0);
+  STK(PUSH := (N MOD 3) = 0, POP := (N MOD 5) = 0, R1 := N = 0, IN := N, N := 64);
+  MOTOR := MON.FWD_CMD OR MON.REV_CMD OR VALVE.CMD;
+  WEIGHT := WORD_TO_INT(WEIGH(weigh_command := NOT STK.EMPTY, gross_weight := 16#0950, tare_weight := STK.OUT MOD 100));
+END_PROGRAM
+
+PROGRAM stdfb_prg
+  VAR_EXTERNAL
+    COUNT : DINT;
+  END_VAR
+  VAR
+    N : INT;
+    CLK, PULSE : BOOL;
+    T_ON : TON; T_OFF : TOF; T_P : TP;
+    UP : CTU; DOWN : CTD; UPDOWN : CTUD;
+    RISE : R_TRIG; FALL : F_TRIG;
+    SET1 : SR; RESET1 : RS;
+    LOCK : SEMA;
+    CLOCK : RTC;
+  END_VAR
+  N := N + 1;
+  IF N > 100 THEN N := 0; END_IF;
+  CLK := N < 50;
+  T_ON(IN := CLK, PT := T#20ms);
+  T_OFF(IN := CLK, PT := T#20ms);
+  T_P(IN := CLK, PT := T#10ms);
+  RISE(CLK := CLK);
+  FALL(CLK := CLK);
+  PULSE := RISE.Q OR FALL.Q;
+  UP(CU := PULSE, R := N = 0, PV := 100);
+  DOWN(CD := PULSE, LD := N = 0, PV := 100);
+  UPDOWN(CU := RISE.Q, CD := FALL.Q, R := FALSE, LD := N = 0, PV := 10);
+  SET1(S1 := T_ON.Q, R := T_P.Q);
+  RESET1(S := T_OFF.Q, R1 := UP.Q);
+  LOCK(CLAIM := SET1.Q1, RELEASE := RESET1.Q1);
+  CLOCK(IN := N = 0, PDT := DT#2000-01-01-00:00:00);
+  COUNT := COUNT + INT_TO_DINT(UP.CV) + INT_TO_DINT(DOWN.CV) + BOOL_TO_DINT(LOCK.BUSY);
+END_PROGRAM
+
+CONFIGURATION cycle_cfg
+  VAR_GLOBAL
+    PV     AT %QD0 : REAL;
+    ALARM  AT %QX1.0 : BOOL;
+    MOTOR  AT %QX1.1 : BOOL;
+    WEIGHT AT %QW2 : INT;
+    COUNT  AT %QD3 : DINT;
+  END_VAR
+  RESOURCE cycle_res ON PLC
+END_OF_PROGRAM
+  for prg in control logic stdfb; do
+    echo "    TASK ${prg}_task(INTERVAL := T#1ms, PRIORITY := 0);"
+  done
+  for prg in control logic stdfb; do
+    for i in `seq $INSTANCES`; do echo "    PROGRAM ${prg}$i WITH ${prg}_task : ${prg}_prg;"; done
+  done
+  echo "  END_RESOURCE"
+  echo "END_CONFIGURATION"
+) > $INPUT
+
+# build the benchmark for the code generated with the iec2c options (and the extra C flags, after --) passed as arguments.
+build() {
+  local dir=$OUTDIR/$1; shift
+  local cflags=""
+  local options=""
+  while test $# -gt 0 && test "$1" != "--"; do options="$options $1"; shift; done
+  if test "$1" = "--"; then shift; cflags="$*"; fi
+  mkdir -p $dir
+  $IEC2C -I $LIBDIR -T $dir $options $INPUT > /dev/null || exit 1
+  local objs=""
+  for f in $dir/*.c; do
+    # POUS.c is included by the (first) resource file
+    if test `basename $f` = POUS.c; then continue; fi
+    $CC -O2 -I $LIBDIR/C $cflags -c $f -o $f.o || exit 1
+    objs="$objs $f.o"
+  done
+  $CC -O2 -I $LIBDIR/C -I $dir $cflags cycle_bench.c $objs -lm -o $dir/bench || exit 1
+}
+
+build plain   "$@"
+build profile "$@" -O c -- -DCYCLE_BENCH_PROFILE
+
+echo "3 tasks of $INSTANCES program instances each (iec2c options:${*:- none}):"
+$OUTDIR/plain/bench $CYCLES || exit 1
+echo
+echo "with the cycle time instrumentation (-O c):"
+$OUTDIR/profile/bench $CYCLES || exit 1
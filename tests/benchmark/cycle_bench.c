@@ -0,0 +1,196 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * Runtime that runs the configuration generated by iec2c as fast as possible, on a simulated clock:
+ * each cycle advances __CURRENT_TIME by common_ticktime__, whatever the time the cycle really took.
+ * Used by cycle.sh to measure the cost of the generated code (and of the runtime library) in
+ * a way that does not depend on any real time timer.
+ *
+ * The configuration is first run for <cycles> cycles back to back, to measure the throughput,
+ * and then for another <cycles> cycles timing each one, to measure the latency percentiles
+ * (these include the cost of reading the clock, which is also printed).
+ *
+ * When the code was generated with the cycle time instrumentation (iec2c -O c), build with
+ * -DCYCLE_BENCH_PROFILE to also print the cost of each resource, program instance and POU
+ * (from __iec_profile_table[], see iec_profile.h). This instrumentation slows down the
+ * code, so the throughput and latency of such a build are not comparable with the others.
+ *
+ * usage: cycle_bench <cycles>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The generated POUS.h defines the variant of the standard library (e.g. IEC_TIME_INT64) the code
+ * was generated for, before including iec_std_lib.h (and iec_profile.h, with -O c).
+ */
+#include "POUS.h"
+
+
+/* Functions and variables provided by the generated code */
+void config_run__(unsigned long tick);
+void config_init__(void);
+extern unsigned long long common_ticktime__;
+
+/* Variables used by the generated code */
+#ifdef IEC_RESOURCE_THREADS
+/* __CURRENT_TIME, and the functions that lock the global variables (no thread is started: the
+ * main thread runs the configuration, with config_run__())
+ */
+#include "iec_threads.h"
+#else
+TIME __CURRENT_TIME;
+#endif
+BOOL __DEBUG;
+
+#define __LOCATED_VAR(type, name, ...) type __##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+#define __LOCATED_VAR(type, name, ...) type* name = &__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+
+
+static unsigned long tick = 0;
+
+/* run one cycle, on the simulated clock */
+static inline void cycle(void) {
+  unsigned long long ns = tick * common_ticktime__;
+  __CURRENT_TIME = __time_from_sec_nsec(TIME, ns / 1000000000ULL, ns % 1000000000ULL);
+  config_run__(tick++);
+}
+
+static inline unsigned long long now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int compare(const void *a, const void *b) {
+  unsigned int x = *(const unsigned int *)a, y = *(const unsigned int *)b;
+  return (x > y) - (x < y);
+}
+
+static unsigned int percentile(const unsigned int *sorted, long count, double p) {
+  long i = (long)(p / 100.0 * count);
+  return sorted[(i < count)? i : count - 1];
+}
+
+
+#ifdef CYCLE_BENCH_PROFILE
+/* In __iec_profile_table[] each resource is followed by its program instances (named <RESOURCE>.<INSTANCE>) */
+static int is_resource(__IEC_PROFILE_t *const *counter) {
+  size_t len = strlen((*counter)->name);
+  return (NULL != counter[1]) && (strncmp(counter[1]->name, (*counter)->name, len) == 0) && (counter[1]->name[len] == '.');
+}
+
+static void print_counter(const char *indent, __IEC_PROFILE_t *counter, long cycles, double cycle_ns) {
+  double mean = (counter->count > 0)? (double)counter->total / counter->count : 0.0;
+  printf("  %s%-*s %12llu %10.1f %10llu %10llu %6.1f%%\n", indent, 30 - (int)strlen(indent), counter->name,
+         counter->count, mean, (counter->count > 0)? counter->min : 0, counter->max,
+         100.0 * counter->total / cycles / cycle_ns);
+}
+
+static void print_profile(long cycles) {
+  __IEC_PROFILE_t *const *counter;
+  double cycle_ns = 0.0;
+
+  for (counter = __iec_profile_table; NULL != *counter; counter++)
+    if (is_resource(counter)) cycle_ns += (double)(*counter)->total / cycles;
+
+  printf("cost of each resource, program instance and POU type (-O c), over all the %ld cycles:\n", cycles);
+  printf("  %-30s %12s %10s %10s %10s %7s\n", "", "calls", "mean (ns)", "min (ns)", "max (ns)", "cycle");
+  for (counter = __iec_profile_table; NULL != *counter; counter++) {
+    if (!is_resource(counter)) continue;
+    print_counter("", *counter, cycles, cycle_ns);
+    for (counter++; (NULL != *counter) && (strchr((*counter)->name, '.') != NULL); counter++)
+      print_counter("  ", *counter, cycles, cycle_ns);
+    counter--;
+  }
+  for (counter = __iec_profile_table; NULL != *counter; counter++)
+    if ((strchr((*counter)->name, '.') == NULL) && !is_resource(counter))
+      print_counter("POU ", *counter, cycles, cycle_ns);
+}
+#endif
+
+
+int main(int argc, char **argv) {
+  long cycles, i, checksum = 0;
+  unsigned long long start, end, overhead;
+  unsigned int *latency;
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <cycles>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  cycles  = atol(argv[1]);
+  latency = (unsigned int *)malloc(cycles * sizeof(unsigned int));
+  if ((cycles <= 0) || (NULL == latency)) {
+    fprintf(stderr, "invalid number of cycles: %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  config_init__();
+  for (i = 0; i < 1000; i++) cycle();  /* warm up */
+#ifdef CYCLE_BENCH_PROFILE
+  __iec_profile_reset();
+#endif
+
+  /* throughput */
+  start = now();
+  for (i = 0; i < cycles; i++) cycle();
+  end = now();
+
+  /* latency */
+  for (i = 0; i < cycles; i++) {
+    unsigned long long t = now();
+    cycle();
+    latency[i] = (unsigned int)(now() - t);
+  }
+  qsort(latency, cycles, sizeof(unsigned int), compare);
+
+  /* cost of reading the clock twice, included in each latency */
+  overhead = now();
+  for (i = 0; i < 1000; i++) now();
+  overhead = (now() - overhead) / 1000 * 2;
+
+#define __LOCATED_VAR(type, name, ...) checksum += (long)__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+
+  printf("%ld cycles of %llu ns (simulated)\n", cycles, common_ticktime__);
+  printf("  throughput   : %12.0f cycles/s  (%.1f ns/cycle)\n",
+         cycles * 1e9 / (end - start), (double)(end - start) / cycles);
+  printf("  latency (ns) : p50 %u  p90 %u  p99 %u  p99.9 %u  max %u  (clock overhead ~%llu ns)\n",
+         percentile(latency, cycles, 50), percentile(latency, cycles, 90), percentile(latency, cycles, 99),
+         percentile(latency, cycles, 99.9), latency[cycles - 1], overhead);
+  printf("  checksum     : %ld\n", checksum);
+#ifdef CYCLE_BENCH_PROFILE
+  print_profile(2 * cycles);
+#endif
+  free(latency);
+  return EXIT_SUCCESS;
+}
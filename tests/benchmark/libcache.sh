@@ -0,0 +1,80 @@
+#!/bin/bash
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Compare the startup time of iec2c with and without the standard library cache (-L option).
+#
+# usage: ./libcache.sh [<runs>] [<input_file>]
+#   (defaults to 50 runs over a small program that only uses the standard library)
+
+IEC2C=../../iec2c
+LIBDIR=../../lib
+RUNS=${1:-50}
+INPUT=${2:-libcache_input.st}
+CACHEDIR=libcache.tmp
+OUTDIR=libcache.out
+
+if ! test -x $IEC2C; then echo "$IEC2C not found. Build the compiler first!"; exit 1; fi
+
+if ! test -f $INPUT; then
+cat > $INPUT <<END_OF_INPUT
+PROGRAM bench_prg
+  VAR
+    t : TON;
+    c : CTU;
+    x : INT;
+  END_VAR
+  t(IN := TRUE, PT := T#1s);
+  c(CU := t.Q, PV := 10);
+  x := MAX(x, 1) + ABS(-2);
+END_PROGRAM
+
+CONFIGURATION bench_cfg
+  RESOURCE bench_res ON PLC
+    TASK bench_task(INTERVAL := T#10ms, PRIORITY := 0);
+    PROGRAM bench_inst WITH bench_task : bench_prg;
+  END_RESOURCE
+END_CONFIGURATION
+END_OF_INPUT
+fi
+
+rm -rf $CACHEDIR $OUTDIR; mkdir -p $CACHEDIR $OUTDIR
+
+# time <runs> compilations, with the extra options passed as arguments. Prints the average in ms.
+run() {
+  local start=`date +%s%N`
+  for i in `seq $RUNS`; do
+    $IEC2C "$@" -I $LIBDIR -T $OUTDIR $INPUT > /dev/null || { echo "compilation failed!"; exit 1; }
+  done
+  local end=`date +%s%N`
+  echo $(( (end - start) / RUNS / 1000 ))
+}
+
+# fill in the cache
+$IEC2C -L $CACHEDIR -I $LIBDIR -T $OUTDIR $INPUT > /dev/null || { echo "compilation failed!"; exit 1; }
+
+nocache=`run`
+cache=`run -L $CACHEDIR`
+nocache_p=`run -p`
+cache_p=`run -p -L $CACHEDIR`
+
+echo "average time per compilation of $INPUT ($RUNS runs)"
+echo "                   without cache    with cache (-L)"
+printf "  normal parsing : %10d us    %10d us\n" $nocache   $cache
+printf "  pre-parsing -p : %10d us    %10d us\n" $nocache_p $cache_p
+
+rm -rf $CACHEDIR $OUTDIR
@@ -0,0 +1,105 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * Benchmark of the overhead of the cycle time instrumentation (iec2c -O c, see lib/C/iec_profile.h).
+ *
+ * Calls the body of a small function block, as generated by iec2c, without and with
+ * the instrumentation, and prints the extra time per call.
+ * Build with -DIEC_PROFILE_RDTSC to have the instrumentation read the time stamp counter.
+ *
+ * usage: profile_bench <calls>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "iec_std_lib.h"
+#include "iec_profile.h"
+
+
+TIME __CURRENT_TIME;
+
+typedef struct {
+  __DECLARE_VAR(BOOL,EN)
+  __DECLARE_VAR(BOOL,ENO)
+  __DECLARE_VAR(DINT,IN)
+  __DECLARE_VAR(DINT,OUT)
+} COUNTER;
+
+__DECLARE_PROFILE(COUNTER, "COUNTER")
+__IEC_PROFILE_t *const __iec_profile_table[] = {&COUNTER__profile, NULL};
+
+
+__attribute__((noinline)) void COUNTER_body__(COUNTER *data__) {
+  __SET_VAR(data__->,OUT,,__GET_VAR(data__->OUT,) + __GET_VAR(data__->IN,));
+  goto __end;
+
+__end:
+  return;
+}
+
+__attribute__((noinline)) void COUNTER_profiled_body__(COUNTER *data__) {
+  __IEC_PROFILE_BEGIN
+  __SET_VAR(data__->,OUT,,__GET_VAR(data__->OUT,) + __GET_VAR(data__->IN,));
+  goto __end;
+
+__end:
+  __IEC_PROFILE_END(COUNTER)
+  return;
+}
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+int main(int argc, char **argv) {
+  COUNTER fb;
+  long calls, i;
+  double start, plain, profiled;
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <calls>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  calls = atol(argv[1]);
+  memset(&fb, 0, sizeof(fb));
+  fb.IN.value = 1;
+
+  start = now();
+  for (i = 0; i < calls; i++) COUNTER_body__(&fb);
+  plain = (now() - start) * 1e9 / calls;
+
+  start = now();
+  for (i = 0; i < calls; i++) COUNTER_profiled_body__(&fb);
+  profiled = (now() - start) * 1e9 / calls;
+
+  printf("%7.2f ns/call, %7.2f ns/call instrumented: %6.2f ns overhead  (%llu calls, min %llu, max %llu, checksum %d)\n",
+         plain, profiled, profiled - plain, COUNTER__profile.count, COUNTER__profile.min, COUNTER__profile.max, fb.OUT.value);
+  return EXIT_SUCCESS;
+}
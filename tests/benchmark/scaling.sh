@@ -0,0 +1,129 @@
+#!/bin/bash
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Measure how the time and memory used by each compiler pass grow with the size of the input,
+# on the synthetic projects generated by synth_gen.sh, to find the passes that do not scale linearly.
+#
+# Each series compiles projects of increasing size along a single dimension (the others are fixed):
+#   pous     : number of function blocks      (POUS_LIST,     with 20 variables each)
+#   vars     : variables per function block   (VARS_LIST,     with 100 function blocks)
+#   sfc      : steps of the SFC program       (STEPS_LIST,    with 10 function blocks of 5 variables)
+#   case     : branches of each CASE          (BRANCHES_LIST, with 10 function blocks of 5 variables)
+# and prints, for each pass (as reported by iec2c -t), its time for each size, and its growth
+# exponent between the two largest sizes (time ~ size^exponent), i.e. ~1 for a pass that scales
+# linearly and ~2 for a quadratic one. Passes that grow faster than MAX_EXPONENT (and take
+# at least MIN_MS at the largest size) are flagged.
+#
+# The JSON reports of iec2c are kept in scaling.out/<series>_<size>.json (e.g. to track them in CI).
+#
+# usage: ./scaling.sh [<series> ...]
+#   (defaults to all the series; the sizes may be changed with the *_LIST environment variables)
+
+IEC2C=../../iec2c
+LIBDIR=../../lib
+OUTDIR=scaling.out
+POUS_LIST=${POUS_LIST:-"125 250 500 1000 2000"}
+VARS_LIST=${VARS_LIST:-"10 20 40 80 160"}
+STEPS_LIST=${STEPS_LIST:-"100 200 400 800 1600"}
+BRANCHES_LIST=${BRANCHES_LIST:-"50 100 200 400 800"}
+MAX_EXPONENT=${MAX_EXPONENT:-1.3}
+MIN_MS=${MIN_MS:-10}
+SERIES=${@:-pous vars sfc case}
+
+if ! test -x $IEC2C; then echo "$IEC2C not found. Build the compiler first!"; exit 1; fi
+
+rm -rf $OUTDIR; mkdir -p $OUTDIR
+
+# compile the synthetic project generated with the given synth_gen.sh arguments, writing the report to $1
+compile() {
+  local report=$1; shift
+  ./synth_gen.sh "$@" > $OUTDIR/input.st || exit 1
+  rm -rf $OUTDIR/c; mkdir -p $OUTDIR/c
+  $IEC2C -t $report -I $LIBDIR -T $OUTDIR/c $OUTDIR/input.st > /dev/null || { echo "compilation failed!"; exit 1; }
+}
+
+# print the table of a series, from the reports of each size (in increasing order)
+table() {
+  local sizes=$1; shift
+  awk -v sizes="$sizes" -v max_exp=$MAX_EXPONENT -v min_ms=$MIN_MS '
+    function add(name, value) {
+      if (!(name in seen)) {seen[name] = 1; order[++rows] = name}
+      val[name, f] = value
+    }
+    FNR == 1 {f++}
+    /"name":/ {
+      name = $0;  sub(/.*"name": "/, "", name); sub(/".*/, "", name)
+      depth = $0; sub(/.*"depth": /, "", depth); sub(/,.*/, "", depth)
+      ms = $0;    sub(/.*"wall_ms": /, "", ms);  sub(/,.*/, "", ms)
+      indent[name] = depth
+      add(name, ms)
+    }
+    /"total":/ {
+      ms = $0;  sub(/.*"wall_ms": /, "", ms);     sub(/,.*/, "", ms)
+      rss = $0; sub(/.*"peak_rss_kb": /, "", rss); sub(/}.*/, "", rss)
+      add("total (ms)", ms); add("peak RSS (kB)", rss)
+    }
+    /"ast_nodes_total":/ {
+      n = $0; sub(/.*: /, "", n)
+      add("AST nodes", n)
+    }
+    END {
+      n = split(sizes, size, " ")
+      printf "  %-44s", ""
+      for (i = 1; i <= n; i++) printf " %10s", size[i]
+      printf " %8s\n", "growth"
+      for (r = 1; r <= rows; r++) {
+        name = order[r]
+        label = name; sub(/.*\//, "", label)
+        printf "  %-44s", sprintf("%*s%s", 2 * indent[name], "", label)
+        for (i = 1; i <= n; i++) printf " %10s", val[name, i]
+        a = val[name, n-1]; b = val[name, n]
+        if ((n > 1) && (a > 0) && (b > 0)) {
+          e = log(b / a) / log(size[n] / size[n-1])
+          printf " %8.2f", e
+          if ((e > max_exp) && ((name ~ /^[A-Z]/) || (b >= min_ms))) printf "  <== superlinear"
+        }
+        printf "\n"
+      }
+    }' "$@"
+}
+
+# run a series: series <name> <description> <sizes> <synth_gen.sh arguments, with SIZE standing for each size>
+series() {
+  local name=$1 description=$2 sizes=$3; shift 3
+  local reports=""
+  for size in $sizes; do
+    compile $OUTDIR/${name}_$size.json `echo "$@" | sed "s/SIZE/$size/"`
+    reports="$reports $OUTDIR/${name}_$size.json"
+  done
+  echo
+  echo "$description:"
+  table "$sizes" $reports
+}
+
+for s in $SERIES; do
+  case $s in
+    pous) series pous "wall time (ms) by number of function blocks (20 variables each)"        "$POUS_LIST"     SIZE 20;;
+    vars) series vars "wall time (ms) by number of variables per function block (100 blocks)"  "$VARS_LIST"     100 SIZE;;
+    sfc)  series sfc  "wall time (ms) by number of SFC steps"                                   "$STEPS_LIST"    10 5 4 SIZE;;
+    case) series case "wall time (ms) by number of CASE branches (10 blocks)"                   "$BRANCHES_LIST" 10 5 4 100 SIZE;;
+    *)    echo "unknown series: $s (pous, vars, sfc or case)"; exit 1;;
+  esac
+done
+
+rm -rf $OUTDIR/c $OUTDIR/input.st
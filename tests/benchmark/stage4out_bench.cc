@@ -0,0 +1,240 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * Benchmark of the output writer of stage 4 (stage4out_c).
+ *
+ * Times the writing of a large generated POUS.c, i.e. stage 4 alone, without the
+ * (much slower) parsing and semantic analysis of a large program.
+ * The sequence of print() calls is the same sequence generate_c_c issues for
+ * the body of a function block: many short strings, identifiers printed
+ * in upper case, integer and real literals, and indentation.
+ *
+ * The stage4out_c is compared against the std::fstream based writer it
+ * previously used (old_stage4out_c, below), with both the default (buffered write())
+ * and the writev() (-O v) flush. The generated files must be identical.
+ *
+ * usage: stage4out_bench <function_block_count> [<output_directory>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <string>
+#include <iostream>
+#include <fstream>
+
+#include "../../stage4/stage4.hh"
+
+
+/* required by the ERROR macros used in stage4.cc */
+void error_exit(const char *file_name, int line_no, const char *errmsg, ...) {
+  fprintf(stderr, "error at %s:%d\n", file_name, line_no);
+  exit(EXIT_FAILURE);
+}
+
+/* required by stage4() in stage4.cc (never called) */
+visitor_c *new_code_generator(stage4out_c *s4o, const char *builddir) {return NULL;}
+void delete_code_generator(visitor_c *code_generator) {}
+
+
+/* The std::fstream based writer previously used by stage4out_c (only the functions used in the benchmark) */
+class old_stage4out_c {
+  public:
+    std::string indent_level;
+    std::string indent_spaces;
+
+    old_stage4out_c(const char *dir, const char *radix, const char *extension) {
+      std::string filepath = std::string(dir) + "/" + radix + "." + extension;
+      m_file = new std::fstream(filepath.c_str(), std::fstream::out);
+      if (m_file->fail()) {std::cerr << "Cannot open " << filepath << " for write access \n"; exit(EXIT_FAILURE);}
+      out = m_file;
+      indent_level = "  ";
+      allow_output = true;
+    }
+    ~old_stage4out_c(void) {m_file->close(); delete m_file;}
+
+    void indent_right(void) {indent_spaces += indent_level;}
+    void indent_left (void) {indent_spaces.erase(indent_spaces.length() - indent_level.length(), indent_level.length());}
+
+    void *print(std::string value) {if (!allow_output) return NULL; *out << value; return NULL;}
+    void *print(const char *value) {if (!allow_output) return NULL; *out << value; return NULL;}
+    void *print(int         value) {if (!allow_output) return NULL; *out << value; return NULL;}
+    void *print(real64_t    value) {if (!allow_output) return NULL; *out << value; return NULL;}
+    void *print_long_long_integer(unsigned long long ll_integer, bool suffix=true) {
+      if (!allow_output) return NULL;
+      *out << ll_integer;
+      if (suffix) *out << "ULL";
+      return NULL;
+    }
+    void *printupper(const char *str) {
+      if (!allow_output) return NULL;
+      for (int i = 0; str[i] != '\0'; i++)
+        *out << (unsigned char)toupper(str[i]);
+      return NULL;
+    }
+    void *printlocation(const char *str) {
+      if (!allow_output) return NULL;
+      *out << "__";
+      for (int i = 0; str[i] != '\0'; i++)
+        if(str[i] == '.')
+          *out << '_';
+        else
+          *out << (unsigned char)toupper(str[i]);
+      return NULL;
+    }
+
+  protected:
+    std::ostream *out;
+    std::fstream *m_file;
+    bool allow_output;
+};
+
+
+
+/* A writer that discards its output, to measure the cost of issuing the print() calls (and formatting the reals) */
+class null_stage4out_c {
+  public:
+    std::string indent_level;
+    std::string indent_spaces;
+    unsigned long count;
+
+    null_stage4out_c(void) {indent_level = "  "; count = 0;}
+    void indent_right(void) {indent_spaces += indent_level;}
+    void indent_left (void) {indent_spaces.erase(indent_spaces.length() - indent_level.length(), indent_level.length());}
+
+    void *print(std::string value) {count += value.size(); return NULL;}
+    void *print(const char *value) {count += strlen(value); return NULL;}
+    void *print(int         value) {count += value;         return NULL;}
+    void *print(real64_t    value) {char str[64]; count += snprintf(str, sizeof(str), "%g", (double)value); return NULL;}
+    void *print_long_long_integer(unsigned long long ll_integer, bool suffix=true) {count += ll_integer; return NULL;}
+    void *printupper   (const char *str) {count += strlen(str); return NULL;}
+    void *printlocation(const char *str) {count += strlen(str); return NULL;}
+};
+
+
+
+/* The print() calls issued by generate_c for a function block with a few variables and some ST code */
+template<class out_t> static void generate_fb(out_t &s4o, int n) {
+  char name[32], var[32];
+  snprintf(name, sizeof(name), "fb_%d", n);
+
+  s4o.print("// FUNCTION_BLOCK "); s4o.printupper(name); s4o.print("\n");
+  s4o.print("// Code part\n");
+  s4o.print("void "); s4o.printupper(name); s4o.print("_body__("); s4o.printupper(name); s4o.print(" *data__) {\n");
+  s4o.indent_right();
+  for (int i = 0; i < 20; i++) {
+    snprintf(var, sizeof(var), "var_%d", i);
+    s4o.print(s4o.indent_spaces + "__SET_VAR(data__->,");
+    s4o.printupper(var);
+    s4o.print(",,(");
+    s4o.print("__GET_VAR(data__->"); s4o.printupper(var); s4o.print(",)");
+    s4o.print(" + ");
+    s4o.print("("); s4o.print("INT"); s4o.print(")"); s4o.print(i * n);
+    s4o.print(" * ");
+    s4o.print((real64_t)(n + i) / 7);
+    s4o.print("));\n");
+    if ((i % 5) == 0) {
+      s4o.print(s4o.indent_spaces + "__SET_LOCATED(data__->,");
+      s4o.printlocation("QX0.1.2");
+      s4o.print(",,__time_to_timespec(1, ");
+      s4o.print_long_long_integer(100000000ULL * i);
+      s4o.print(", 0, 0, 0, 0));\n");
+    }
+  }
+  s4o.indent_left();
+  s4o.print("\n"); s4o.print(s4o.indent_spaces); s4o.print("__end:\n");
+  s4o.print(s4o.indent_spaces + "return;\n");
+  s4o.print("} // "); s4o.printupper(name); s4o.print("_body__() \n\n\n\n\n");
+}
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static long file_size(const std::string &path) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (NULL == f) return -1;
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fclose(f);
+  return size;
+}
+
+static bool same_files(const std::string &path1, const std::string &path2) {
+  std::string cmd = "cmp -s " + path1 + " " + path2;
+  return system(cmd.c_str()) == 0;
+}
+
+
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <function_block_count> [<output_directory>]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  int fbs = atoi(argv[1]);
+  const char *dir = (argc > 2)? argv[2] : ".";
+
+  double tn = now();
+  { null_stage4out_c s4o;
+    for (int i = 0; i < fbs; i++) generate_fb(s4o, i);
+  }
+  double t0 = now();
+  double calls = t0 - tn;
+  { old_stage4out_c s4o(dir, "POUS_old", "c");
+    for (int i = 0; i < fbs; i++) generate_fb(s4o, i);
+  }
+  double t1 = now();
+  { stage4out_c s4o(dir, "POUS_new", "c");
+    for (int i = 0; i < fbs; i++) generate_fb(s4o, i);
+  }
+  double t2 = now();
+  stage4out_c::use_writev(true);
+  { stage4out_c s4o(dir, "POUS_writev", "c");
+    for (int i = 0; i < fbs; i++) generate_fb(s4o, i);
+  }
+  double t3 = now();
+
+  std::string old_path = std::string(dir) + "/POUS_old.c";
+  if (   !same_files(old_path, std::string(dir) + "/POUS_new.c")
+      || !same_files(old_path, std::string(dir) + "/POUS_writev.c")) {
+    fprintf(stderr, "ERROR: the generated files are different!\n");
+    return EXIT_FAILURE;
+  }
+
+  double mb = file_size(old_path) / (1024.0 * 1024.0);
+  printf("%d function blocks, %.1f MB generated\n", fbs, mb);
+  printf("(time spent in the writer, i.e. excluding the %.3f s spent issuing the print() calls)\n", calls);
+  printf("                          time      throughput   speedup\n");
+  printf("  std::fstream        : %7.3f s  %7.1f MB/s\n",            t1 - t0 - calls, mb / (t1 - t0 - calls));
+  printf("  stage4out_c         : %7.3f s  %7.1f MB/s    %5.2fx\n", t2 - t1 - calls, mb / (t2 - t1 - calls), (t1 - t0 - calls) / (t2 - t1 - calls));
+  printf("  stage4out_c (writev): %7.3f s  %7.1f MB/s    %5.2fx\n", t3 - t2 - calls, mb / (t3 - t2 - calls), (t1 - t0 - calls) / (t3 - t2 - calls));
+  return EXIT_SUCCESS;
+}
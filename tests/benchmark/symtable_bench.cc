@@ -0,0 +1,184 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * Micro-benchmark of the symbol tables.
+ *
+ * Compares the symtable_c and dsymtable_c (based on nocase_hashtable_c) against
+ * the std::map/std::multimap with a case insensitive compare that they
+ * were previously based on.
+ *
+ * The keys are the names of all the functions and function blocks declared in
+ * the standard library files given on the command line. Each name is looked up
+ * in upper, lower, and the original case, the same way that
+ * fill_candidate_datatypes_c looks up the (overloaded) functions:
+ * count(), followed by an iteration over [lower_bound(), upper_bound()[
+ *
+ * usage: symtable_bench <rounds> <library_file> [<library_file> ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../../util/symtable.hh"
+#include "../../util/dsymtable.hh"
+
+
+/* required by the ERROR macros used in the symbol tables */
+void error_exit(const char *file_name, int line_no, const char *errmsg, ...) {
+  fprintf(stderr, "error at %s:%d\n", file_name, line_no);
+  exit(EXIT_FAILURE);
+}
+
+
+/* The case insensitive compare previously used by symtable_c and dsymtable_c */
+class nocase_c {
+  public:
+    bool operator() (const std::string& x, const std::string& y) const {
+      std::string::const_iterator ix = x.begin();
+      std::string::const_iterator iy = y.begin();
+
+      for(; (ix != x.end()) && (iy != y.end()) && (toupper(*ix) == toupper(*iy)); ++ix, ++iy);
+      if (ix == x.end()) return (iy != y.end());
+      if (iy == y.end()) return false;
+      return (toupper(*ix) < toupper(*iy));
+    };
+};
+
+typedef std::multimap<std::string, int, nocase_c> old_dsymtable_t;
+typedef std::map     <std::string, int, nocase_c> old_symtable_t;
+
+
+
+/* Get the names of all the FUNCTIONs and FUNCTION_BLOCKs declared in a file */
+static void read_names(const char *filename, std::vector<std::string> &names) {
+  FILE *f = fopen(filename, "r");
+  if (f == NULL) {perror(filename); exit(EXIT_FAILURE);}
+
+  char word[256];
+  bool next_is_name = false;
+  while (fscanf(f, "%255s", word) == 1) {
+    if (next_is_name)
+      names.push_back(word);
+    next_is_name = ((strcmp(word, "FUNCTION") == 0) || (strcmp(word, "FUNCTION_BLOCK") == 0));
+  }
+  fclose(f);
+}
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static std::string change_case(const std::string &s, int (*f)(int)) {
+  std::string res = s;
+  for (size_t i = 0; i < res.size(); i++) res[i] = f((unsigned char)res[i]);
+  return res;
+}
+
+
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s <rounds> <library_file> [<library_file> ...]\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  int rounds = atoi(argv[1]);
+
+  std::vector<std::string> names;
+  for (int i = 2; i < argc; i++)
+    read_names(argv[i], names);
+
+  /* the names being looked up, in several cases */
+  std::vector<std::string> lookups;
+  for (size_t i = 0; i < names.size(); i++) {
+    lookups.push_back(names[i]);
+    lookups.push_back(change_case(names[i], tolower));
+    lookups.push_back(change_case(names[i], toupper));
+  }
+
+  old_dsymtable_t       old_dsymtable;
+  old_symtable_t        old_symtable;
+  dsymtable_c<int>      new_dsymtable;
+  symtable_c<int>       new_symtable;
+  for (size_t i = 0; i < names.size(); i++) {
+    old_dsymtable.insert(std::pair<std::string, int>(names[i], i));
+    new_dsymtable.insert(names[i].c_str(), i);
+    old_symtable[names[i]] = i;
+    new_symtable[names[i].c_str()] = i;
+  }
+
+  long old_dsum = 0, new_dsum = 0, old_sum = 0, new_sum = 0;
+  double t0 = now();
+  for (int r = 0; r < rounds; r++)
+    for (size_t i = 0; i < lookups.size(); i++) {
+      if (old_dsymtable.count(lookups[i]) == 0) continue;
+      old_dsymtable_t::iterator lower = old_dsymtable.lower_bound(lookups[i]);
+      old_dsymtable_t::iterator upper = old_dsymtable.upper_bound(lookups[i]);
+      for (; lower != upper; lower++) old_dsum += lower->second;
+    }
+  double t1 = now();
+  for (int r = 0; r < rounds; r++)
+    for (size_t i = 0; i < lookups.size(); i++) {
+      const char *name = lookups[i].c_str();
+      if (new_dsymtable.count(name) == 0) continue;
+      dsymtable_c<int>::iterator lower = new_dsymtable.lower_bound(name);
+      dsymtable_c<int>::iterator upper = new_dsymtable.upper_bound(name);
+      for (; lower != upper; lower++) new_dsum += new_dsymtable.get_value(lower);
+    }
+  double t2 = now();
+  for (int r = 0; r < rounds; r++)
+    for (size_t i = 0; i < lookups.size(); i++) {
+      old_symtable_t::iterator iter = old_symtable.find(lookups[i].c_str());
+      if (iter != old_symtable.end()) old_sum += iter->second;
+    }
+  double t3 = now();
+  for (int r = 0; r < rounds; r++)
+    for (size_t i = 0; i < lookups.size(); i++) {
+      symtable_c<int>::iterator iter = new_symtable.find(lookups[i].c_str());
+      if (iter != new_symtable.end()) new_sum += iter->second;
+    }
+  double t4 = now();
+
+  if ((old_dsum != new_dsum) || (old_sum != new_sum)) {
+    fprintf(stderr, "ERROR: the symbol tables returned different results!\n");
+    return EXIT_FAILURE;
+  }
+
+  double n = (double)rounds * lookups.size();
+  printf("%lu names (%lu distinct), %.0f lookups\n", (unsigned long)names.size(), (unsigned long)old_symtable.size(), n);
+  printf("                                   std::map    nocase_hashtable_c   speedup\n");
+  printf("  dsymtable_c (count+lower/upper): %7.1f ns     %7.1f ns        %5.2fx\n", (t1 - t0) * 1e9 / n, (t2 - t1) * 1e9 / n, (t1 - t0) / (t2 - t1));
+  printf("  symtable_c  (find)             : %7.1f ns     %7.1f ns        %5.2fx\n", (t3 - t2) * 1e9 / n, (t4 - t3) * 1e9 / n, (t3 - t2) / (t4 - t3));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+#!/bin/bash
+# matiec - a compiler for the programming languages defined in IEC 61131-3
+#
+# Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+# Generate a synthetic IEC 61131-3 project, to measure how the compiler scales with the size of its input.
+#
+# The project has:
+#   - <pous> function blocks, each with <vars> local variables (of INT, DINT, REAL and LREAL types), each
+#     variable updated with the overloaded functions of the standard library (ADD, MAX, LIMIT, SEL, ABS, ...),
+#     a variable of a structured type nested <depth> levels deep (each level a STRUCT with an ARRAY of
+#     the previous level), and a CASE statement with <case_branches> branches;
+#   - a program that calls all the function blocks;
+#   - a program written in SFC, with a loop of <sfc_steps> steps, each with its own action and transition;
+#   - a configuration running both programs.
+#
+# usage: ./synth_gen.sh <pous> <vars> [<depth>] [<sfc_steps>] [<case_branches>] > <output_file>
+#   (defaults to depth 4, 100 SFC steps and 50 CASE branches)
+
+POUS=$1
+VARS=$2
+DEPTH=${3:-4}
+STEPS=${4:-100}
+BRANCHES=${5:-50}
+
+if test -z "$POUS" || test -z "$VARS"; then
+  echo "usage: $0 <pous> <vars> [<depth>] [<sfc_steps>] [<case_branches>]" >&2
+  exit 1
+fi
+
+TYPES=(INT DINT REAL LREAL)
+
+# the deeply nested datatypes
+echo "TYPE"
+echo "  deep_0 : STRUCT a : INT; b : REAL; END_STRUCT;"
+for ((d = 1; d <= DEPTH; d++)); do
+  echo "  deep_$d : STRUCT a : INT; b : REAL; c : ARRAY [1..2] OF deep_$((d-1)); END_STRUCT;"
+done
+echo "END_TYPE"
+echo
+
+# a path through all the levels of deep_<DEPTH>, down to deep_0
+path=""
+for ((d = 1; d <= DEPTH; d++)); do path="${path}.c[$(( d % 2 + 1 ))]"; done
+
+for ((i = 1; i <= POUS; i++)); do
+  echo "FUNCTION_BLOCK fb_$i"
+  echo "  VAR_INPUT  in1 : INT; in2 : REAL; END_VAR"
+  echo "  VAR_OUTPUT out1 : INT; out2 : REAL; END_VAR"
+  echo "  VAR"
+  echo "    d : deep_$DEPTH;"
+  for ((j = 1; j <= VARS; j++)); do echo "    v_$j : ${TYPES[$(( j % 4 ))]};"; done
+  echo "  END_VAR"
+  for ((j = 1; j <= VARS; j++)); do
+    case ${TYPES[$(( j % 4 ))]} in
+      INT)   echo "  v_$j := MAX(v_$j, in1) + ADD(in1, $j, out1);";;
+      DINT)  echo "  v_$j := LIMIT(-1000, v_$j + INT_TO_DINT(in1), 1000) * $j;";;
+      REAL)  echo "  v_$j := SEL(in1 > $j, ABS(v_$j - in2), v_$j * 0.5 + INT_TO_REAL(in1));";;
+      LREAL) echo "  v_$j := MIN(REAL_TO_LREAL(in2), v_$j) / 2.0 + SQRT(ABS(v_$j));";;
+    esac
+  done
+  echo "  d$path.a := in1 + $i;"
+  echo "  d$path.b := d$path.b + in2;"
+  echo "  d.a := d$path.a;"
+  echo "  CASE in1 OF"
+  for ((k = 1; k <= BRANCHES; k++)); do
+    echo "    $(( 4*k )), $(( 4*k+1 ))..$(( 4*k+2 )): out1 := MUX($(( k % 3 )), in1, $k, out1);"
+  done
+  echo "  ELSE"
+  echo "    out1 := d.a;"
+  echo "  END_CASE;"
+  echo "  out2 := d$path.b + INT_TO_REAL(out1);"
+  echo "END_FUNCTION_BLOCK"
+  echo
+done
+
+echo "PROGRAM main_prg"
+echo "  VAR x : INT; y : REAL; END_VAR"
+echo "  VAR"
+for ((i = 1; i <= POUS; i++)); do echo "    i_$i : fb_$i;"; done
+echo "  END_VAR"
+for ((i = 1; i <= POUS; i++)); do echo "  i_$i(in1 := x, in2 := y, out1 => x, out2 => y);"; done
+echo "END_PROGRAM"
+echo
+
+echo "PROGRAM sfc_prg"
+echo "  VAR n : INT; total : DINT; END_VAR"
+echo "  INITIAL_STEP s_0:"
+echo "  END_STEP"
+echo "  TRANSITION FROM s_0 TO s_1"
+echo "    := n >= 0;"
+echo "  END_TRANSITION"
+for ((s = 1; s <= STEPS; s++)); do
+  next=$(( s % STEPS + 1 ))
+  echo "  STEP s_$s:"
+  echo "    a_$s(N);"
+  echo "  END_STEP"
+  echo "  ACTION a_$s:"
+  echo "    n := n + 1; total := total + INT_TO_DINT(n) * $s;"
+  echo "  END_ACTION"
+  echo "  TRANSITION FROM s_$s TO s_$next"
+  echo "    := n > $(( s % 10 ));"
+  echo "  END_TRANSITION"
+done
+echo "END_PROGRAM"
+echo
+
+echo "CONFIGURATION main_cfg"
+echo "  RESOURCE main_res ON PLC"
+echo "    TASK main_task(INTERVAL := T#10ms, PRIORITY := 0);"
+echo "    PROGRAM main_inst WITH main_task : main_prg;"
+echo "    PROGRAM sfc_inst WITH main_task : sfc_prg;"
+echo "  END_RESOURCE"
+echo "END_CONFIGURATION"
@@ -0,0 +1,108 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * Benchmark of the cycle cost of the TON, TOF and TP standard function blocks.
+ *
+ * Each timer is run for a number of (simulated) PLC cycles of 1 ms, with its IN toggled
+ * every 100 cycles and a PT of 50 ms, so all the states of the timers are exercised.
+ *
+ * The bodies of the timers compare TIME values with the extensible LE_TIME() and GE_TIME() standard
+ * functions. Build with -DDISABLE_FIXED_ARITY_FUNCTIONS to have these calls use the va_list based
+ * version of these functions (see lib/C/iec_std_functions.h), and with -DIEC_TIME_INT64 to have
+ * TIME stored as a 64 bit count of nanoseconds (see lib/C/iec_types.h).
+ *
+ * usage: timers_bench <cycles>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "iec_std_lib.h"
+
+
+/* The (simulated) current time, read by the timers */
+TIME __CURRENT_TIME;
+
+
+static double now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+
+static void tick(long cycle) {
+  __CURRENT_TIME = __time_from_sec_nsec(TIME, cycle / 1000, (cycle % 1000) * 1000000);
+}
+
+
+/* Run one of the timers (FB_TYPE) for the given number of cycles, and return the time per cycle (in ns) */
+#define __timer_bench(FB_TYPE)                                       \
+static double bench_##FB_TYPE(long cycles, long *q_count) {          \
+  FB_TYPE fb;                                                        \
+  long    i;                                                         \
+  double  start;                                                     \
+  /* _init__ does not set the flags of the variables */              \
+  memset(&fb, 0, sizeof(fb));                                        \
+  FB_TYPE##_init__(&fb, __BOOL_LITERAL(FALSE));                      \
+  __SET_VAR(fb.,PT,,__time_to_timespec(1, 50, 0, 0, 0, 0));          \
+  *q_count = 0;                                                      \
+  start = now();                                                     \
+  for (i = 0; i < cycles; i++) {                                     \
+    tick(i);                                                         \
+    __SET_VAR(fb.,IN,,(i / 100) % 2);                                \
+    FB_TYPE##_body__(&fb);                                           \
+    *q_count += __GET_VAR(fb.Q);                                     \
+  }                                                                  \
+  return (now() - start) * 1e9 / cycles;                             \
+}
+
+__timer_bench(TON)
+__timer_bench(TOF)
+__timer_bench(TP)
+
+
+
+int main(int argc, char **argv) {
+  long cycles, q_ton, q_tof, q_tp;
+  double ton, tof, tp;
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <cycles>\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  cycles = atol(argv[1]);
+
+  ton = bench_TON(cycles, &q_ton);
+  tof = bench_TOF(cycles, &q_tof);
+  tp  = bench_TP (cycles, &q_tp);
+
+  /* The number of cycles with Q set, so the results may be checked (and are not optimized away) */
+  printf("  TON: %6.2f ns/cycle  (Q set in %ld cycles)\n", ton, q_ton);
+  printf("  TOF: %6.2f ns/cycle  (Q set in %ld cycles)\n", tof, q_tof);
+  printf("  TP : %6.2f ns/cycle  (Q set in %ld cycles)\n", tp,  q_tp);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * Minimal runtime for the tests of runtests: runs the configuration generated by iec2c, and prints
+ * the values of its located variables (which must all be of an integer or bit string type).
+ *
+ * By default the configuration is run by calling config_run__() <cycles> times, on a simulated
+ * clock (each cycle advances __CURRENT_TIME by common_ticktime__), and the located variables
+ * are printed after each cycle. With -d, __DEBUG is set.
+ *
+ * Built with -DRUN_CONFIG_RESTART (for code generated with -O k), the configuration is restarted
+ * after half the cycles: config_init__() is called again, and the retain segments are then
+ * restored to the contents they had before the restart.
+ *
+ * Built with -DIEC_RESOURCE_THREADS (for code generated with -O r), the configuration is instead
+ * run by the threads of iec_threads.h (one for each resource, or with -u for each execution unit),
+ * for <cycles> times common_ticktime__ of real time, and the located variables are only printed
+ * once the threads are stopped (and before the restart).
+ *
+ * usage: run_config [-d] [-u] <cycles>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* The generated POUS.h defines the variant of the standard library the code was generated for */
+#include "POUS.h"
+#ifdef IEC_RESOURCE_THREADS
+#include "iec_threads.h"  /* also defines __CURRENT_TIME */
+#endif
+
+
+/* Functions and variables provided by the generated code */
+void config_run__(unsigned long tick);
+void config_init__(void);
+extern unsigned long long common_ticktime__;
+#ifdef RUN_CONFIG_RESTART
+extern const __IEC_RETAIN_SEGMENT_t *__iec_retain_segments[];
+#endif
+
+/* Variables used by the generated code */
+#ifndef IEC_RESOURCE_THREADS
+TIME __CURRENT_TIME;
+#endif
+BOOL __DEBUG;
+
+#define __LOCATED_VAR(type, name, ...) type __##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+#define __LOCATED_VAR(type, name, ...) type* name = &__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+
+
+static void print_located_variables(unsigned long tick) {
+  printf("%lu:", tick);
+#define __LOCATED_VAR(type, name, ...) printf(" %s=%lld", #name + 2, (long long)__##name);
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+  printf("\n");
+}
+
+
+#ifdef RUN_CONFIG_RESTART
+/* config_init__() sets all the variables to their initial values, so keep a copy of the retain segments */
+static void restart(void) {
+  const __IEC_RETAIN_SEGMENT_t *const *segment;
+  void *saved[64];
+  int   i;
+
+  for (segment = __iec_retain_segments, i = 0; NULL != *segment; segment++, i++) {
+    saved[i] = malloc((*segment)->size);
+    memcpy(saved[i], (*segment)->data, (*segment)->size);
+    printf("saved retain segment %s (%u bytes)\n", (*segment)->name, (*segment)->size);
+  }
+  config_init__();
+  for (segment = __iec_retain_segments, i = 0; NULL != *segment; segment++, i++) {
+    memcpy((*segment)->data, saved[i], (*segment)->size);
+    free(saved[i]);
+  }
+}
+#endif
+
+
+#ifdef IEC_RESOURCE_THREADS
+static void run_threads(int per_unit, long cycles) {
+  unsigned long long ns = cycles * common_ticktime__;
+  struct timespec duration = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+  if (__iec_start_threads(per_unit, NULL, 0) != 0) {fprintf(stderr, "could not start the threads\n"); exit(1);}
+  nanosleep(&duration, NULL);
+  __iec_stop_threads();
+}
+#endif
+
+
+int main(int argc, char **argv) {
+  int per_unit = 0;
+  long cycles;
+  unsigned long tick;
+
+  for (argv++, argc--; (argc > 0) && ('-' == (*argv)[0]); argv++, argc--) {
+    if      (strcmp(*argv, "-d") == 0) __DEBUG = 1;
+    else if (strcmp(*argv, "-u") == 0) per_unit = 1;
+    else argc = 0;
+  }
+  if ((argc != 1) || ((cycles = atol(*argv)) <= 0)) {
+    fprintf(stderr, "usage: run_config [-d] [-u] <cycles>\n");
+    return 1;
+  }
+
+  config_init__();
+
+#ifdef IEC_RESOURCE_THREADS
+  tick = 0;
+#ifdef RUN_CONFIG_RESTART
+  tick = cycles / 2;
+  run_threads(per_unit, tick);
+  print_located_variables(tick);
+  restart();
+#endif
+  run_threads(per_unit, cycles - tick);
+  print_located_variables(cycles);
+#else
+  (void)per_unit;
+  for (tick = 0; tick < (unsigned long)cycles; tick++) {
+    unsigned long long ns = tick * common_ticktime__;
+#ifdef RUN_CONFIG_RESTART
+    if (tick == (unsigned long)cycles / 2) restart();
+#endif
+    __CURRENT_TIME = __time_from_sec_nsec(TIME, ns / 1000000000ULL, ns % 1000000000ULL);
+    config_run__(tick);
+    print_located_variables(tick);
+  }
+#endif
+  return 0;
+}
@@ -38,43 +38,25 @@
 
 #include "../absyntax/absyntax.hh"
 
-#include <map>
-#include <string>
+#include "nocase_hashtable.hh"
 
 
 
 
 template<typename value_type> class dsymtable_c {
-  /* Case insensitive string compare copied from
-   * "The C++ Programming Language" - 3rd Edition
-   * by Bjarne Stroustrup, ISBN 0201889544.
-   */
-  class nocase_c {
-    public:
-      bool operator() (const std::string& x, const std::string& y) const {
-        std::string::const_iterator ix = x.begin();
-        std::string::const_iterator iy = y.begin();
-
-        for(; (ix != x.end()) && (iy != y.end()) && (toupper(*ix) == toupper(*iy)); ++ix, ++iy);
-        if (ix == x.end()) return (iy != y.end());
-        if (iy == y.end()) return false;
-        return (toupper(*ix) < toupper(*iy));
-      };
-  };
-
   public:
     typedef value_type value_t;
 
   private:
-    /* Comparison between identifiers must ignore case, therefore the use of nocase_c */
-    typedef std::multimap<std::string, value_t, nocase_c> base_t;
+    /* Comparison between identifiers must ignore case, which is handled by nocase_hashtable_c.
+     * nocase_hashtable_c also allows duplicate keys, as a std::multimap does.
+     */
+    typedef nocase_hashtable_c<value_t> base_t;
     base_t _base;
 
   public:
   typedef typename base_t::iterator iterator;
   typedef typename base_t::const_iterator const_iterator;
-  typedef typename base_t::reverse_iterator reverse_iterator;
-  typedef typename base_t::const_reverse_iterator const_reverse_iterator;
 
   private:
     const char *symbol_to_string(const symbol_c *symbol);
@@ -83,6 +65,10 @@ template<typename value_type> class dsymtable_c {
     dsymtable_c(void) {};
 
     void reset(void); /* clear all entries... */
+
+    /* Only lookups are allowed on a frozen symbol table, which makes it safe to share among threads */
+    void freeze  (void) {_base.freeze();  }
+    void unfreeze(void) {_base.unfreeze();}
     
     void insert(const char *identifier_str, value_t value);
     void insert(const symbol_c *symbol, value_t value);
@@ -97,11 +83,11 @@ template<typename value_type> class dsymtable_c {
     iterator find(const symbol_c *symbol)            {return find(symbol_to_string(symbol));}
     
     /* Search for the first entry associated with (i.e. with key ==) identifier_str. Will return end() if not found (NOTE: end() != end_value()) */
-    iterator lower_bound(const char *identifier_str) {return ((count(identifier_str) == 0)? _base.end() : _base.lower_bound(identifier_str));}
+    iterator lower_bound(const char *identifier_str) {return _base.lower_bound(identifier_str);}
     iterator lower_bound(const symbol_c *symbol)     {return lower_bound(symbol_to_string(symbol));}
     
-    /* Search for the first entry with key greater than identifier_str. Will return end() if not found */
-    iterator upper_bound(const char *identifier_str) {return ((count(identifier_str) == 0)? _base.end() : _base.upper_bound(identifier_str));}
+    /* Search for the entry following the last entry associated with identifier_str. Will return end() if not found */
+    iterator upper_bound(const char *identifier_str) {return _base.upper_bound(identifier_str);}
     iterator upper_bound(const symbol_c *symbol)     {return upper_bound(symbol_to_string(symbol));}
 
     /* get the value to which an iterator is pointing to... */
@@ -112,10 +98,6 @@ template<typename value_type> class dsymtable_c {
     const_iterator begin() const	{return _base.begin();}
     iterator end()			{return _base.end();}
     const_iterator end() const 		{return _base.end();}
-    reverse_iterator rbegin()		{return _base.rbegin();}
-    const_reverse_iterator rbegin() const {return _base.rbegin();}
-    reverse_iterator rend() 		{return _base.rend();}
-    const_reverse_iterator rend() const	{return _base.rend();}
 
     /* debuging function... */
     void print(void);
@@ -0,0 +1,231 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * A hash table indexed by identifiers.
+ *
+ * See nocase_hashtable.hh for details.
+ */
+
+
+#include <ctype.h>    /* required for toupper() */
+#include "nocase_hashtable.hh"
+#include "../absyntax/string_pool.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+
+
+/* initial number of slots. Must be a power of 2 */
+#define NOCASE_HASHTABLE_INITIAL_SIZE 16
+
+
+
+
+/**********************/
+/* nocase_keypool_c   */
+/**********************/
+
+/* NOTE: This file is included in several translation units (by nocase_hashtable.hh),
+ *       so the non template functions must be declared inline.
+ */
+
+/* FNV-1a, on the key folded to upper case */
+inline unsigned int nocase_keypool_c::hash(const char *key) {
+  unsigned int h = 2166136261u;
+  for (; *key != '\0'; key++) {
+    h ^= (unsigned char)toupper((unsigned char)*key);
+    h *= 16777619u;
+  }
+  return h;
+}
+
+
+inline bool nocase_keypool_c::equal(const char *folded_key, const char *key) {
+  for (; (*folded_key != '\0') && (*folded_key == toupper((unsigned char)*key)); folded_key++, key++);
+  return (*folded_key == '\0') && (*key == '\0');
+}
+
+
+/* The keys are stored in the string pool, which already keeps a single copy of the upper case version of each string */
+inline const char *nocase_keypool_c::intern(const char *key) {
+  return interned_upper(intern_string(key));
+}
+
+
+
+
+/************************/
+/* nocase_hashtable_c   */
+/************************/
+
+/* remove all entries... */
+template<typename value_type>
+void nocase_hashtable_c<value_type>::clear(void) {
+  if (frozen) ERROR_MSG("clearing a frozen symbol table.");
+  slots.clear();
+  entries.clear();
+  used = 0;
+}
+
+
+template<typename value_type>
+int nocase_hashtable_c<value_type>::lookup(const char *key, unsigned int hash) const {
+  unsigned int mask = slots.size() - 1;
+  unsigned int i;
+  for (i = hash & mask; slots[i].key != NULL; i = (i + 1) & mask)
+    if ((slots[i].hash == hash) && nocase_keypool_c::equal(slots[i].key, key))
+      break;
+  /* the loop always terminates, as the table is never allowed to become full */
+  return i;
+}
+
+
+template<typename value_type>
+void nocase_hashtable_c<value_type>::grow(void) {
+  std::vector<slot_t> old_slots;
+  old_slots.swap(slots);
+
+  slot_t empty = {NULL, 0, -1, -1};
+  slots.resize((old_slots.size() == 0)? NOCASE_HASHTABLE_INITIAL_SIZE : 2 * old_slots.size(), empty);
+  unsigned int mask = slots.size() - 1;
+  for (unsigned int i = 0; i < old_slots.size(); i++) {
+    if (old_slots[i].key == NULL) continue;
+    unsigned int j;
+    for (j = old_slots[i].hash & mask; slots[j].key != NULL; j = (j + 1) & mask);
+    slots[j] = old_slots[i];
+  }
+}
+
+
+template<typename value_type>
+typename nocase_hashtable_c<value_type>::iterator nocase_hashtable_c<value_type>::insert(const char *key, value_t value) {
+  if (frozen) ERROR_MSG("adding '%s' to a frozen symbol table.", key);
+
+  /* keep the load factor below 3/4 */
+  if (4 * (used + 1) > 3 * slots.size())
+    grow();
+
+  unsigned int h = nocase_keypool_c::hash(key);
+  int s = lookup(key, h);
+  entry_t entry;
+  entry.second = value;
+  entry.next   = -1;
+  int e = entries.size();
+
+  if (slots[s].key == NULL) {
+    /* new key */
+    slots[s].key  = nocase_keypool_c::intern(key);
+    slots[s].hash = h;
+    slots[s].head = e;
+    used++;
+  } else {
+    /* key already in table. Append to the list of values of this key */
+    entries[slots[s].tail].next = e;
+  }
+  slots[s].tail = e;
+  entry.first = slots[s].key;
+  entries.push_back(entry);
+  return iterator(this, s, e);
+}
+
+
+template<typename value_type>
+typename nocase_hashtable_c<value_type>::value_t &nocase_hashtable_c<value_type>::operator[](const char *key) {
+  iterator i = find(key);
+  if (i == end())
+    i = insert(key, value_t());
+  return i->second;
+}
+
+
+template<typename value_type>
+int nocase_hashtable_c<value_type>::count(const char *key) const {
+  const_iterator i = find(key);
+  if (i == end()) return 0;
+  int res = 1;
+  for (int e = i->next; e >= 0; e = entries[e].next)
+    res++;
+  return res;
+}
+
+
+template<typename value_type>
+typename nocase_hashtable_c<value_type>::iterator nocase_hashtable_c<value_type>::find(const char *key) {
+  if (used == 0) return end();
+  int s = lookup(key, nocase_keypool_c::hash(key));
+  if (slots[s].key == NULL) return end();
+  return iterator(this, s, slots[s].head);
+}
+
+
+template<typename value_type>
+typename nocase_hashtable_c<value_type>::const_iterator nocase_hashtable_c<value_type>::find(const char *key) const {
+  if (used == 0) return end();
+  int s = lookup(key, nocase_keypool_c::hash(key));
+  if (slots[s].key == NULL) return end();
+  return const_iterator(this, s, slots[s].head);
+}
+
+
+template<typename value_type>
+typename nocase_hashtable_c<value_type>::iterator nocase_hashtable_c<value_type>::upper_bound(const char *key) {
+  iterator i = find(key);
+  if (i == end()) return end();
+  int s = first_used(i.slot + 1);
+  return iterator(this, s, (s < (int)slots.size())? slots[s].head : -1);
+}
+
+
+template<typename value_type>
+int nocase_hashtable_c<value_type>::first_used(unsigned int slot) const {
+  for (; (slot < slots.size()) && (slots[slot].key == NULL); slot++);
+  return slot;
+}
+
+
+template<typename value_type>
+void nocase_hashtable_c<value_type>::next(int &slot, int &entry) const {
+  if (entries[entry].next >= 0) {
+    entry = entries[entry].next;
+    return;
+  }
+  slot  = first_used(slot + 1);
+  entry = (slot < (int)slots.size())? slots[slot].head : -1;
+}
+
+
+template<typename value_type>
+typename nocase_hashtable_c<value_type>::iterator nocase_hashtable_c<value_type>::begin(void) {
+  int s = first_used(0);
+  return iterator(this, s, (s < (int)slots.size())? slots[s].head : -1);
+}
+
+
+template<typename value_type>
+typename nocase_hashtable_c<value_type>::const_iterator nocase_hashtable_c<value_type>::begin(void) const {
+  int s = first_used(0);
+  return const_iterator(this, s, (s < (int)slots.size())? slots[s].head : -1);
+}
+
+
+#undef NOCASE_HASHTABLE_INITIAL_SIZE
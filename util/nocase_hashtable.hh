@@ -0,0 +1,169 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * A hash table indexed by identifiers.
+ *
+ * Identifiers in IEC 61131-3 are case insensitive, so the keys are
+ * folded to upper case before being hashed and stored. Each distinct
+ * key is stored only once (in the string pool), and shared by
+ * all the tables in which it is used.
+ *
+ * Collisions are handled by open addressing (linear probing), so each
+ * lookup costs a single hash computation and (usually) a single string
+ * compare.
+ *
+ * The same key may be associated to several values (as in a std::multimap).
+ * All the values associated to the same key are iterated over consecutively,
+ * in the order in which they were inserted, so the range
+ * [lower_bound(key), upper_bound(key)[ contains all the values of key.
+ * The order in which the distinct keys are iterated over is unspecified.
+ *
+ * Entries may be added, but never removed (other than by clearing
+ * the whole table).
+ * A table may be frozen (e.g. before being shared by several threads), after which
+ * adding an entry is an (internal compiler) error.
+ * NOTE: Inserting a new entry invalidates all iterators and references
+ *       to values currently in the table.
+ */
+
+
+
+#ifndef _NOCASE_HASHTABLE_HH
+#define _NOCASE_HASHTABLE_HH
+
+#include <stddef.h>   /* required for NULL */
+#include <vector>
+
+
+
+/* The pool of interned keys, already folded to upper case (stored in the string pool, see absyntax/string_pool.hh) */
+class nocase_keypool_c {
+  public:
+    /* the (case insensitive) hash function */
+    static unsigned int hash(const char *key);
+    /* compare a key already folded to upper case with any other key, ignoring case */
+    static bool equal(const char *folded_key, const char *key);
+    /* Returns the single copy of key (folded to upper case) stored in the pool. */
+    static const char *intern(const char *key);
+};
+
+
+
+template<typename value_type> class nocase_hashtable_c {
+  public:
+    typedef value_type value_t;
+
+    typedef struct {
+      const char *first;   /* the key, interned and folded to upper case */
+      value_t     second;
+      int         next;    /* next entry with the same key, or -1 */
+    } entry_t;
+
+  private:
+    typedef struct {
+      const char   *key;   /* the key, interned and folded to upper case. NULL if the slot is empty */
+      unsigned int  hash;
+      int           head;  /* first and last entries associated to this key */
+      int           tail;
+    } slot_t;
+
+    std::vector<slot_t>  slots;     /* size is always 0 or a power of 2 */
+    std::vector<entry_t> entries;
+    unsigned int         used;      /* number of slots in use */
+    bool                 frozen;    /* no more entries may be added */
+
+  public:
+    template<typename table_t, typename ref_t> class iterator_base_c {
+      friend class nocase_hashtable_c;
+      private:
+        table_t *table;
+        int      slot;
+        int      entry;
+        iterator_base_c(table_t *table_, int slot_, int entry_) {table = table_; slot = slot_; entry = entry_;}
+      public:
+        iterator_base_c(void) {table = NULL; slot = -1; entry = -1;}
+        /* allow converting an iterator to a const_iterator */
+        template<typename t2, typename r2> iterator_base_c(const iterator_base_c<t2, r2> &i) {table = i.table; slot = i.slot; entry = i.entry;}
+        ref_t &operator* (void) const {return  table->entries[entry];}
+        ref_t *operator->(void) const {return &table->entries[entry];}
+        iterator_base_c &operator++(void)    {table->next(slot, entry); return *this;}
+        iterator_base_c  operator++(int)     {iterator_base_c tmp = *this; table->next(slot, entry); return tmp;}
+        template<typename t2, typename r2> bool operator==(const iterator_base_c<t2, r2> &i) const {return (table == i.table) && (slot == i.slot) && (entry == i.entry);}
+        template<typename t2, typename r2> bool operator!=(const iterator_base_c<t2, r2> &i) const {return !(*this == i);}
+        template<typename t2, typename r2> friend class iterator_base_c;
+    };
+
+    typedef iterator_base_c<      nocase_hashtable_c,       entry_t> iterator;
+    typedef iterator_base_c<const nocase_hashtable_c, const entry_t> const_iterator;
+
+  public:
+    nocase_hashtable_c(void) {used = 0; frozen = false;}
+
+    /* Only lookups are allowed on a frozen table, which makes it safe to share among threads */
+    void freeze  (void) {frozen = true; }
+    void unfreeze(void) {frozen = false;}
+    bool is_frozen(void) const {return frozen;}
+
+    void clear(void); /* remove all entries... */
+
+    /* Add a new (key,value) pair, after all other values already associated to the same key */
+    iterator insert(const char *key, value_t value);
+
+    /* The value associated to key. If key is not in the table, a new entry with a default value is inserted */
+    value_t &operator[](const char *key);
+
+    /* number of values associated to key */
+    int count(const char *key) const;
+
+    /* Search for the first value associated to key. Return end() if not found */
+    iterator       find(const char *key);
+    const_iterator find(const char *key) const;
+    /* Iterator to the first value associated to key, or end() if not found */
+    iterator lower_bound(const char *key) {return find(key);}
+    /* Iterator following the last value associated to key, or end() if not found */
+    iterator upper_bound(const char *key);
+
+    iterator       begin(void);
+    const_iterator begin(void) const;
+    iterator       end  (void)       {return       iterator(this, slots.size(), -1);}
+    const_iterator end  (void) const {return const_iterator(this, slots.size(), -1);}
+
+    unsigned int size(void) const {return entries.size();}
+
+  private:
+    /* the slot containing key, or the empty slot where it should be inserted. Table must not be empty. */
+    int lookup(const char *key, unsigned int hash) const;
+    void grow(void);
+    /* advance (slot, entry) to the following entry */
+    void next(int &slot, int &entry) const;
+    /* first used slot, starting at slot (inclusive) */
+    int  first_used(unsigned int slot) const;
+};
+
+
+
+/* Templates must include the source into the code! */
+#include "nocase_hashtable.cc"
+
+#endif /*  _NOCASE_HASHTABLE_HH */
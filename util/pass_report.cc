@@ -0,0 +1,218 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ * Timing and memory report of the compiler passes (-t <file>).
+ *
+ * See pass_report.hh for details.
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "pass_report.hh"
+#include "../absyntax/visitor.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+
+/* NOTE: This file is included in several translation units (by pass_report.hh),
+ *       so the functions must be declared inline.
+ */
+
+inline pass_report_c *pass_report_c::report(void) {
+  static pass_report_c the_report;
+  return &the_report;
+}
+
+
+inline pass_report_c::sample_t pass_report_c::sample(void) {
+  sample_t       s;
+  struct timespec ts;
+  struct rusage   ru;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  getrusage(RUSAGE_SELF, &ru);
+  s.wall = ts.tv_sec + ts.tv_nsec / 1e9;
+  s.cpu  = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6
+         + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+  s.rss  = ru.ru_maxrss;  /* in kB (on Linux) */
+  return s;
+}
+
+
+inline void pass_report_c::enable(const char *filename) {
+  if (NULL == report()->filename)
+    atexit(print_at_exit);
+  report()->filename = filename;
+  report()->start    = sample();
+}
+
+
+inline void pass_report_c::begin(const char *name) {
+  pass_report_c *r = report();
+  if (NULL == r->filename) return;
+  pass_t pass;
+  pass.name  = r->running.empty()? name : r->passes[r->running.back()].name + "/" + name;
+  pass.depth = r->running.size();
+  r->running.push_back(r->passes.size());
+  r->passes.push_back(pass);
+  /* take the sample last, so the time above is not included in the pass */
+  r->passes.back().beg = sample();
+}
+
+
+inline void pass_report_c::end(void) {
+  pass_report_c *r = report();
+  if (NULL == r->filename) return;
+  if (r->running.empty()) ERROR;  /* end() without begin() */
+  r->passes[r->running.back()].end = sample();
+  r->running.pop_back();
+}
+
+
+
+/* Count the nodes of the abstract syntax tree, by class */
+class pass_report_count_nodes_c: public iterator_visitor_c {
+  public:
+    std::map<std::string, long> &nodes;
+    pass_report_count_nodes_c(std::map<std::string, long> &nodes_): nodes(nodes_) {}
+
+#define SYM_LIST(class_name_c, ...)                                             \
+    void *visit(class_name_c *symbol) {nodes[#class_name_c]++; return iterator_visitor_c::visit(symbol);}
+#define SYM_TOKEN(class_name_c, ...)                                            \
+    void *visit(class_name_c *symbol) {nodes[#class_name_c]++; return NULL;}
+#define SYM_REF_(class_name_c)                                                  \
+    void *visit(class_name_c *symbol) {nodes[#class_name_c]++; return iterator_visitor_c::visit(symbol);}
+#define SYM_REF0(class_name_c, ...)                                             SYM_REF_(class_name_c)
+#define SYM_REF1(class_name_c, ref1, ...)                                       SYM_REF_(class_name_c)
+#define SYM_REF2(class_name_c, ref1, ref2, ...)                                 SYM_REF_(class_name_c)
+#define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                           SYM_REF_(class_name_c)
+#define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)                     SYM_REF_(class_name_c)
+#define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)               SYM_REF_(class_name_c)
+#define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)         SYM_REF_(class_name_c)
+
+#include "../absyntax/absyntax.def"
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF_
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+};
+
+
+inline void pass_report_c::count_nodes(symbol_c *tree_root) {
+  pass_report_c *r = report();
+  if ((NULL == r->filename) || (NULL == tree_root)) return;
+  r->nodes.clear();
+  pass_report_count_nodes_c count_nodes(r->nodes);
+  tree_root->accept(count_nodes);
+}
+
+
+
+inline int pass_report_c::print(void) {
+  pass_report_c *r = report();
+  if ((NULL == r->filename) || r->printed) return 0;
+  r->printed = true;
+  /* close any pass still running (i.e. the compiler bailed out in the middle of it) */
+  while (!r->running.empty()) end();
+
+  if (strcmp(r->filename, "-") == 0) {
+    r->print_table(stderr, r->input_file);
+    return 0;
+  }
+  FILE *f = fopen(r->filename, "w");
+  if (NULL == f) {
+    fprintf(stderr, "Could not write the pass report to %s\n", r->filename);
+    return -1;
+  }
+  r->print_json(f, r->input_file);
+  return (fclose(f) == 0)? 0 : -1;
+}
+
+
+inline void pass_report_c::print_json(FILE *f, const char *input_file) {
+  sample_t now = sample();
+  std::map<std::string, long>::iterator iter;
+  long total = 0;
+
+  fprintf(f, "{\n  \"input\": \"");
+  for (const char *c = input_file; *c != '\0'; c++) {
+    if      ((*c == '"') || (*c == '\\')) fprintf(f, "\\%c", *c);
+    else if ((unsigned char)*c < 0x20)    fprintf(f, "\\u%04x", *c);
+    else                                  fputc(*c, f);
+  }
+  fprintf(f, "\",\n");
+  fprintf(f, "  \"threads\": %d,\n", runtime_options.threads);
+  fprintf(f, "  \"passes\": [");
+  for (unsigned int i = 0; i < passes.size(); i++) {
+    pass_t &p = passes[i];
+    fprintf(f, "%s\n    {\"name\": \"%s\", \"depth\": %d, \"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"peak_rss_delta_kb\": %ld}",
+            (i == 0)? "" : ",", p.name.c_str(), p.depth,
+            (p.end.wall - p.beg.wall) * 1e3, (p.end.cpu - p.beg.cpu) * 1e3, p.end.rss - p.beg.rss);
+  }
+  fprintf(f, "\n  ],\n");
+  fprintf(f, "  \"total\": {\"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"peak_rss_kb\": %ld},\n",
+          (now.wall - start.wall) * 1e3, now.cpu * 1e3, now.rss);
+  fprintf(f, "  \"ast_nodes\": {");
+  for (iter = nodes.begin(); iter != nodes.end(); iter++) {
+    fprintf(f, "%s\n    \"%s\": %ld", (iter == nodes.begin())? "" : ",", iter->first.c_str(), iter->second);
+    total += iter->second;
+  }
+  fprintf(f, "\n  },\n");
+  fprintf(f, "  \"ast_nodes_total\": %ld\n}\n", total);
+}
+
+
+inline void pass_report_c::print_table(FILE *f, const char *input_file) {
+  sample_t now = sample();
+  std::map<std::string, long>::iterator iter;
+  long total = 0;
+
+  fprintf(f, "\nPass report for %s (%d thread(s))\n", input_file, runtime_options.threads);
+  fprintf(f, "%-56s %12s %12s %14s\n", "pass", "wall (ms)", "cpu (ms)", "+peak RSS (kB)");
+  for (unsigned int i = 0; i < passes.size(); i++) {
+    pass_t &p = passes[i];
+    const char *name = strrchr(p.name.c_str(), '/');
+    name = (NULL == name)? p.name.c_str() : name + 1;
+    fprintf(f, "%*s%-*s %12.3f %12.3f %14ld\n", 2 * p.depth, "", 56 - 2 * p.depth, name,
+            (p.end.wall - p.beg.wall) * 1e3, (p.end.cpu - p.beg.cpu) * 1e3, p.end.rss - p.beg.rss);
+  }
+  fprintf(f, "%-56s %12.3f %12.3f %14ld (peak)\n", "total",
+          (now.wall - start.wall) * 1e3, now.cpu * 1e3, now.rss);
+
+  fprintf(f, "\n%-56s %12s\n", "AST node class", "count");
+  for (iter = nodes.begin(); iter != nodes.end(); iter++) {
+    fprintf(f, "%-56s %12ld\n", iter->first.c_str(), iter->second);
+    total += iter->second;
+  }
+  fprintf(f, "%-56s %12ld\n", "total", total);
+}
@@ -0,0 +1,114 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/*
+ * Timing and memory report of the compiler passes (-t <file>).
+ *
+ * Each pass (stage, or stage 3 sub-pass) is delimited by a call to pass_report_c::begin()
+ * and a call to pass_report_c::end(). Passes may be nested (e.g. the sub-passes of stage3),
+ * and are reported in the order in which they begin, named by the path of the enclosing
+ * passes (e.g. "stage3/type_safety/fill_candidate_datatypes").
+ * For each pass we record:
+ *   - the elapsed (wall) time;
+ *   - the CPU time (user + system) of the whole process, i.e. of all its threads (-j);
+ *   - the increase of the peak resident set size (RSS) of the process while the pass was running.
+ *     NOTE: this is 0 for any pass that only reuses memory that was already allocated (and
+ *           freed) by a previous pass, so it measures the new memory high water mark,
+ *           not the memory allocated by the pass.
+ *
+ * pass_report_c::count_nodes() also counts the nodes of the abstract syntax tree, by class
+ * (as returned by absyntax_cname()).
+ *
+ * pass_report_c::print() writes out the report, in JSON, to the file given to -t,
+ * or, if this is "-", as a human readable table to stderr. Since the compiler bails out
+ * on errors by simply calling exit(), the report is also written out on exit (if it
+ * was not already), with any passes still running ending at that time.
+ *
+ * All of these do nothing unless the report was enabled with pass_report_c::enable(),
+ * and must only be called from the main thread.
+ */
+
+
+
+#ifndef _PASS_REPORT_HH
+#define _PASS_REPORT_HH
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <map>
+
+class symbol_c; // forward declaration
+
+
+class pass_report_c {
+  public:
+    static void enable(const char *filename);
+    /* the file being compiled, named in the report */
+    static void set_input_file(const char *input_file) {report()->input_file = input_file;}
+    static bool enabled(void) {return NULL != report()->filename;}
+
+    static void begin(const char *name);
+    static void end(void);
+    /* count the nodes of the abstract syntax tree */
+    static void count_nodes(symbol_c *tree_root);
+    /* write out the report (only once). Returns -1 if the file could not be written */
+    static int  print(void);
+
+  private:
+    typedef struct {
+      double wall;  /* seconds */
+      double cpu;   /* seconds */
+      long   rss;   /* peak RSS, in kB */
+    } sample_t;
+
+    typedef struct {
+      std::string name;
+      int         depth;
+      sample_t    beg, end;
+    } pass_t;
+
+    const char                    *filename;  /* NULL: report not enabled */
+    const char                    *input_file;
+    bool                           printed;
+    sample_t                       start;     /* when the report was enabled */
+    std::vector<pass_t>            passes;
+    std::vector<int>               running;   /* the passes that have begun but not ended (indexes into passes) */
+    std::map<std::string, long>    nodes;     /* count of AST nodes, by class */
+
+    pass_report_c(void) {filename = NULL; input_file = ""; printed = false;}
+    /* the one and only report */
+    static pass_report_c *report(void);
+    static sample_t sample(void);
+    static void print_at_exit(void) {print();}
+    void print_json (FILE *f, const char *input_file);
+    void print_table(FILE *f, const char *input_file);
+};
+
+
+
+/* As in the other files in util, the source is included into the code (all its functions are inline) */
+#include "pass_report.cc"
+
+#endif /*  _PASS_REPORT_HH */
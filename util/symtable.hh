@@ -36,43 +36,24 @@
 
 #include "../absyntax/absyntax.hh"
 
-#include <map>
+#include "nocase_hashtable.hh"
 #include <string>
 
 
 
 
 template<typename value_type> class symtable_c {
-  /* Case insensitive string compare copied from
-   * "The C++ Programming Language" - 3rd Edition
-   * by Bjarne Stroustrup, ISBN 0201889544.
-   */
-  class nocase_c {
-    public:
-      bool operator() (const std::string& x, const std::string& y) const {
-        std::string::const_iterator ix = x.begin();
-        std::string::const_iterator iy = y.begin();
-
-        for(; (ix != x.end()) && (iy != y.end()) && (toupper(*ix) == toupper(*iy)); ++ix, ++iy);
-        if (ix == x.end()) return (iy != y.end());
-        if (iy == y.end()) return false;
-        return (toupper(*ix) < toupper(*iy));
-      };
-  };
-
   public:
     typedef value_type value_t;
 
   private:
-    /* Comparison between identifiers must ignore case, therefore the use of nocase_c */
-    typedef std::map<std::string, value_t, nocase_c> base_t;
+    /* Comparison between identifiers must ignore case, which is handled by nocase_hashtable_c */
+    typedef nocase_hashtable_c<value_t> base_t;
     base_t _base;
 
   public:
   typedef typename base_t::iterator iterator;
   typedef typename base_t::const_iterator const_iterator;
-  typedef typename base_t::reverse_iterator reverse_iterator;
-  typedef typename base_t::const_reverse_iterator const_reverse_iterator;
 
   private:
       /* pointer to symbol table of the next inner scope */
@@ -86,6 +67,10 @@ template<typename value_type> class symtable_c {
     void push(void); /* create new inner scope */
     int  pop(void);  /* clear most inner scope */
 
+    /* Only lookups are allowed on a frozen symbol table, which makes it safe to share among threads */
+    void freeze  (void) {_base.freeze();  }
+    void unfreeze(void) {_base.unfreeze();}
+
     void set(const char *identifier_str, value_t value);    // Will change value associated to string if already in map. Will create new entry if string not in map.
     void set(const symbol_c *symbol, value_t value);        // Will change value associated to string if already in map. Will create new entry if string not in map.
     void insert(const char *identifier_str, value_t value); // insert a new (string,value) pair. Give an error if string already in map associated to different value!
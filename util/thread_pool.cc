@@ -0,0 +1,65 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * A pool of threads running a list of independent work items.
+ *
+ * See thread_pool.hh for details.
+ */
+
+
+#include <pthread.h>
+#include "thread_pool.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+
+
+/* NOTE: This file is included in several translation units (by thread_pool.hh),
+ *       so the functions must be declared inline.
+ */
+
+inline void *thread_pool_c::run_items(void *pool_) {
+  thread_pool_c *pool = (thread_pool_c *)pool_;
+  int item;
+  while ((item = __sync_fetch_and_add(&pool->next_item, 1)) < (int)pool->items->size())
+    (*pool->items)[item]->run();
+  return NULL;
+}
+
+
+inline void thread_pool_c::run(std::vector<work_item_c *> &items, int thread_count) {
+  thread_pool_c pool(&items);
+
+  if (thread_count > (int)items.size()) thread_count = items.size();
+  std::vector<pthread_t> threads;
+  for (int i = 1; i < thread_count; i++) {
+    pthread_t thread;
+    /* if we cannot create more threads, simply use the ones we already have */
+    if (pthread_create(&thread, NULL, run_items, &pool) != 0) break;
+    threads.push_back(thread);
+  }
+
+  run_items(&pool); /* the calling thread also runs work items */
+
+  for (unsigned int i = 0; i < threads.size(); i++)
+    if (pthread_join(threads[i], NULL) != 0) ERROR;
+}
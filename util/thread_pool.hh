@@ -0,0 +1,69 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * A pool of threads running a list of independent work items.
+ *
+ * Each thread takes the next work item not yet started from the list, until
+ * all items have been run. The calling thread is one of the threads of the pool,
+ * so with a single thread all items are run in order by the calling thread.
+ *
+ * The work items must be independent of each other: they may run in any order,
+ * and several at the same time.
+ */
+
+
+
+#ifndef _THREAD_POOL_HH
+#define _THREAD_POOL_HH
+
+#include <vector>
+
+
+class work_item_c {
+  public:
+    virtual ~work_item_c(void) {}
+    virtual void run(void) = 0;
+};
+
+
+class thread_pool_c {
+  public:
+    /* Run all the work items, using (at most) thread_count threads. Returns when all items are done. */
+    static void run(std::vector<work_item_c *> &items, int thread_count);
+
+  private:
+    std::vector<work_item_c *> *items;
+    volatile int                next_item;  /* the next item to run */
+
+    thread_pool_c(std::vector<work_item_c *> *items_) {items = items_; next_item = 0;}
+    /* the body of each thread */
+    static void *run_items(void *pool);
+};
+
+
+
+/* As in the other files in util, the source is included into the code (all its functions are inline) */
+#include "thread_pool.cc"
+
+#endif /*  _THREAD_POOL_HH */